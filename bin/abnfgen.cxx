@@ -0,0 +1,68 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+ 
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "abnf.h"
+#include "uri.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Writes the parser of a rule of the URI or the core rule set to NAME.h and
+ * NAME.cxx, in the current directory:
+ *
+ *		abnfgen uri|core RULE NAME
+ */
+int main(int argc, char* argv[])
+{
+	if (argc not_eq 4)
+	{
+		cerr << "usage: " << argv[0] << " uri|core RULE NAME" << endl;
+		return EXIT_FAILURE;
+	}
+	
+	string rset_name = argv[1];
+	const abnf_ruleset* rset = NULL;
+	if (rset_name == "uri")
+		rset = &uri::ruleset();
+	else if (rset_name == "core")
+		rset = &abnf_ruleset::core_ruleset();
+	if (rset == NULL or not rset->defined(argv[2]))
+	{
+		cerr << argv[0] << ": unknown rule " << argv[2] << endl;
+		return EXIT_FAILURE;
+	}
+	
+	string name = argv[3];
+	ofstream hs((name + ".h").c_str());
+	ofstream cs((name + ".cxx").c_str());
+	rset->generate(rset->get(argv[2]), name.c_str(), hs, cs);
+	if (not hs or not cs)
+	{
+		cerr << argv[0] << ": cannot write " << name << endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
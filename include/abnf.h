@@ -24,7 +24,10 @@
 #include <istream>
 #include <map>
 #include <ostream>
-#include <set>
+#include <string>
+#include <vector>
+
+#include "abnfspan.h"
 
 /*!
  * \file
@@ -33,10 +36,67 @@
 
 namespace xspider {
 
+class abnf_arena;
+class abnf_program;
 class abnf_rule;
+class abnf_rule_ri;
+class abnf_segment_map;
+class abnf_span;
+class abnf_vm;
+
+/*!
+ * \brief Matching modes of repetition rules.
+ *
+ * They determine in which order the possible numbers of occurrences are
+ * tried, which is relevant when what follows a repetition can match some of
+ * its occurrences too.
+ */
+enum abnf_repet_mode
+{
+	/*!
+	 * \brief Fewest occurrences first. More occurrences are tried when
+	 * backtracking.
+	 */
+	ABNF_REPET_LAZY,
+	
+	/*!
+	 * \brief Most occurrences first. Less occurrences are tried when
+	 * backtracking.
+	 */
+	ABNF_REPET_GREEDY,
+	
+	/*!
+	 * \brief Most occurrences only. Backtracking never goes into the
+	 * repetition, so it is the cheapest mode when what follows can not match
+	 * any of its occurrences.
+	 */
+	ABNF_REPET_POSSESSIVE
+};
+
+/*!
+ * \brief Semantic action of a rule, called with each of its matching segments
+ * as it is stored to a result.
+ *
+ * \param data
+ *			Data of the result, given by the caller.
+ * \param r
+ *			The matching rule.
+ * \param s
+ *			The matching segment.
+ */
+typedef void (*abnf_action)(void* data, const abnf_rule& r,
+		const abnf_span& s);
 
 /*!
  * \brief ABFN rule set.
+ *
+ * Rules are shared by structure: creating a rule identical to an existing one,
+ * of the same kind, with the same characters and children rules sharing their
+ * structure too, gives a rule matching through the existing one, with its
+ * children and compiled code. Still, each created rule stores its own
+ * matching segments, and has its own action. Once the children it was created
+ * from are defined, captured, given actions or memoized apart from those of
+ * the existing rule, it is matched through its own children instead.
  */
 class abnf_ruleset
 {
@@ -56,8 +116,11 @@ class abnf_ruleset
 	abnf_ruleset(void);
 	
 	/*!
-	 * \brief Copies the given rule set by including its rules and definitions
-	 * to this empty rule set.
+	 * \brief Copies the given rule set by duplicating its rules and
+	 * definitions to this empty rule set.
+	 *
+	 * Rule sets included by \p rset are included by this one too, so their
+	 * rules are shared instead of duplicated.
 	 *
 	 * \param rset
 	 *			A ruleset to be copied.
@@ -73,8 +136,22 @@ class abnf_ruleset
 	 * \brief Includes to this rule set those rules and definitions of the
 	 * given rule set.
 	 *
+	 * Rules are shared instead of duplicated, so including takes constant time
+	 * and memory, whatever the size of \p rset. Rules of this rule set can be
+	 * created from them, and matching results of their read operations are
+	 * those of the same rules read through \p rset. Definitions of this rule
+	 * set hide those of included rule sets with the same name, and those of
+	 * the last included rule set hide those of the previous ones.
+	 *
+	 * Since rules are shared, \p rset must not be released before this rule
+	 * set. For the same reason, its rules cannot be defined, captured, given
+	 * actions nor memoized through this rule set.
+	 *
 	 * \param rset
 	 *			Included rule set.
+	 *
+	 * \throw std::invalid_argument
+	 *			If \p rset is this rule set or includes it.
 	 */
 	void include(const abnf_ruleset& rset);
 	
@@ -112,6 +189,9 @@ class abnf_ruleset
 	 * Rules created by a rule set are initially annonymous. This method make
 	 * them named and accessible with \link get \endlink.
 	 *
+	 * Matching segments of a defined rule are stored, as if \link capture
+	 * \endlink was called for it.
+	 *
 	 * \param r_name
 	 *			A case insentitive name for the given rule.
 	 * \param r
@@ -125,6 +205,52 @@ class abnf_ruleset
 	 */
 	abnf_rule& define(const char* r_name, abnf_rule& r);
 	
+	/*!
+	 * \brief Sets whether the matching segments of the given rule are stored
+	 * by \link abnf_rule::read read \endlink operations.
+	 *
+	 * By default, only those of rules named by \link define \endlink are
+	 * stored, so reading does not spend time nor memory on segments of the
+	 * annonymous rules they are made of. Segments of rules which are not
+	 * captured are not counted by \link abnf_rule::read_count read_count
+	 * \endlink.
+	 *
+	 * Compiled rules are not affected until \link compile \endlink is called
+	 * again.
+	 *
+	 * \param r
+	 *			A rule of this rule set.
+	 * \param cap
+	 *			Whether the segments of \p r are stored.
+	 *
+	 * \throw std::invalid_argument
+	 *			If \p r is not created by this rule set.
+	 */
+	void capture(abnf_rule& r, bool cap = true);
+	
+	/*!
+	 * \brief Sets the semantic action of the given rule.
+	 *
+	 * Read operations storing their results to an \link abnf_result
+	 * \endlink created with caller data call it for every matching segment of
+	 * \p r, whether it is captured or not, as it is stored. So consumers can
+	 * build their representation of the input while it is read, instead of
+	 * going through the stored segments afterwards. Segments are given in
+	 * the order they end, those of the same rule in input order.
+	 *
+	 * Compiled rules are not affected until \link compile \endlink is called
+	 * again.
+	 *
+	 * \param r
+	 *			A rule of this rule set.
+	 * \param act
+	 *			The action of \p r, or null for none.
+	 *
+	 * \throw std::invalid_argument
+	 *			If \p r is not created by this rule set.
+	 */
+	void action(abnf_rule& r, abnf_action act);
+	
 	/*!
 	 * \brief Creates an special rule for an EOF reaching.
 	 *
@@ -275,6 +401,33 @@ class abnf_ruleset
 	 */
 	abnf_rule& alternat(const char* altch);
 	
+	/*!
+	 * \brief Creates a convenient rule consisting in multiple alternative
+	 * case insensitive character strings.
+	 *
+	 * It is the same as multiple consecutive alternatives of character string
+	 * terminals, but all of them are matched in a single pass over the input.
+	 *
+	 * For example,
+	 *
+	 * \code
+	 * abnf_ruleset rset;
+	 * const char* methods[] = {"GET", "HEAD", "POST"};
+	 * abnf_rule& r_method = rset.alternat(methods, 3);
+	 * \endcode
+	 *
+	 * creates the <tt>"GET" / "HEAD" / "POST"</tt> rule.
+	 *
+	 * \param altstr
+	 *			Alternative character strings.
+	 * \param n
+	 *			Number of alternative character strings.
+	 *
+	 * \return
+	 *			The created character strings alternatives rule.
+	 */
+	abnf_rule& alternat(const char* const altstr[], int n);
+	
 	/*!
 	 * \brief Creates an alternative rule of two rules.
 	 *
@@ -331,6 +484,8 @@ class abnf_ruleset
 	 *			Minimum occurrences of the given rule.
 	 * \param r
 	 *			Rule which may appear repeatedly.
+	 * \param mode
+	 *			Matching mode of the repetition.
 	 *
 	 * \return
 	 *			The created repetition rule.
@@ -338,7 +493,8 @@ class abnf_ruleset
 	 * \throw std::invalid_argument
 	 *			If \p r is not created by this rule set.
 	 */
-	abnf_rule& repet(int r_min, abnf_rule& r);
+	abnf_rule& repet(int r_min, abnf_rule& r,
+			abnf_repet_mode mode = ABNF_REPET_LAZY);
 	
 	/*!
 	 * \brief Creates a repetition rule for the given rule with a minimum
@@ -359,6 +515,8 @@ class abnf_ruleset
 	 *			Maximum occurrences of the given rule.
 	 * \param r
 	 *			Rule which may appear repeatedly.
+	 * \param mode
+	 *			Matching mode of the repetition.
 	 *
 	 * \return
 	 *			The created repetition rule.
@@ -366,14 +524,314 @@ class abnf_ruleset
 	 * \throw std::invalid_argument
 	 *			If \p r is not created by this rule set.
 	 */
-	abnf_rule& repet(int r_min, int r_max, abnf_rule& r);
+	abnf_rule& repet(int r_min, int r_max, abnf_rule& r,
+			abnf_repet_mode mode = ABNF_REPET_LAZY);
+	
+	/*!
+	 * \brief Enables memoization of the matching results of the given rule.
+	 *
+	 * A memoized rule matches at most once for every stream position during
+	 * a \link abnf_rule::read read \endlink operation. Whenever the matching
+	 * process backtracks to a position where it already was tried, its
+	 * previous results are reused instead of matching the whole rule again.
+	 *
+	 * It is worth for rules which are reached many times at the same position,
+	 * like those following long repetitions or shared by many alternatives.
+	 *
+	 * \param r
+	 *			Rule to be memoized.
+	 * \param mem_max
+	 *			Maximum amount of bytes used to store results of \p r in a
+	 *			single read operation. When reached, results for new positions
+	 *			are not memoized anymore.
+	 *
+	 * \return
+	 *			The memoized rule.
+	 *
+	 * \throw std::invalid_argument
+	 *			If \p r is not created by this rule set.
+	 */
+	abnf_rule& memoize(abnf_rule& r, size_t mem_max = 1048576);
+	
+	/*!
+	 * \brief Optimizes the matching of all the rules of this rule set, without
+	 * changing their results.
+	 *
+	 * Any alternative of single character rules, like terminal characters,
+	 * ranges, character strings and terminal functions, is fused to a single
+	 * lookup on a character set. Segments matching the alternative rules
+	 * inside of it are still stored.
+	 *
+	 * Terminal functions are evaluated when optimizing, so changes of their
+	 * results afterwards, like those caused by a locale change, do not
+	 * affect the optimized rules.
+	 *
+	 * Chains of nested concatenations or alternatives are flattened, so
+	 * their children are matched by a single matcher instead of one for
+	 * each nesting level. Segments matching the nested rules are still
+	 * stored, but those memoized before optimizing are not absorbed.
+	 *
+	 * Alternatives whose children begin with the same single character
+	 * rules, like concat(alpha, x) and alpha, match them once for both.
+	 *
+	 * Chains of alternatives of character string terminals are matched in a
+	 * single pass over the input, as \link alternat(const char* const[], int)
+	 * \endlink does.
+	 *
+	 * Alternatives skip those of their children which cannot match before
+	 * the next input character, given the characters which may begin each
+	 * rule and whether it may match an empty segment.
+	 *
+	 * Rules created after optimizing are not optimized until this method is
+	 * called again. It should be called before \link compile \endlink.
+	 */
+	void optimize(void);
+	
+	/*!
+	 * \brief Compiles all the rules of this rule set into a program which is
+	 * used by their \link abnf_rule::read read \endlink operations from now
+	 * on.
+	 *
+	 * Instead of building a tree of matchers on every read operation, a
+	 * compiled rule runs as a sequence of instructions on an in-memory copy of
+	 * the stream, backtracking through an explicit stack. Matching results are
+	 * the same.
+	 *
+	 * Compiled rules, and the possessive repetitions they call, are run first
+	 * by a deterministic automaton built on demand from their instructions,
+	 * reading every character once. Those rules it cannot run, since they
+	 * call other possessive repetitions or need too many states, are run by
+	 * backtracking.
+	 *
+	 * Rules created after compiling are not compiled until this method is
+	 * called again. Compiled rules are not memoized, since compiled matching
+	 * does not repeat the work of those matchers memoization is intended for.
+	 *
+	 * Once compiled, a rule set can be shared by many threads, as long as
+	 * they only read through those \link abnf_rule::read read \endlink
+	 * operations which store the matching results to an \link abnf_result
+	 * \endlink, and no rule is created or defined meanwhile.
+	 */
+	void compile(void);
+	
+	/*!
+	 * \brief Translates the compiled rules of this rule set to native code,
+	 * which their read operations run instead of interpreting them.
+	 *
+	 * Character tests, character runs, calls, backtracking and segments
+	 * become processor instructions doing what the interpreter does, so the
+	 * matching results are the same. It is worth for rule sets reading large
+	 * amounts of input during a long time.
+	 *
+	 * Native code is only supported on x86-64 Unix systems. Elsewhere, or if
+	 * executable memory is not available, nothing is done and the rules are
+	 * still interpreted. It must be called again after compiling again.
+	 *
+	 * \throw std::logic_error
+	 *			If this rule set is not compiled.
+	 */
+	void jit(void);
+	
+	/*!
+	 * \brief Writes the C++ source of a parser of the given rule, which
+	 * matches as its \link abnf_rule::read read \endlink operations do.
+	 *
+	 * The parser is a <tt>name_read</tt> function, made of the compiled
+	 * instructions of the rule turned into jumps between labels, with
+	 * character sets as inlined tables. It does not allocate memory nor call
+	 * virtual functions. Instead, its calls and backtracking points are kept
+	 * in fixed size stacks, and its results in an \link abnf_gen_result
+	 * \endlink, whose segments are those of the rules defined by this rule
+	 * set, identified by the values of the <tt>name_rule</tt> enumeration.
+	 *
+	 * \param r
+	 *			A rule of this rule set or an included one.
+	 * \param name
+	 *			Prefix of the generated functions and types, and name of the
+	 *			header, without extension.
+	 * \param hs
+	 *			Stream where the header declaring the parser must be written.
+	 * \param cs
+	 *			Stream where the source defining the parser must be written.
+	 */
+	void generate(const abnf_rule& r, const char* name, std::ostream& hs,
+			std::ostream& cs) const;
 	
 	private:
 	
 	static abnf_ruleset _core_rset;
+	abnf_arena* _arena;
+	abnf_arena* _r_arena;
+	abnf_program* _prog;
 	abnf_rule* _empty_r;
-	std::set<abnf_rule*> _r_set;
+	std::vector<abnf_rule*> _r_vect;
 	std::map<std::string, abnf_rule*> _r_map;
+	std::map<std::string, abnf_rule*> _r_cons;
+	std::vector<const abnf_ruleset*> _rset_vect;
+	size_t _changes;
+	
+	/*!
+	 * \brief Rule defined with the given lower case name by this rule set or
+	 * an included one, or null if there is not any.
+	 */
+	abnf_rule* find(const std::string& str) const;
+	
+	/*!
+	 * \brief Indicates if rules of the given rule set can be used by this one,
+	 * since it is this rule set or an included one.
+	 */
+	bool includes(const abnf_ruleset& rset) const;
+	
+	/*!
+	 * \brief Makes the memory of matchers of this rule set and included ones
+	 * available again.
+	 */
+	void arena_reset(void) const;
+	
+	/*!
+	 * \brief Rule with the given structural key, or null if there is not any
+	 * such rule yet. A created rule must be stored to it.
+	 */
+	abnf_rule*& cons(const std::string& key)
+	{
+		return _r_cons[key];
+	}
+	
+	/*!
+	 * \brief Stores the given rule, allocated from the rule arena of this rule
+	 * set, in creation order.
+	 */
+	abnf_rule* store(abnf_rule* r)
+	{
+		_r_vect.push_back(r);
+		return r;
+	}
+	
+	/*!
+	 * \brief Number of times rules of this rule set and included ones were
+	 * defined, captured, given actions or memoized, which may keep rules
+	 * from matching through identical ones.
+	 */
+	size_t changes(void) const;
+	
+	/*!
+	 * \brief New rule matching through the given one, given instead of an
+	 * identical rule created from the given children rules, if any, but
+	 * storing its own segments.
+	 */
+	abnf_rule& alias(abnf_rule& r, abnf_rule* rl = NULL, abnf_rule* rr = NULL);
+	
+	friend class abnf_rule_ri;
+	friend class abnf_rule_alias;
+	friend void owner_test(const abnf_ruleset& rset, const abnf_rule& r);
+};
+
+/*!
+ * \brief Matching results of a \link abnf_rule::read read \endlink operation.
+ *
+ * Unlike the results stored to the rules themselves, a result belongs to the
+ * caller, so that many read operations of the same compiled rule can run at
+ * the same time, each one with its own result.
+ */
+class abnf_result
+{
+	public:
+	
+	/*!
+	 * \brief Creates an empty result.
+	 */
+	abnf_result(void);
+	
+	/*!
+	 * \brief Creates an empty result whose segments are also given to the
+	 * semantic actions of their rules.
+	 *
+	 * \param data
+	 *			Data given to the actions.
+	 */
+	abnf_result(void* data);
+	
+	/*!
+	 * \brief Releases this result.
+	 */
+	~abnf_result(void);
+	
+	/*!
+	 * \brief Number of characters matching the read rule.
+	 *
+	 * \return
+	 *			The matching length, or zero if it does not match.
+	 */
+	size_t length(void) const;
+	
+	/*!
+	 * \brief Number of segments matching the given rule.
+	 *
+	 * \param r
+	 *			A rule of the rule tree which was read.
+	 *
+	 * \return
+	 *			The matching segment count.
+	 */
+	size_t read_count(const abnf_rule& r) const;
+	
+	/*!
+	 * \brief Write the <tt>n</tt>th matching segment of the given rule to the
+	 * given stream.
+	 *
+	 * If there is not such a segment, nothing is done.
+	 *
+	 * \param r
+	 *			A rule of the rule tree which was read.
+	 * \param n
+	 *			Index of matching segment.
+	 * \param os
+	 *			Stream where the matching segment must be written.
+	 */
+	void write(const abnf_rule& r, size_t n, std::ostream& os) const;
+	
+	/*!
+	 * \brief The <tt>n</tt>th matching segment of the given rule, as a span
+	 * of the read input, so its characters are not copied.
+	 *
+	 * \param r
+	 *			A rule of the rule tree which was read.
+	 * \param n
+	 *			Index of matching segment.
+	 *
+	 * \return
+	 *			The matching segment, or an empty span if there is not such a
+	 *			segment.
+	 */
+	abnf_span span(const abnf_rule& r, size_t n) const;
+	
+	/*!
+	 * \brief Clear the matching results.
+	 */
+	void clear(void);
+	
+	private:
+	
+	const char* _buf;
+	size_t _len;
+	std::string _str;
+	abnf_segment_map* _seg_map;
+	void* _data;
+	bool _act;
+	
+	/*!
+	 * \brief Results are not copied.
+	 */
+	abnf_result(const abnf_result& res);
+	
+	/*!
+	 * \brief Results are not assigned.
+	 */
+	abnf_result& operator = (const abnf_result& res);
+	
+	friend class abnf_parser;
+	friend class abnf_program;
+	friend class abnf_rule_ri;
 };
 
 /*!
@@ -383,6 +841,18 @@ class abnf_rule
 {
 	public:
 	
+	/*!
+	 * \brief Length given by buffer \link read \endlink operations when the
+	 * rule does not match, unlike zero, given when it matches an empty
+	 * segment.
+	 */
+	static const size_t npos = (size_t) -1;
+	
+	/*!
+	 * \brief Releases this rule.
+	 */
+	virtual ~abnf_rule(void);
+	
 	/*!
 	 * \brief Owner ruleset.
 	 *
@@ -409,6 +879,124 @@ class abnf_rule
 	 */
 	virtual void read(std::istream& is) = 0;
 	
+	/*!
+	 * \brief Read from the given character buffer and store the matching
+	 * results to this rule tree.
+	 *
+	 * It is the same as reading from a stream with the buffer contents, but
+	 * the buffer is neither copied nor accessed through a stream. Positions
+	 * are plain offsets from \p buf.
+	 *
+	 * The results will be available for this rule until next read or \link
+	 * clear \endlink operation, as long as the buffer is not released.
+	 *
+	 * \param buf
+	 *			Content buffer.
+	 * \param len
+	 *			Length of the content buffer.
+	 *
+	 * \return
+	 *			Number of characters of \p buf matching this rule, or \link
+	 *			npos \endlink if it does not match.
+	 */
+	virtual size_t read(const char* buf, size_t len) = 0;
+	
+	/*!
+	 * \brief Read from the given stream and store the matching results to the
+	 * given result, instead of this rule tree.
+	 *
+	 * The stream is read in chunks, as far as the matching result depends
+	 * on it, and the characters read are copied to \p res. Positions of its
+	 * segments are offsets from the initial stream position. The stream is
+	 * left at the end of matching, or at its initial position if it does not
+	 * match.
+	 *
+	 * Since this rule tree is not modified, it is safe to perform this
+	 * operation concurrently with other read operations to results.
+	 *
+	 * \param is
+	 *			Content stream.
+	 * \param res
+	 *			Result where matching results are stored, replacing previous
+	 *			ones.
+	 *
+	 * \throw std::logic_error
+	 *			If this rule is not compiled.
+	 */
+	virtual void read(std::istream& is, abnf_result& res) const = 0;
+	
+	/*!
+	 * \brief Read from the given character buffer and store the matching
+	 * results to the given result, instead of this rule tree.
+	 *
+	 * The buffer is not copied, so the results are available as long as it
+	 * is not released.
+	 *
+	 * Since this rule tree is not modified, it is safe to perform this
+	 * operation concurrently with other read operations to results.
+	 *
+	 * \param buf
+	 *			Content buffer.
+	 * \param len
+	 *			Length of the content buffer.
+	 * \param res
+	 *			Result where matching results are stored, replacing previous
+	 *			ones.
+	 *
+	 * \return
+	 *			Number of characters of \p buf matching this rule, or \link
+	 *			npos \endlink if it does not match.
+	 *
+	 * \throw std::logic_error
+	 *			If this rule is not compiled.
+	 */
+	virtual size_t read(const char* buf, size_t len,
+			abnf_result& res) const = 0;
+	
+	/*!
+	 * \brief Find every match of this rule along the given character buffer,
+	 * instead of only at its beginning, and store them to the given result.
+	 *
+	 * Matches are searched from left to right, and each one is searched from
+	 * the end of the previous one, so they do not overlap. Empty matches are
+	 * not reported. Positions where this rule can not begin, since their
+	 * character is not one of those its matches begin with, are skipped
+	 * without trying to match them, many characters at once.
+	 *
+	 * Matches are \link abnf_result::span spans \endlink of this rule in
+	 * \p res, even if it is not captured, along with the segments of its
+	 * captured children rules. Their positions are offsets from \p buf, and
+	 * semantic actions are given the segments as they are found, if \p res
+	 * was created with data for them. For instance, reading the
+	 * "absoluteURI" rule of the \link uri::ruleset uri rule set \endlink finds
+	 * the links of a text.
+	 *
+	 * \code
+	 * const abnf_rule& r_link = uri::ruleset().get("absoluteURI");
+	 * abnf_result res;
+	 * size_t n = r_link.scan(text.data(), text.size(), res);
+	 * for (size_t i = 0; i < n; ++i)
+	 *     cout << res.span(r_link, i).str() << endl;
+	 * \endcode
+	 *
+	 * \param buf
+	 *			Content buffer.
+	 * \param len
+	 *			Length of the content buffer.
+	 * \param res
+	 *			Result where matches are stored, replacing previous ones. Its
+	 *			\link abnf_result::length length \endlink is the end of the
+	 *			last match.
+	 *
+	 * \return
+	 *			Number of matches of this rule in \p buf.
+	 *
+	 * \throw std::logic_error
+	 *			If this rule is not compiled.
+	 */
+	virtual size_t scan(const char* buf, size_t len,
+			abnf_result& res) const = 0;
+	
 	/*!
 	 * \brief Number of stream segments matching this rule from the last \link
 	 * read \endlink operation.
@@ -429,6 +1017,22 @@ class abnf_rule
 	 */
 	virtual void write(size_t n, std::ostream& os) const = 0;
 	
+	/*!
+	 * \brief The <tt>n</tt>th matching segment of this rule, from the last
+	 * \link read \endlink operation, as a span of the read input.
+	 *
+	 * Its characters are only available if the input was read from a
+	 * character buffer, which is not copied.
+	 *
+	 * \param n
+	 *			Index of matching segment.
+	 *
+	 * \return
+	 *			The matching segment, or an empty span if there is not such a
+	 *			segment.
+	 */
+	virtual abnf_span span(size_t n) const = 0;
+	
 	protected:
 	
 	/*!
@@ -444,6 +1048,130 @@ class abnf_rule
 	const abnf_ruleset& _rset;
 };
 
+/*!
+ * \brief Incremental read operation of a compiled rule, from input given in
+ * chunks as it arrives.
+ *
+ * Unlike reading from a stream, the input does not need to be seekable nor
+ * complete. Each chunk is matched as far as it allows, and the parser keeps
+ * only the characters which backtracking may read again, or which segments
+ * not yet reported contain. So memory depends on how far backtracking goes,
+ * instead of on the input length.
+ *
+ * Segments of captured rules, by default those defined with a name, are
+ * reported to \link segment \endlink as soon as backtracking can not undo
+ * them, in the order they end. The segment of the
+ * read rule itself is not reported, but given by \link length \endlink.
+ */
+class abnf_parser
+{
+	public:
+	
+	/*!
+	 * \brief Creates a parser of the given rule, waiting for input.
+	 *
+	 * \param r
+	 *			The rule to be read.
+	 *
+	 * \throw std::logic_error
+	 *			If \p r is not compiled.
+	 */
+	abnf_parser(const abnf_rule& r);
+	
+	/*!
+	 * \brief Releases this parser.
+	 */
+	virtual ~abnf_parser(void);
+	
+	/*!
+	 * \brief Matches the next characters of the input.
+	 *
+	 * \param buf
+	 *			Next characters of the input, which are copied as needed.
+	 * \param len
+	 *			Number of characters of \p buf.
+	 *
+	 * \retval true
+	 *			if the result depends on more input;
+	 * \retval false
+	 *			if the rule was matched or failed, so more input is ignored.
+	 */
+	bool feed(const char* buf, size_t len);
+	
+	/*!
+	 * \brief Ends the input, completing the matching.
+	 *
+	 * \retval true
+	 *			if the rule matches;
+	 * \retval false
+	 *			otherwise. Segments reported so far belong to an attempt which
+	 *			did not succeed.
+	 */
+	bool finish(void);
+	
+	/*!
+	 * \brief Number of characters matching the read rule.
+	 *
+	 * \return
+	 *			The matching length, or zero if it does not match or the
+	 *			matching is not complete.
+	 */
+	size_t length(void) const;
+	
+	/*!
+	 * \brief Number of input characters kept by this parser.
+	 *
+	 * \return
+	 *			The count of characters which may be read again.
+	 */
+	size_t buffered(void) const;
+	
+	protected:
+	
+	/*!
+	 * \brief Receives a segment of a captured rule. By default, nothing is
+	 * done.
+	 *
+	 * \param r
+	 *			A captured rule.
+	 * \param s
+	 *			Characters of the segment, available during the call only.
+	 * \param beg
+	 *			Position of the segment in the input.
+	 * \param end
+	 *			Position following the segment in the input.
+	 */
+	virtual void segment(const abnf_rule& r, const char* s, size_t beg,
+			size_t end);
+	
+	private:
+	
+	const abnf_program* _prog;
+	abnf_vm* _vm;
+	std::string _buf;
+	size_t _base;
+	int _m;
+	std::vector<bool> _held;
+	bool _hold_root;
+	abnf_result _res;
+	
+	/*!
+	 * \brief Reports the segments which backtracking can not undo, and
+	 * releases the characters which are not needed anymore.
+	 */
+	void settle(void);
+	
+	/*!
+	 * \brief Parsers are not copied.
+	 */
+	abnf_parser(const abnf_parser& p);
+	
+	/*!
+	 * \brief Parsers are not assigned.
+	 */
+	abnf_parser& operator = (const abnf_parser& p);
+};
+
 } // namespace xspider
 
 #endif // ABNF_H
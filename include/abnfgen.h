@@ -0,0 +1,325 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef ABNFGEN_H
+#define ABNFGEN_H
+
+#include <cctype>
+#include <cstddef>
+#include <ostream>
+
+#include "abnfspan.h"
+
+/*!
+ * \file
+ * \brief Support of parsers generated by \link
+ * xspider::abnf_ruleset::generate abnf_ruleset::generate \endlink.
+ */
+
+/*!
+ * \brief Maximum number of named rule segments stored by a generated parser.
+ */
+#define ABNF_GEN_SEGMENT_MAX 64
+
+/*!
+ * \brief Maximum number of nested rules and of pending backtracking points
+ * of a generated parser.
+ */
+#define ABNF_GEN_STACK_MAX 256
+
+namespace xspider {
+
+/*!
+ * \brief Matching results of a generated parser.
+ *
+ * Segments are stored in the result itself, so parsing does not allocate
+ * memory. They refer to the parsed buffer, which must not be released while
+ * the result is used.
+ */
+class abnf_gen_result
+{
+	public:
+	
+	/*!
+	 * \brief Creates an empty result.
+	 */
+	abnf_gen_result(void):
+	_buf(NULL),
+	_len(0),
+	_count(0)
+	{
+	}
+	
+	/*!
+	 * \brief Number of characters matching the parsed rule.
+	 *
+	 * \return
+	 *			The matching length, or zero if it does not match.
+	 */
+	size_t length(void) const
+	{
+		return _len;
+	}
+	
+	/*!
+	 * \brief Number of segments matching the given named rule.
+	 *
+	 * \param r
+	 *			A named rule of the generated parser.
+	 *
+	 * \return
+	 *			The matching segment count.
+	 */
+	size_t read_count(int r) const
+	{
+		size_t n = 0;
+		for (size_t i = 0; i < _count; ++i)
+			if (_r[i] == r)
+				++n;
+		return n;
+	}
+	
+	/*!
+	 * \brief Write the <tt>n</tt>th matching segment of the given named rule
+	 * to the given stream.
+	 *
+	 * If there is not such a segment, nothing is done.
+	 *
+	 * \param r
+	 *			A named rule of the generated parser.
+	 * \param n
+	 *			Index of matching segment.
+	 * \param os
+	 *			Stream where the matching segment must be written.
+	 */
+	void write(int r, size_t n, std::ostream& os) const
+	{
+		for (size_t i = 0; i < _count; ++i)
+			if (_r[i] == r and n-- == 0)
+			{
+				os.write(_buf + _beg[i], _end[i] - _beg[i]);
+				return;
+			}
+	}
+	
+	/*!
+	 * \brief The <tt>n</tt>th matching segment of the given named rule, as a
+	 * span of the parsed buffer.
+	 *
+	 * \param r
+	 *			A named rule of the generated parser.
+	 * \param n
+	 *			Index of matching segment.
+	 *
+	 * \return
+	 *			The matching segment, or an empty span if there is not such a
+	 *			segment.
+	 */
+	abnf_span span(int r, size_t n) const
+	{
+		for (size_t i = 0; i < _count; ++i)
+			if (_r[i] == r and n-- == 0)
+				return abnf_span(_buf + _beg[i], _beg[i], _end[i] - _beg[i]);
+		return abnf_span();
+	}
+	
+	/*!
+	 * \brief Clear the matching results.
+	 */
+	void clear(void)
+	{
+		_buf = NULL;
+		_len = 0;
+		_count = 0;
+	}
+	
+	/*!
+	 * \brief Starts the results of parsing the given buffer. Used by
+	 * generated parsers.
+	 */
+	void start(const char* buf)
+	{
+		_buf = buf;
+		_len = 0;
+		_count = 0;
+	}
+	
+	/*!
+	 * \brief Sets the matching length. Used by generated parsers.
+	 */
+	void finish(size_t len)
+	{
+		_len = len;
+	}
+	
+	/*!
+	 * \brief Number of stored segments. Used by generated parsers.
+	 */
+	size_t size(void) const
+	{
+		return _count;
+	}
+	
+	/*!
+	 * \brief Drops the segments stored after the first <tt>n</tt> ones, when
+	 * backtracking. Used by generated parsers.
+	 */
+	void resize(size_t n)
+	{
+		_count = n;
+	}
+	
+	/*!
+	 * \brief Stores a segment of the given named rule. Used by generated
+	 * parsers.
+	 *
+	 * \return
+	 *			False if there is no room for it; true otherwise.
+	 */
+	bool segment_add(int r, size_t beg, size_t end)
+	{
+		if (_count == ABNF_GEN_SEGMENT_MAX)
+			return false;
+		_r[_count] = r;
+		_beg[_count] = beg;
+		_end[_count++] = end;
+		return true;
+	}
+	
+	private:
+	
+	const char* _buf;
+	size_t _len;
+	size_t _count;
+	int _r[ABNF_GEN_SEGMENT_MAX];
+	size_t _beg[ABNF_GEN_SEGMENT_MAX];
+	size_t _end[ABNF_GEN_SEGMENT_MAX];
+};
+
+/*!
+ * \brief Called rule frame of a generated parser.
+ */
+class abnf_gen_frame
+{
+	public:
+	
+	/*!
+	 * \brief Uninitialized frame, for the frame stack.
+	 */
+	abnf_gen_frame(void)
+	{
+	}
+	
+	/*!
+	 * \brief Initialized frame.
+	 */
+	abnf_gen_frame(int parent, int ret, int r, size_t beg, int count,
+			size_t iter, size_t cut):
+	parent(parent),
+	ret(ret),
+	r(r),
+	beg(beg),
+	count(count),
+	iter(iter),
+	cut(cut)
+	{
+	}
+	
+	int parent;
+	int ret;
+	int r;
+	size_t beg;
+	int count;
+	size_t iter;
+	size_t cut;
+};
+
+/*!
+ * \brief Backtracking point of a generated parser.
+ */
+class abnf_gen_choice
+{
+	public:
+	
+	/*!
+	 * \brief Uninitialized backtracking point, for the backtracking stack.
+	 */
+	abnf_gen_choice(void)
+	{
+	}
+	
+	/*!
+	 * \brief Initialized backtracking point.
+	 */
+	abnf_gen_choice(int pc, size_t pos, int f, size_t f_count,
+			size_t seg_count):
+	pc(pc),
+	pos(pos),
+	f(f),
+	f_count(f_count),
+	seg_count(seg_count)
+	{
+	}
+	
+	int pc;
+	size_t pos;
+	int f;
+	size_t f_count;
+	size_t seg_count;
+};
+
+/*!
+ * \brief Indicates if character c is in the character set given by the cs
+ * bit table.
+ */
+inline bool abnf_gen_test(const unsigned char cs[32], unsigned char c)
+{
+	return cs[c >> 3] & 1 << (c & 7);
+}
+
+/*!
+ * \brief Length of the run of characters of the cs bit table which begins
+ * s, up to len characters.
+ */
+inline size_t abnf_gen_span(const unsigned char cs[32], const char* s,
+		size_t len)
+{
+	size_t n = 0;
+	while (n < len and abnf_gen_test(cs, s[n]))
+		++n;
+	return n;
+}
+
+/*!
+ * \brief Indicates if the len characters of s are those of the lower case
+ * str string, ignoring case.
+ */
+inline bool abnf_gen_equal(const unsigned char* str, const char* s,
+		size_t len)
+{
+	for (size_t i = 0; i < len; ++i)
+		if (tolower((unsigned char) s[i]) not_eq str[i])
+			return false;
+	return true;
+}
+
+} // namespace xspider
+
+#endif // ABNFGEN_H
@@ -0,0 +1,138 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef ABNFSPAN_H
+#define ABNFSPAN_H
+
+#include <cstddef>
+#include <string>
+
+/*!
+ * \file
+ * \brief Matching segments referring to the read input.
+ */
+
+namespace xspider {
+
+/*!
+ * \brief Segment of a read input, given by its position and length.
+ *
+ * If the input was read from a character buffer, the span refers to its
+ * characters, which are not copied. Those are available as long as the
+ * buffer is not released.
+ */
+class abnf_span
+{
+	public:
+	
+	/*!
+	 * \brief Creates an empty span.
+	 */
+	abnf_span(void):
+	_data(NULL),
+	_off(0),
+	_len(0)
+	{
+	}
+	
+	/*!
+	 * \brief Creates a span.
+	 *
+	 * \param data
+	 *			Characters of the span, or null if they are not available.
+	 * \param off
+	 *			Position of the span in the input.
+	 * \param len
+	 *			Number of characters of the span.
+	 */
+	abnf_span(const char* data, size_t off, size_t len):
+	_data(data),
+	_off(off),
+	_len(len)
+	{
+	}
+	
+	/*!
+	 * \brief Characters of this span.
+	 *
+	 * \return
+	 *			The first character of this span in the read buffer, or null if
+	 *			the input was read from a stream.
+	 */
+	const char* data(void) const
+	{
+		return _data;
+	}
+	
+	/*!
+	 * \brief Position of this span.
+	 *
+	 * \return
+	 *			The offset of the first character of this span in the input.
+	 */
+	size_t offset(void) const
+	{
+		return _off;
+	}
+	
+	/*!
+	 * \brief Number of characters of this span.
+	 *
+	 * \return
+	 *			The length of this span.
+	 */
+	size_t length(void) const
+	{
+		return _len;
+	}
+	
+	/*!
+	 * \brief Indicates if this span has no characters.
+	 *
+	 * \return
+	 *			True if its length is zero; false otherwise.
+	 */
+	bool empty(void) const
+	{
+		return _len == 0;
+	}
+	
+	/*!
+	 * \brief Copy of the characters of this span.
+	 *
+	 * \return
+	 *			A string with the characters of this span, or an empty one if
+	 *			they are not available.
+	 */
+	std::string str(void) const
+	{
+		return _data == NULL ? std::string() : std::string(_data, _len);
+	}
+	
+	private:
+	
+	const char* _data;
+	size_t _off;
+	size_t _len;
+};
+
+} // namespace xspider
+
+#endif // ABNFSPAN_H
@@ -0,0 +1,659 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef ABNFTPL_H
+#define ABNFTPL_H
+
+#include <cctype>
+#include <climits>
+#include <cstddef>
+
+#include <abnf.h>
+
+/*!
+ * \file
+ * \brief Grammars of ABNF rules built as types, matched by inlined code.
+ *
+ * Every grammar is a type composed of the templates of this file, which
+ * mirror the rule creation operations of xspider::abnf_ruleset. For example,
+ *
+ * \code
+ * typedef abnf_alternat<abnf_alternat_range<'0', '9'>,
+ *         abnf_alternat_range<'A', 'F'>, abnf_alternat_range<'a', 'f'> >
+ *         hexdig;
+ * typedef abnf_concat<abnf_terminal<'%'>, hexdig, hexdig> pct_encoded;
+ *
+ * size_t n = abnf_read<pct_encoded>(buf, len);
+ * \endcode
+ *
+ * matches the <tt>"%" HEXDIG HEXDIG</tt> rule at the beginning of \c buf.
+ * Since the whole matching is known at compile time, it needs neither rule
+ * set construction nor memory allocation, and the compiler can inline it
+ * entirely. It gives the same matching length than the rule built by the
+ * rule set, trying alternatives and repetitions in the same order.
+ *
+ * Matching does not store segments. A grammar may be given to a rule set
+ * by \link xspider::abnf_define abnf_define \endlink to get them.
+ *
+ * Grammars can not be recursive, and every backtracking point uses stack
+ * space of the matching, so long repetitions of rules other than single
+ * characters should be avoided.
+ */
+
+namespace xspider {
+
+/*!
+ * \brief Placeholder of the unused children of n-ary grammars.
+ */
+class abnf_nil
+{
+};
+
+/*!
+ * \brief Tag choosing between matching implementations. Used by grammar
+ * templates.
+ */
+template<bool B>
+class abnf_tpl_bool
+{
+};
+
+/*!
+ * \brief Continuation accepting any matching, which gives its end. Used by
+ * grammar templates.
+ */
+class abnf_tpl_accept
+{
+	public:
+	
+	/*!
+	 * \brief Continuation storing the end of matching to \p end.
+	 */
+	abnf_tpl_accept(size_t& end):
+	_end(end)
+	{
+	}
+	
+	/*!
+	 * \brief Accepts a matching ending at \p pos.
+	 */
+	bool operator()(size_t pos) const
+	{
+		_end = pos;
+		return true;
+	}
+	
+	private:
+	
+	size_t& _end;
+};
+
+/*!
+ * \brief Continuation matching grammar G, followed by continuation K. Used by
+ * grammar templates.
+ */
+template<typename G, typename K>
+class abnf_tpl_then
+{
+	public:
+	
+	/*!
+	 * \brief Initialized continuation.
+	 */
+	abnf_tpl_then(const char* buf, size_t len, const K& k):
+	_buf(buf),
+	_len(len),
+	_k(k)
+	{
+	}
+	
+	/*!
+	 * \brief Matches G from \p pos, and the continuation after it.
+	 */
+	bool operator()(size_t pos) const
+	{
+		return G::match(_buf, pos, _len, _k);
+	}
+	
+	private:
+	
+	const char* _buf;
+	size_t _len;
+	const K& _k;
+};
+
+/*!
+ * \brief Continuation after an occurrence of repetition G, followed by
+ * continuation K. Used by grammar templates.
+ */
+template<typename G, typename K>
+class abnf_tpl_loop
+{
+	public:
+	
+	/*!
+	 * \brief Continuation of the occurrence <tt>count + 1</tt>, beginning at
+	 * \p beg.
+	 */
+	abnf_tpl_loop(const char* buf, size_t beg, size_t len, int count,
+			const K& k):
+	_buf(buf),
+	_beg(beg),
+	_len(len),
+	_count(count),
+	_k(k)
+	{
+	}
+	
+	/*!
+	 * \brief Matches the rest of the repetition from \p pos, and the
+	 * continuation after it.
+	 */
+	bool operator()(size_t pos) const
+	{
+		return G::loop(_buf, _beg, pos, _len, _count, _k);
+	}
+	
+	private:
+	
+	const char* _buf;
+	size_t _beg;
+	size_t _len;
+	int _count;
+	const K& _k;
+};
+
+/*!
+ * \brief Base of the grammars matching a single character of a set, given by
+ * the static <tt>bool G::test(unsigned char)</tt> function.
+ */
+template<typename G>
+class abnf_tpl_char
+{
+	public:
+	
+	enum
+	{
+		single = true
+	};
+	
+	/*!
+	 * \brief Matches the character at \p pos of \p buf, and then the \p k
+	 * continuation.
+	 */
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k)
+	{
+		return pos < len and G::test(buf[pos]) and k(pos + 1);
+	}
+};
+
+/*!
+ * \brief Grammar of a character terminal.
+ *
+ * It is the same as \link abnf_ruleset::terminal(int) terminal \endlink rule
+ * of character \p C.
+ */
+template<int C>
+class abnf_terminal:
+public abnf_tpl_char<abnf_terminal<C> >
+{
+	public:
+	
+	/*!
+	 * \brief Indicates if \p c is the terminal character.
+	 */
+	static bool test(unsigned char c)
+	{
+		return c == C;
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		return rset.terminal(C);
+	}
+};
+
+/*!
+ * \brief Grammar of a case insensitive character string terminal.
+ *
+ * It is the same as \link abnf_ruleset::terminal(const char*) terminal
+ * \endlink rule of string \p S, which must have external linkage. For
+ * example,
+ *
+ * \code
+ * extern const char http[] = "http";
+ * typedef abnf_terminal_str<http> r_http;
+ * \endcode
+ */
+template<const char* S>
+class abnf_terminal_str
+{
+	public:
+	
+	enum
+	{
+		single = false
+	};
+	
+	/*!
+	 * \brief Matches the string at \p pos of \p buf, and then the \p k
+	 * continuation.
+	 */
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k)
+	{
+		if (S[0] == '\0')
+			return false;
+		
+		size_t i = 0;
+		while (S[i] not_eq '\0')
+		{
+			if (pos + i == len or tolower((unsigned char) S[i]) not_eq
+					tolower((unsigned char) buf[pos + i]))
+				return false;
+			++i;
+		}
+		return k(pos + i);
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		return rset.terminal(S);
+	}
+};
+
+/*!
+ * \brief Grammar of a terminal given by a character testing function.
+ *
+ * It is the same as \link abnf_ruleset::terminal(int (*)(int)) terminal
+ * \endlink rule of function \p F.
+ */
+template<int (*F)(int)>
+class abnf_terminal_fn:
+public abnf_tpl_char<abnf_terminal_fn<F> >
+{
+	public:
+	
+	/*!
+	 * \brief Indicates if \p c is a terminal character.
+	 */
+	static bool test(unsigned char c)
+	{
+		return F(c) > 0;
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		return rset.terminal(F);
+	}
+};
+
+/*!
+ * \brief Grammar of a range of characters.
+ *
+ * It is the same as \link abnf_ruleset::alternat(int, int) alternat \endlink
+ * rule of range <tt>[CI,CE]</tt>.
+ */
+template<int CI, int CE>
+class abnf_alternat_range:
+public abnf_tpl_char<abnf_alternat_range<CI, CE> >
+{
+	public:
+	
+	/*!
+	 * \brief Indicates if \p c is in the range.
+	 */
+	static bool test(unsigned char c)
+	{
+		return c >= CI and c <= (CE > CI ? CE : CI);
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		return rset.alternat(CI, CE);
+	}
+};
+
+/*!
+ * \brief Grammar of the end of input.
+ *
+ * It is the same as \link abnf_ruleset::eof eof \endlink rule.
+ */
+class abnf_eof
+{
+	public:
+	
+	enum
+	{
+		single = false
+	};
+	
+	/*!
+	 * \brief Matches if \p pos is the end of \p buf, and then the \p k
+	 * continuation.
+	 */
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k)
+	{
+		return pos == len and k(pos);
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		return rset.eof();
+	}
+};
+
+/*!
+ * \brief Grammar of a concatenation of up to eight grammars.
+ *
+ * It is the same as the \link abnf_ruleset::concat concat \endlink rule of
+ * the given grammars.
+ */
+template<typename G1, typename G2 = abnf_nil, typename G3 = abnf_nil,
+		typename G4 = abnf_nil, typename G5 = abnf_nil,
+		typename G6 = abnf_nil, typename G7 = abnf_nil,
+		typename G8 = abnf_nil>
+class abnf_concat
+{
+	public:
+	
+	typedef abnf_concat<G2, G3, G4, G5, G6, G7, G8> tail;
+	
+	enum
+	{
+		single = false
+	};
+	
+	/*!
+	 * \brief Matches the grammars from \p pos of \p buf, and then the \p k
+	 * continuation.
+	 */
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k)
+	{
+		return G1::match(buf, pos, len, abnf_tpl_then<tail, K>(buf, len, k));
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		abnf_rule& rl = G1::rule(rset);
+		return rset.concat(rl, tail::rule(rset));
+	}
+};
+
+/*!
+ * \brief Concatenation of a single grammar, which is the grammar itself.
+ */
+template<typename G1>
+class abnf_concat<G1, abnf_nil, abnf_nil, abnf_nil, abnf_nil, abnf_nil,
+		abnf_nil, abnf_nil>:
+public G1
+{
+};
+
+/*!
+ * \brief Grammar of an alternative of up to eight grammars.
+ *
+ * It is the same as the \link abnf_ruleset::alternat(abnf_rule&, abnf_rule&)
+ * alternat \endlink rule of the given grammars. Alternatives of single
+ * characters are matched by a single test.
+ */
+template<typename G1, typename G2 = abnf_nil, typename G3 = abnf_nil,
+		typename G4 = abnf_nil, typename G5 = abnf_nil,
+		typename G6 = abnf_nil, typename G7 = abnf_nil,
+		typename G8 = abnf_nil>
+class abnf_alternat
+{
+	public:
+	
+	typedef abnf_alternat<G2, G3, G4, G5, G6, G7, G8> tail;
+	
+	enum
+	{
+		single = G1::single and tail::single
+	};
+	
+	/*!
+	 * \brief Indicates if \p c matches any alternative, if all of them are
+	 * single characters.
+	 */
+	static bool test(unsigned char c)
+	{
+		return G1::test(c) or tail::test(c);
+	}
+	
+	/*!
+	 * \brief Matches the first alternative from \p pos of \p buf followed by
+	 * the \p k continuation.
+	 */
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k)
+	{
+		return match(buf, pos, len, k, abnf_tpl_bool<single>());
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		abnf_rule& rl = G1::rule(rset);
+		return rset.alternat(rl, tail::rule(rset));
+	}
+	
+	private:
+	
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k,
+			abnf_tpl_bool<true>)
+	{
+		return pos < len and test(buf[pos]) and k(pos + 1);
+	}
+	
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k,
+			abnf_tpl_bool<false>)
+	{
+		return G1::match(buf, pos, len, k) or tail::match(buf, pos, len, k);
+	}
+};
+
+/*!
+ * \brief Alternative of a single grammar, which is the grammar itself.
+ */
+template<typename G1>
+class abnf_alternat<G1, abnf_nil, abnf_nil, abnf_nil, abnf_nil, abnf_nil,
+		abnf_nil, abnf_nil>:
+public G1
+{
+};
+
+/*!
+ * \brief Grammar of a repetition of grammar G.
+ *
+ * It is the same as the \link abnf_ruleset::repet(int, int, abnf_rule&,
+ * abnf_repet_mode) repet \endlink rule of G, with \c INT_MAX as maximum for
+ * unbounded repetitions. Repetitions of single characters are matched as a
+ * run of characters.
+ */
+template<int R_MIN, int R_MAX, typename G,
+		abnf_repet_mode MODE = ABNF_REPET_LAZY>
+class abnf_repet
+{
+	public:
+	
+	enum
+	{
+		single = false,
+		r_min = R_MIN > 0 ? R_MIN : 0,
+		r_max = R_MAX > r_min ? R_MAX : r_min
+	};
+	
+	/*!
+	 * \brief Matches the occurrences of G from \p pos of \p buf followed by
+	 * the \p k continuation, in the order of the repetition mode.
+	 */
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k)
+	{
+		return match(buf, pos, len, k, abnf_tpl_bool<G::single>());
+	}
+	
+	/*!
+	 * \brief Matches the occurrences following occurrence \p count, which
+	 * matched from \p beg to \p pos, and then the \p k continuation. Used by
+	 * grammar templates.
+	 */
+	template<typename K>
+	static bool loop(const char* buf, size_t beg, size_t pos, size_t len,
+			int count, const K& k)
+	{
+		// Empty occurrences beyond the minimum lead nowhere new
+		if (pos == beg and count >= r_min)
+			return false;
+		return iter(buf, pos, len, count + 1, k);
+	}
+	
+	/*!
+	 * \brief Creates the same rule on the given rule set.
+	 */
+	static abnf_rule& rule(abnf_ruleset& rset)
+	{
+		return rset.repet(R_MIN, R_MAX, G::rule(rset), MODE);
+	}
+	
+	private:
+	
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k,
+			abnf_tpl_bool<true>)
+	{
+		size_t n = 0;
+		while (n < len - pos and n < (size_t) r_max and G::test(buf[pos + n]))
+			++n;
+		if (n < (size_t) r_min)
+			return false;
+		
+		if (MODE == ABNF_REPET_LAZY)
+		{
+			for (size_t i = r_min; i <= n; ++i)
+				if (k(pos + i))
+					return true;
+			return false;
+		}
+		if (MODE == ABNF_REPET_GREEDY)
+		{
+			for (size_t i = n + 1; i-- > (size_t) r_min;)
+				if (k(pos + i))
+					return true;
+			return false;
+		}
+		return k(pos + n);
+	}
+	
+	template<typename K>
+	static bool match(const char* buf, size_t pos, size_t len, const K& k,
+			abnf_tpl_bool<false>)
+	{
+		if (MODE not_eq ABNF_REPET_POSSESSIVE)
+			return iter(buf, pos, len, 0, k);
+		
+		// Backtracking never goes into the repetition
+		size_t end;
+		return iter(buf, pos, len, 0, abnf_tpl_accept(end)) and k(end);
+	}
+	
+	template<typename K>
+	static bool iter(const char* buf, size_t pos, size_t len, int count,
+			const K& k)
+	{
+		abnf_tpl_loop<abnf_repet, K> next(buf, pos, len, count, k);
+		if (count < r_min)
+			return G::match(buf, pos, len, next);
+		if (count >= r_max)
+			return k(pos);
+		if (MODE == ABNF_REPET_LAZY)
+			return k(pos) or G::match(buf, pos, len, next);
+		return G::match(buf, pos, len, next) or k(pos);
+	}
+};
+
+/*!
+ * \brief Matches grammar G against the given character buffer.
+ *
+ * \param buf
+ *			Content buffer.
+ * \param len
+ *			Length of the content buffer.
+ *
+ * \return
+ *			Number of characters of \p buf matching G, or \link
+ *			abnf_rule::npos npos \endlink if it does not match.
+ */
+template<typename G>
+size_t abnf_read(const char* buf, size_t len)
+{
+	size_t end;
+	if (not G::match(buf, 0, len, abnf_tpl_accept(end)))
+		return abnf_rule::npos;
+	return end;
+}
+
+/*!
+ * \brief Creates the rule of grammar G on the given rule set and defines it
+ * with the given name, so that its segments are stored when reading.
+ *
+ * \param rset
+ *			Rule set where the rule is created.
+ * \param r_name
+ *			Name of the defined rule.
+ *
+ * \return
+ *			The defined rule.
+ */
+template<typename G>
+abnf_rule& abnf_define(abnf_ruleset& rset, const char* r_name)
+{
+	return rset.define(r_name, G::rule(rset));
+}
+
+} // namespace xspider
+
+#endif // ABNFTPL_H
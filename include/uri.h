@@ -145,6 +145,17 @@ class uri
 		return _query;
 	}
 	
+	/*!
+	 * \brief URI rule set, which is built once, at first call. Its rule named
+	 * URI-reference matches URI references, and the one named absoluteURI
+	 * matches absolute URIs, so it can be \link abnf_rule::scan scanned
+	 * \endlink for links along a text.
+	 *
+	 * \return
+	 *			A reference to the URI rule set.
+	 */
+	static const abnf_ruleset& ruleset(void);
+	
 	private:
 	
 	static abnf_ruleset _rset;
@@ -156,6 +167,19 @@ class uri
 	std::list<std::string> _path;
 	std::multimap<std::string, std::string> _query;
 	
+	/*!
+	 * \brief URI reference rule of the URI rule set, which is built once, at
+	 * first call.
+	 */
+	static const abnf_rule& rule(void);
+	
+	/*!
+	 * \brief Assigns to this URI the given component segments, in the order
+	 * of their named rules, empty if they were not matched. They are those
+	 * given by the actions of the named rules while reading.
+	 */
+	void assign(const abnf_span comp[]);
+	
 	friend std::istream& operator >> (std::istream& is, uri& u);
 	friend std::ostream& operator << (std::ostream& os, const uri& u);
 };
@@ -0,0 +1,354 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include "abnfm.h"
+#include "abnfp.h"
+
+namespace xspider {
+
+/*
+ * Matcher for alias rule, storing the segments of the alias instead of those
+ * of its body.
+ */
+class abnf_matcher_alias:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized alias matcher, matching through a matcher of the body.
+	 */
+	abnf_matcher_alias(abnf_rule_ri& r, abnf_matcher* m):
+	abnf_matcher(r),
+	_m(m)
+	{
+	}
+	
+	/*
+	 * Delete the body matcher.
+	 */
+	~abnf_matcher_alias(void);
+	
+	/*
+	 * Available if, and only if the body matcher is available.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Commit children segments of the body matcher.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if, and only if the body matcher matches.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	abnf_matcher* _m;
+};
+
+/*
+ * Alias rule, given by rule set factories instead of a new rule identical to
+ * an existing one, its body. It matches as its body, sharing its children and
+ * its compiled code, but its own segments, action and memoized results are
+ * not those of its body.
+ *
+ * Once the children it was created from no longer match as those of the body,
+ * since some of them were defined, captured, given actions or memoized, it is
+ * split from the body: it matches through a rule like the body made of its
+ * own children instead.
+ */
+class abnf_rule_alias:
+public abnf_rule_ri
+{
+	public:
+	
+	/*
+	 * Initialized alias rule, created from the given children rules.
+	 */
+	abnf_rule_alias(const abnf_ruleset& rset, abnf_rule_ri& body,
+			const std::vector<abnf_rule_ri*>& ch):
+	abnf_rule_ri(rset),
+	_body(body),
+	_ch(ch),
+	_split(NULL),
+	_changes((size_t) -1)
+	{
+	}
+	
+	/*
+	 * Release the rule split from the body, if any.
+	 */
+	~abnf_rule_alias(void);
+	
+	/*
+	 * Add the segments of the children of the matched rule.
+	 */
+	void fused_child_segment_add(const char* s, std::streampos beg,
+			std::streampos end);
+	
+	/*
+	 * Add to res the segments of the children of the matched rule.
+	 */
+	void fused_child_segment_add(abnf_result& res, const char* s,
+			std::streampos beg, std::streampos end) const;
+	
+	/*
+	 * Whether this rule or any of the matched rule and its children rules
+	 * needs its segments.
+	 */
+	bool capture_needed(void) const;
+	
+	/*
+	 * Characters of the body.
+	 */
+	bool charset(abnf_charset& cs);
+	
+	/*
+	 * Optimizes the rule split from the body, if any. The body is optimized
+	 * by its own rule set.
+	 */
+	void optimize(void);
+	
+	/*
+	 * Character string of the body.
+	 */
+	bool literal(std::string& str);
+	
+	/*
+	 * The body.
+	 */
+	abnf_rule_ri& body(void)
+	{
+		return _body;
+	}
+	
+	/*
+	 * Appends the children rules this one was created from.
+	 */
+	void children(std::vector<abnf_rule_ri*>& ch)
+	{
+		ch.insert(ch.end(), _ch.begin(), _ch.end());
+	}
+	
+	protected:
+	
+	/*
+	 * Creates a matcher of the matched rule, wrapped by an alias matcher if
+	 * the segments of this rule or the matched one are stored.
+	 */
+	abnf_matcher* matcher_new_impl(void);
+	
+	/*
+	 * Call clear recursively on to children rules of the matched rule.
+	 */
+	void clear_impl(void);
+	
+	/*
+	 * Call stream_update recursively on to children rules of the matched
+	 * rule.
+	 */
+	void stream_update_impl(std::istream* is, const char* buf);
+	
+	/*
+	 * Duplicate operation implementation.
+	 */
+	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
+			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compiles the matched rule, whose instructions are run by calls to this
+	 * rule as well.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
+	
+	private:
+	
+	abnf_rule_ri& _body;
+	std::vector<abnf_rule_ri*> _ch;
+	mutable abnf_rule_ri* _split;
+	mutable size_t _changes;
+	
+	/*
+	 * Rule this one matches through: the body or, once its children no
+	 * longer match as those of the body, the rule split from it.
+	 */
+	abnf_rule_ri& matched(void) const;
+};
+
+} // namespace xspider
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * abnf_ruleset implementation
+ */
+
+abnf_rule& abnf_ruleset::alias(abnf_rule& r, abnf_rule* rl, abnf_rule* rr)
+{
+	vector<abnf_rule_ri*> ch;
+	if (rl not_eq NULL)
+		ch.push_back(&abnf_rule_ri::cast(*rl));
+	if (rr not_eq NULL)
+		ch.push_back(&abnf_rule_ri::cast(*rr));
+	return *store(new (*this) abnf_rule_alias(*this, abnf_rule_ri::cast(r),
+			ch));
+}
+
+/*
+ * abnf_matcher_alias implementation
+ */
+
+abnf_matcher_alias::~abnf_matcher_alias(void)
+{
+	delete _m;
+}
+
+bool abnf_matcher_alias::available(void) const
+{
+	return _m->available();
+}
+
+void abnf_matcher_alias::commit_impl(void)
+{
+	_m->commit_impl();
+}
+
+bool abnf_matcher_alias::match_impl(istream& is)
+{
+	return _m->match(is);
+}
+
+/*
+ * abnf_rule_alias implementation
+ */
+
+abnf_rule_alias::~abnf_rule_alias(void)
+{
+	delete _split;
+}
+
+void abnf_rule_alias::fused_child_segment_add(const char* s, streampos beg,
+		streampos end)
+{
+	matched().fused_child_segment_add(s, beg, end);
+}
+
+void abnf_rule_alias::fused_child_segment_add(abnf_result& res, const char* s,
+		streampos beg, streampos end) const
+{
+	matched().fused_child_segment_add(res, s, beg, end);
+}
+
+bool abnf_rule_alias::capture_needed(void) const
+{
+	return abnf_rule_ri::capture_needed() or matched().capture_needed();
+}
+
+bool abnf_rule_alias::charset(abnf_charset& cs)
+{
+	return _body.charset(cs);
+}
+
+void abnf_rule_alias::optimize(void)
+{
+	abnf_rule_ri& r = matched();
+	if (&r not_eq &_body)
+		r.optimize();
+}
+
+bool abnf_rule_alias::literal(string& str)
+{
+	return _body.literal(str);
+}
+
+abnf_matcher* abnf_rule_alias::matcher_new_impl(void)
+{
+	// The matched rule stores its own segments, not those of this rule
+	abnf_rule_ri& r = matched();
+	if (not captured() and not r.captured())
+		return r.matcher_new_impl();
+	return new (arena()) abnf_matcher_alias(*this, r.matcher_new_impl());
+}
+
+void abnf_rule_alias::clear_impl(void)
+{
+	matched().clear_impl();
+}
+
+void abnf_rule_alias::stream_update_impl(std::istream* is,
+		const char* buf)
+{
+	matched().stream_update_impl(is, buf);
+}
+
+abnf_rule_ri* abnf_rule_alias::dupl_impl(const abnf_ruleset& rset,
+		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
+{
+	vector<abnf_rule_ri*> ch;
+	for (size_t i = 0; i < _ch.size(); ++i)
+		ch.push_back(_ch[i]->dupl(rset, d_map));
+	return new (rset) abnf_rule_alias(rset, *_body.dupl(rset, d_map), ch);
+}
+
+int abnf_rule_alias::compile_impl(abnf_program& prog)
+{
+	return prog.entry_pc(prog.entry(matched()));
+}
+
+bool abnf_rule_alias::first_impl(abnf_charset& cs)
+{
+	cs |= _body.first();
+	return _body.nullable();
+}
+
+abnf_rule_ri& abnf_rule_alias::matched(void) const
+{
+	if (_split not_eq NULL)
+		return *_split;
+	
+	// Children may only stop matching as those of the body when rules are
+	// defined, captured, given actions or memoized
+	size_t changes = ruleset().changes();
+	if (changes == _changes)
+		return _body;
+	_changes = changes;
+	
+	vector<abnf_rule_ri*> ch;
+	_body.children(ch);
+	for (size_t i = 0; i < ch.size(); ++i)
+		if (not _ch[i]->same(*ch[i]))
+		{
+			_split = _body.rebuild_impl(ruleset(), _ch);
+			return *_split;
+		}
+	return _body;
+}
@@ -18,7 +18,12 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
  */
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -32,12 +37,22 @@ public abnf_matcher
 	
 	/*
 	 * Initialized alternate matcher.
+	 *
+	 * The left matcher is created at first matching, and the right one once
+	 * the left one does not match. If peek is true, those children which
+	 * cannot match before the next character are skipped.
 	 */
-	abnf_matcher_alt(abnf_rule_ri& r, abnf_rule_ri& rl, abnf_rule_ri& rr):
+	abnf_matcher_alt(abnf_rule_ri& r, abnf_rule_ri& rl, abnf_rule_ri& rr,
+			bool peek):
 	abnf_matcher(r),
+	_peek(peek),
+	_l_test(true),
+	_r_test(true),
 	_l_matched(false),
-	_ml(rl.matcher_new()),
-	_mr(rr.matcher_new())
+	_rl(rl),
+	_rr(rr),
+	_ml(NULL),
+	_mr(NULL)
 	{
 	}
 	
@@ -47,7 +62,8 @@ public abnf_matcher
 	~abnf_matcher_alt(void);
 	
 	/*
-	 * Available if, and only if any of two matchers is available.
+	 * Available if, and only if any of two matchers is available or the right
+	 * one was not tested yet, unless it was skipped.
 	 */
 	bool available(void) const;
 	
@@ -65,11 +81,197 @@ public abnf_matcher
 			
 	private:
 	
+	bool _peek;
+	bool _l_test, _r_test;
 	bool _l_matched;
+	abnf_rule_ri& _rl;
+	abnf_rule_ri& _rr;
 	abnf_matcher* _ml;
 	abnf_matcher* _mr;
 };
 
+/*
+ * Matcher for a flattened chain of alternate rules, trying each child once the
+ * previous one does not match.
+ */
+class abnf_matcher_cho:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized choice matcher.
+	 *
+	 * The matcher of each child is created once the previous one does not
+	 * match. Those children which cannot match before the next character are
+	 * skipped.
+	 */
+	abnf_matcher_cho(abnf_rule_ri& r, const std::vector<abnf_rule_ri*>& cho,
+			const std::vector<abnf_rule_span>& spans):
+	abnf_matcher(r),
+	_cho(cho),
+	_spans(spans),
+	_i(0),
+	_c(-1),
+	_m(NULL)
+	{
+	}
+	
+	/*
+	 * Delete current matcher.
+	 */
+	~abnf_matcher_cho(void);
+	
+	/*
+	 * Available if, and only if the current matcher is available or any of
+	 * next children was not tested yet, unless it is skipped.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Add the segments of absorbed rules containing the current child and
+	 * commit its matcher.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if, and only if one of children matchers matches.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	const std::vector<abnf_rule_ri*>& _cho;
+	const std::vector<abnf_rule_span>& _spans;
+	size_t _i;
+	int _c;
+	abnf_matcher* _m;
+	
+	/*
+	 * Index of the first child from i which may match before the next
+	 * character, or the number of children if there is none.
+	 */
+	size_t next(size_t i) const;
+};
+
+/*
+ * Matcher for a flattened chain of alternate rules of character string
+ * terminals.
+ *
+ * The strings beginning the stream are found at first matching. Then, every
+ * matching takes the next of them, in alternative order.
+ */
+class abnf_matcher_trie:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized trie matcher.
+	 */
+	abnf_matcher_trie(abnf_rule_ri& r, const abnf_trie& trie,
+			const std::vector<abnf_rule_ri*>& cho,
+			const std::vector<abnf_rule_span>& spans):
+	abnf_matcher(r),
+	_trie(trie),
+	_cho(cho),
+	_spans(spans),
+	_i(0)
+	{
+	}
+	
+	/*
+	 * Available if, and only if any of the found strings was not matched
+	 * yet.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Add the segment to the terminal rule of the matching string and to the
+	 * absorbed rules containing it.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if the next found string begins the stream.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	const abnf_trie& _trie;
+	const std::vector<abnf_rule_ri*>& _cho;
+	const std::vector<abnf_rule_span>& _spans;
+	std::vector<size_t> _idx;
+	size_t _i;
+};
+
+/*
+ * Matcher for a factored alternate rule, whose children are sequences of
+ * rules beginning with the same single character rules. This common prefix
+ * is matched once, followed by the rest of the left sequence and then by the
+ * rest of the right one.
+ */
+class abnf_matcher_fac:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized factored matcher, with the pre rules prefix of the left
+	 * and right sequences and the rules they absorb.
+	 */
+	abnf_matcher_fac(abnf_rule_ri& r, size_t pre,
+			const std::vector<abnf_rule_ri*>* seq,
+			const std::vector<abnf_rule_span>* spans):
+	abnf_matcher(r),
+	_pre(pre),
+	_seq(seq),
+	_spans(spans),
+	_side(0),
+	_side_test(true)
+	{
+	}
+	
+	/*
+	 * Delete prefix and sequence matchers.
+	 */
+	~abnf_matcher_fac(void);
+	
+	/*
+	 * Available if, and only if the right sequence was not tested yet or any
+	 * of its matchers is available.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Add the segments of the rules absorbed by the matching sequence and
+	 * commit prefix and sequence matchers.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if, and only if the prefix matches followed by the rest of any
+	 * of both sequences.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	const size_t _pre;
+	const std::vector<abnf_rule_ri*>* _seq;
+	const std::vector<abnf_rule_span>* _spans;
+	int _side;
+	bool _side_test;
+	std::vector<abnf_matcher*> _m_vect;
+};
+
 /*
  * Alternate rule.
  */
@@ -83,17 +285,71 @@ public abnf_rule_ri
 	 */
 	abnf_rule_alt(const abnf_ruleset& rset, abnf_rule_ri& rl, abnf_rule_ri& rr):
 	abnf_rule_ri(rset),
+	_opt(false),
+	_fused(false),
+	_lit(false),
+	_pre(0),
 	_rl(rl),
 	_rr(rr)
 	{
 	}
 	
+	/*
+	 * Add the segment, if this rule is fused, to those children rules which
+	 * match its character.
+	 */
+	void fused_child_segment_add(const char* s, std::streampos beg,
+			std::streampos end);
+	
+	/*
+	 * Add to res, if this rule is fused, the segments of those children rules
+	 * which match its character.
+	 */
+	void fused_child_segment_add(abnf_result& res, const char* s,
+			std::streampos beg, std::streampos end) const;
+	
+	/*
+	 * Whether this rule is captured or, if it is fused, any of its children
+	 * rules needs its segments.
+	 */
+	bool capture_needed(void) const;
+	
+	/*
+	 * Structural key of an alternative of the given rules.
+	 */
+	static abnf_rule_key key(abnf_rule_ri& rl, abnf_rule_ri& rr);
+	
+	/*
+	 * Structural key of this rule.
+	 */
+	std::string key(void);
+	
+	/*
+	 * Appends the left and right rules.
+	 */
+	void children(std::vector<abnf_rule_ri*>& ch);
+	
+	/*
+	 * Characters of both children, if they are single characters rules.
+	 */
+	bool charset(abnf_charset& cs);
+	
+	/*
+	 * Fuses this rule to a character set, if both children are single
+	 * character rules. Otherwise, factors out the single character rules
+	 * both children begin with, if any, or flattens the chain of alternate
+	 * rules below this one, if any, to a list of children tried by a single
+	 * matcher, which finds them at once if they are all character string
+	 * terminals.
+	 */
+	void optimize(void);
+	
 	protected:
 	
 	/*
 	 * Creates an alternate matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Clear left and right rules.
@@ -103,18 +359,120 @@ public abnf_rule_ri
 	/*
 	 * Update stream of left and right rules.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Rebuild operation implementation.
+	 */
+	abnf_rule_ri* rebuild_impl(const abnf_ruleset& rset,
+			const std::vector<abnf_rule_ri*>& ch) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
+	bool _opt;
+	bool _fused;
+	abnf_charset _cs, _cs_l;
+	std::vector<abnf_rule_ri*> _cho;
+	std::vector<abnf_rule_span> _spans;
+	bool _lit;
+	abnf_trie _trie;
+	size_t _pre;
+	std::vector<abnf_rule_ri*> _f_seq[2];
+	std::vector<abnf_rule_span> _f_spans[2];
 	abnf_rule_ri& _rl;
 	abnf_rule_ri& _rr;
+	
+	/*
+	 * Appends the children of r to the list, absorbing those which are not
+	 * memoized, fused or factored alternate rules.
+	 */
+	void flatten(abnf_rule_ri& r);
+	
+	/*
+	 * Builds the trie of the flattened children, if they are all character
+	 * string terminals.
+	 */
+	void trie_build(void);
+	
+	/*
+	 * Emits the instructions of the flattened rule of character string
+	 * terminals to prog.
+	 *
+	 * Returns the address of the first emitted instruction.
+	 */
+	int trie_compile(abnf_program& prog);
+	
+	/*
+	 * Factors out the longest common prefix of single character rules of
+	 * both children sequences.
+	 *
+	 * Returns true if there is any; false otherwise.
+	 */
+	bool factor(void);
+	
+	/*
+	 * Emits the instructions of the factored rule to prog, if the segments
+	 * of the rules absorbed by both children sequences can be stored from
+	 * its begin.
+	 *
+	 * Returns the address of the first emitted instruction, or -1 if they
+	 * cannot.
+	 */
+	int factor_compile(abnf_program& prog);
+};
+
+/*
+ * Matcher for alternate rule of single characters, fused to a character set.
+ */
+class abnf_matcher_altcs:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized character set alternate matcher.
+	 */
+	abnf_matcher_altcs(abnf_rule_alt& r, const abnf_charset& cs):
+	abnf_matcher(r),
+	_ra(r),
+	_cs(cs),
+	_c(0)
+	{
+	}
+	
+	protected:
+	
+	/*
+	 * Commit those children rules matching the character.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if next character is in the character set.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	abnf_rule_alt& _ra;
+	const abnf_charset& _cs;
+	char _c;
 };
 
 } // namespace xspider
@@ -133,7 +491,12 @@ abnf_rule& abnf_ruleset::alternat(abnf_rule& rl, abnf_rule& rr)
 	
 	abnf_rule_ri& rl_ri = abnf_rule_ri::cast(rl);
 	abnf_rule_ri& rr_ri = abnf_rule_ri::cast(rr);
-	return **_r_set.insert(new abnf_rule_alt(*this, rl_ri, rr_ri)).first;
+	abnf_rule*& r = cons(abnf_rule_alt::key(rl_ri, rr_ri));
+	if (r not_eq NULL)
+		return alias(*r, &rl, &rr);
+	
+	r = store(new (*this) abnf_rule_alt(*this, rl_ri, rr_ri));
+	return *r;
 }
 
 /*
@@ -148,7 +511,8 @@ abnf_matcher_alt::~abnf_matcher_alt(void)
 
 bool abnf_matcher_alt::available(void) const
 {
-	return _ml->available() or _mr->available();
+	return (_ml not_eq NULL and _ml->available()) or
+			(_r_test and (_mr == NULL or _mr->available()));
 }
 
 void abnf_matcher_alt::commit_impl(void)
@@ -158,21 +522,366 @@ void abnf_matcher_alt::commit_impl(void)
 
 bool abnf_matcher_alt::match_impl(istream& is)
 {
-	if (_l_matched = _ml->match(is))
+	// Test children before the next character at first matching
+	if (_ml == NULL and _mr == NULL)
+	{
+		if (_peek)
+		{
+			int c = is.peek();
+			is.clear();
+			_l_test = _rl.first_test(c);
+			_r_test = _rr.first_test(c);
+		}
+		if (_l_test)
+			_ml = _rl.matcher_new();
+	}
+	
+	if (_ml not_eq NULL and (_l_matched = _ml->match(is)))
 		return true;
+	if (not _r_test)
+		return false;
 		
 	is.clear();
 	is.seekg(stream_beg());
+	if (_mr == NULL)
+		_mr = _rr.matcher_new();
 	return _mr->match(is);
 }
 
+/*
+ * abnf_matcher_cho implementation
+ */
+
+abnf_matcher_cho::~abnf_matcher_cho(void)
+{
+	delete _m;
+}
+
+bool abnf_matcher_cho::available(void) const
+{
+	return (_m not_eq NULL and _m->available()) or
+			next(_i + 1) < _cho.size();
+}
+
+void abnf_matcher_cho::commit_impl(void)
+{
+	vector<abnf_rule_span>::const_iterator it = _spans.begin();
+	while (it not_eq _spans.end())
+	{
+		if (it->first <= _i and _i <= it->last)
+			it->r->segment_add(stream_beg(), stream_end());
+		++it;
+	}
+	_m->commit();
+}
+
+bool abnf_matcher_cho::match_impl(istream& is)
+{
+	if (_m == NULL)
+	{
+		_c = is.peek();
+		is.clear();
+		if ((_i = next(0)) == _cho.size())
+			return false;
+		_m = _cho[_i]->matcher_new();
+	}
+	
+	while (not _m->match(is))
+	{
+		size_t i = next(_i + 1);
+		if (i == _cho.size())
+			return false;
+		
+		_i = i;
+		delete _m;
+		_m = _cho[_i]->matcher_new();
+		is.clear();
+		is.seekg(stream_beg());
+	}
+	return true;
+}
+
+size_t abnf_matcher_cho::next(size_t i) const
+{
+	while (i < _cho.size() and not _cho[i]->first_test(_c))
+		++i;
+	return i;
+}
+
+/*
+ * abnf_matcher_trie implementation
+ */
+
+bool abnf_matcher_trie::available(void) const
+{
+	return _i < _idx.size();
+}
+
+void abnf_matcher_trie::commit_impl(void)
+{
+	size_t n = _idx[_i - 1];
+	vector<abnf_rule_span>::const_iterator it = _spans.begin();
+	while (it not_eq _spans.end())
+	{
+		if (it->first <= n and n <= it->last)
+			it->r->segment_add(stream_beg(), stream_end());
+		++it;
+	}
+	_cho[n]->segment_add(stream_beg(), stream_end());
+}
+
+bool abnf_matcher_trie::match_impl(istream& is)
+{
+	if (_i == 0)
+		_trie.find(is, _idx);
+	if (_i == _idx.size())
+		return false;
+	
+	is.clear();
+	is.seekg(stream_beg() + streamoff(_trie.length(_idx[_i++])));
+	return true;
+}
+
+/*
+ * abnf_matcher_fac implementation
+ */
+
+abnf_matcher_fac::~abnf_matcher_fac(void)
+{
+	vector<abnf_matcher*>::const_iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		delete *it++;
+}
+
+bool abnf_matcher_fac::available(void) const
+{
+	if (_side == 0)
+		return true;
+	
+	// Matchers of the prefix match once
+	for (size_t i = _pre; i < _m_vect.size(); ++i)
+		if (_m_vect[i]->available())
+			return true;
+	return false;
+}
+
+void abnf_matcher_fac::commit_impl(void)
+{
+	vector<abnf_rule_span>::const_iterator s_it = _spans[_side].begin();
+	while (s_it not_eq _spans[_side].end())
+	{
+		streampos beg = _m_vect[s_it->first]->stream_beg();
+		streampos end = _m_vect[s_it->last]->stream_end();
+		if (end > beg)
+			s_it->r->segment_add(beg, end);
+		++s_it;
+	}
+	
+	vector<abnf_matcher*>::const_iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		(*it++)->commit();
+}
+
+bool abnf_matcher_fac::match_impl(istream& is)
+{
+	// Match the prefix once
+	if (_m_vect.empty())
+		for (size_t i = 0; i < _pre; ++i)
+		{
+			is.clear();
+			is.seekg(i > 0 ? _m_vect[i - 1]->stream_end() : stream_beg());
+			_m_vect.push_back(_seq[0][i]->matcher_new());
+			if (not _m_vect.back()->match(is))
+			{
+				_side = 1;
+				return false;
+			}
+		}
+	
+	// Retry the last matcher of the current sequence, backtracking to the
+	// previous ones down to the prefix, and then test the right sequence
+	for (;;)
+	{
+		const vector<abnf_rule_ri*>& seq = _seq[_side];
+		size_t n = _m_vect.size();
+		
+		if (n == _pre)
+		{
+			if (not _side_test)
+			{
+				if (_side == 1)
+					return false;
+				_side = 1;
+				_side_test = true;
+				continue;
+			}
+			_side_test = false;
+			
+			if (seq.size() == _pre)
+			{
+				is.clear();
+				is.seekg(_m_vect.back()->stream_end());
+				return true;
+			}
+			_m_vect.push_back(seq[n]->matcher_new());
+			continue;
+		}
+		
+		is.clear();
+		is.seekg(_m_vect[n - 2]->stream_end());
+		if (_m_vect.back()->match(is))
+		{
+			if (n == seq.size())
+				return true;
+			_m_vect.push_back(seq[n]->matcher_new());
+		}
+		else
+		{
+			delete _m_vect.back();
+			_m_vect.pop_back();
+		}
+	}
+}
+
+/*
+ * abnf_matcher_altcs implementation
+ */
+
+void abnf_matcher_altcs::commit_impl(void)
+{
+	_ra.fused_child_segment_add(&_c, stream_beg(), stream_end());
+}
+
+bool abnf_matcher_altcs::match_impl(istream& is)
+{
+	return is.get(_c) and _cs.test(_c);
+}
+
 /*
  * abnf_rule_alt implementation
  */
+
+void abnf_rule_alt::fused_child_segment_add(const char* s, streampos beg,
+		streampos end)
+{
+	if (_fused)
+		(_cs_l.test(*s) ? _rl : _rr).fused_segment_add(s, beg, end);
+}
+
+void abnf_rule_alt::fused_child_segment_add(abnf_result& res, const char* s,
+		streampos beg, streampos end) const
+{
+	if (_fused)
+		(_cs_l.test(*s) ? _rl : _rr).fused_segment_add(res, s, beg, end);
+}
+
+bool abnf_rule_alt::capture_needed(void) const
+{
+	return captured() or (_fused and (_rl.capture_needed() or
+			_rr.capture_needed()));
+}
+
+bool abnf_rule_alt::charset(abnf_charset& cs)
+{
+	optimize();
+	if (_fused)
+		cs |= _cs;
+	return _fused;
+}
+
+void abnf_rule_alt::optimize(void)
+{
+	if (_opt)
+		return;
+	_opt = true;
+	
+	abnf_charset cs_l, cs_r;
+	if (_rl.charset(cs_l) and _rr.charset(cs_r))
+	{
+		_fused = true;
+		_cs_l = cs_l;
+		_cs = cs_l;
+		_cs |= cs_r;
+	}
+	else if (not factor())
+	{
+		flatten(*this);
+		trie_build();
+	}
+}
+
+void abnf_rule_alt::trie_build(void)
+{
+	abnf_trie trie;
+	string str;
+	vector<abnf_rule_ri*>::const_iterator it = _cho.begin();
+	while (it not_eq _cho.end())
+	{
+		if (not (*it++)->literal(str))
+			return;
+		trie.add(str);
+	}
+	_lit = true;
+	_trie = trie;
+}
+
+bool abnf_rule_alt::factor(void)
+{
+	_rl.sequence(_f_seq[0], _f_spans[0]);
+	_rr.sequence(_f_seq[1], _f_spans[1]);
+	
+	// Single character rules match once, so the prefix does not change the
+	// order of matches. Its segments are those of the left sequence, so those
+	// of the right one must be the same rules or store none
+	abnf_charset cs;
+	size_t n = min(_f_seq[0].size(), _f_seq[1].size());
+	while (_pre < n and _f_seq[0][_pre]->same(*_f_seq[1][_pre]) and
+			_f_seq[0][_pre]->charset(cs))
+		++_pre;
+	
+	if (_pre > 0)
+		return true;
+	for (int i = 0; i < 2; ++i)
+	{
+		_f_seq[i].clear();
+		_f_spans[i].clear();
+	}
+	return false;
+}
+
+void abnf_rule_alt::flatten(abnf_rule_ri& r)
+{
+	abnf_rule_alt* r_alt = dynamic_cast<abnf_rule_alt*>(&r);
+	if (r_alt not_eq NULL and &r not_eq this)
+		r_alt->optimize();
+	if (r_alt == NULL or (&r not_eq this and (r.memo_max() > 0 or
+			r_alt->_fused or r_alt->_pre > 0)))
+	{
+		_cho.push_back(&r);
+		return;
+	}
+	
+	// Segments of absorbed rules are added when any of their children matches
+	size_t s = _spans.size();
+	if (&r not_eq this)
+		_spans.push_back(abnf_rule_span(&r, _cho.size()));
+	flatten(r_alt->_rl);
+	flatten(r_alt->_rr);
+	if (&r not_eq this)
+		_spans[s].last = _cho.size() - 1;
+}
  
-abnf_matcher* abnf_rule_alt::matcher_new(void)
+abnf_matcher* abnf_rule_alt::matcher_new_impl(void)
 {
-	return new abnf_matcher_alt(*this, _rl, _rr);
+	if (_fused)
+		return new (arena()) abnf_matcher_altcs(*this, _cs);
+	if (_pre > 0)
+		return new (arena()) abnf_matcher_fac(*this, _pre, _f_seq, _f_spans);
+	if (_lit)
+		return new (arena()) abnf_matcher_trie(*this, _trie, _cho, _spans);
+	if (_cho.size() > 2)
+		return new (arena()) abnf_matcher_cho(*this, _cho, _spans);
+	return new (arena()) abnf_matcher_alt(*this, _rl, _rr, _opt);
 }
 
 void abnf_rule_alt::clear_impl(void)
@@ -181,14 +890,169 @@ void abnf_rule_alt::clear_impl(void)
 	_rr.clear();
 }
 
-void abnf_rule_alt::stream_update_impl(std::istream& is)
+void abnf_rule_alt::stream_update_impl(std::istream* is,
+		const char* buf)
 {
-	_rl.stream_update(is);
-	_rr.stream_update(is);
+	_rl.stream_update(is, buf);
+	_rr.stream_update(is, buf);
 }
 
 abnf_rule_ri* abnf_rule_alt::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_alt(rset, _rl, _rr);
+	return new (rset) abnf_rule_alt(rset, *_rl.dupl(rset, d_map),
+			*_rr.dupl(rset, d_map));
+}
+
+abnf_rule_ri* abnf_rule_alt::rebuild_impl(const abnf_ruleset& rset,
+		const vector<abnf_rule_ri*>& ch) const
+{
+	return new (rset) abnf_rule_alt(rset, *ch[0], *ch[1]);
+}
+
+abnf_rule_key abnf_rule_alt::key(abnf_rule_ri& rl, abnf_rule_ri& rr)
+{
+	return abnf_rule_key(ABNF_RULE_ALT) << &rl.body() << &rr.body();
+}
+
+string abnf_rule_alt::key(void)
+{
+	return key(_rl, _rr);
+}
+
+void abnf_rule_alt::children(vector<abnf_rule_ri*>& ch)
+{
+	ch.push_back(&_rl);
+	ch.push_back(&_rr);
+}
+
+int abnf_rule_alt::compile_impl(abnf_program& prog)
+{
+	if (_fused)
+	{
+		int pc = prog.size();
+		prog.emit(ABNF_OP_CLASS, prog.class_id(_cs));
+		prog.emit(ABNF_OP_RET);
+		return pc;
+	}
+	if (_pre > 0)
+	{
+		int pc = factor_compile(prog);
+		if (pc >= 0)
+			return pc;
+	}
+	if (_lit)
+		return trie_compile(prog);
+	
+	int l = prog.entry(_rl);
+	int r = prog.entry(_rr);
+	
+	// Once optimized, skip the children which cannot match before the next
+	// character, along with the backtracking point between them
+	bool l_test = _opt and not _rl.nullable();
+	bool r_test = _opt and not _rr.nullable();
+	
+	int pc = prog.size();
+	int pc_l = pc + l_test + r_test + 1;
+	if (l_test)
+		prog.emit(ABNF_OP_TEST, prog.class_id(_rl.first()), pc_l + 2);
+	if (r_test)
+		prog.emit(ABNF_OP_TEST, prog.class_id(_rr.first()), pc_l);
+	prog.emit(ABNF_OP_CHOICE, pc_l + 2);
+	prog.emit_call(l);
+	prog.emit(ABNF_OP_JMP, pc_l + 3);
+	prog.emit_call(r);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+int abnf_rule_alt::trie_compile(abnf_program& prog)
+{
+	vector<int> cho_r, span_r;
+	for (size_t i = 0; i < _cho.size(); ++i)
+		cho_r.push_back(prog.entry(*_cho[i]));
+	for (size_t i = 0; i < _spans.size(); ++i)
+		span_r.push_back(prog.entry(*_spans[i].r));
+	
+	// A jump table to a block for each string, storing the segments of its
+	// terminal rule and the absorbed rules containing it
+	size_t n = _cho.size();
+	int pc = prog.size();
+	vector<int> blk_pc(1, pc + n + 1);
+	for (size_t i = 0; i < n; ++i)
+	{
+		int len = 2;
+		for (size_t j = 0; j < _spans.size(); ++j)
+			len += _spans[j].first <= i and i <= _spans[j].last;
+		blk_pc.push_back(blk_pc.back() + len);
+	}
+	
+	prog.emit(ABNF_OP_TRIE, prog.trie_id(_trie));
+	for (size_t i = 0; i < n; ++i)
+		prog.emit(ABNF_OP_JMP, blk_pc[i]);
+	for (size_t i = 0; i < n; ++i)
+	{
+		prog.emit(ABNF_OP_CAP, cho_r[i]);
+		for (size_t j = 0; j < _spans.size(); ++j)
+			if (_spans[j].first <= i and i <= _spans[j].last)
+				prog.emit(ABNF_OP_CAP, span_r[j]);
+		prog.emit(ABNF_OP_JMP, blk_pc[n]);
+	}
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+int abnf_rule_alt::factor_compile(abnf_program& prog)
+{
+	// Absorbed rules are stored by CAP from the begin of this rule, once the
+	// prefix and their last child are matched
+	for (int i = 0; i < 2; ++i)
+	{
+		vector<abnf_rule_span>::const_iterator it = _f_spans[i].begin();
+		while (it not_eq _f_spans[i].end())
+		{
+			if (it->first not_eq 0 or it->last + 1 < _pre)
+				return -1;
+			++it;
+		}
+	}
+	
+	vector<int> seq_r[2], span_r[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		for (size_t j = 0; j < _f_seq[i].size(); ++j)
+			seq_r[i].push_back(prog.entry(*_f_seq[i][j]));
+		for (size_t j = 0; j < _f_spans[i].size(); ++j)
+			span_r[i].push_back(prog.entry(*_f_spans[i][j].r));
+	}
+	
+	int pc = prog.size();
+	int len_l = _f_seq[0].size() - _pre + _f_spans[0].size();
+	int len_r = _f_seq[1].size() - _pre + _f_spans[1].size();
+	int pc_r = pc + _pre + len_l + 2;
+	for (size_t j = 0; j < _pre; ++j)
+		prog.emit_call(seq_r[0][j]);
+	prog.emit(ABNF_OP_CHOICE, pc_r);
+	for (int i = 0; i < 2; ++i)
+	{
+		for (size_t j = _pre - 1; j < _f_seq[i].size(); ++j)
+		{
+			if (j >= _pre)
+				prog.emit_call(seq_r[i][j]);
+			for (size_t k = 0; k < _f_spans[i].size(); ++k)
+				if (_f_spans[i][k].last == j)
+					prog.emit(ABNF_OP_CAP, span_r[i][k]);
+		}
+		if (i == 0)
+			prog.emit(ABNF_OP_JMP, pc_r + len_r);
+	}
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_alt::first_impl(abnf_charset& cs)
+{
+	cs |= _rl.first();
+	cs |= _rr.first();
+	return _rl.nullable() or _rr.nullable();
 }
@@ -18,9 +18,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
  */
 
-#include <cstring>
-
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -35,9 +34,9 @@ public abnf_matcher
 	/*
 	 * Initialized characters alternate matcher.
 	 */
-	abnf_matcher_altch(abnf_rule_ri& r, const char*& altch):
+	abnf_matcher_altch(abnf_rule_ri& r, const abnf_charset& cs):
 	abnf_matcher(r),
-	_altch(altch)
+	_cs(cs)
 	{
 	}
 	
@@ -49,13 +48,13 @@ public abnf_matcher
 	void commit_impl(void);
 	
 	/*
-	 * Matches if next character is in alternative characters string.
+	 * Matches if next character is in alternative characters set.
 	 */
 	bool match_impl(std::istream& is);
 			
 	private:
 	
-	const char*& _altch;
+	const abnf_charset& _cs;
 };
 
 /*
@@ -67,20 +66,36 @@ public abnf_rule_ri
 	public:
 	
 	/*
-	 * Initialized range alternate rule.
+	 * Initialized characters alternate rule, with the characters of the
+	 * given string.
 	 */
 	abnf_rule_altch(const abnf_ruleset& rset, const char* altch):
+	abnf_rule_ri(rset)
+	{
+		while (*altch not_eq '\0')
+			_cs.set((unsigned char) *altch++);
+	}
+	
+	/*
+	 * Initialized characters alternate rule, with the given characters.
+	 */
+	abnf_rule_altch(const abnf_ruleset& rset, const abnf_charset& cs):
 	abnf_rule_ri(rset),
-	_altch(altch)
+	_cs(cs)
 	{
 	}
 	
+	/*
+	 * Alternative characters.
+	 */
+	bool charset(abnf_charset& cs);
+	
 	protected:
 	
 	/*
 	 * Creates a characters alternate matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done
@@ -90,17 +105,27 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
-	const char* _altch;
+	abnf_charset _cs;
 };
 
 } // namespace xspider
@@ -114,7 +139,12 @@ using namespace xspider;
  
 abnf_rule& abnf_ruleset::alternat(const char* altch)
 {
-	return **_r_set.insert(new abnf_rule_altch(*this, altch)).first;
+	abnf_rule*& r = cons(abnf_rule_key(ABNF_RULE_ALTCH) << altch);
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	r = store(new (*this) abnf_rule_altch(*this, altch));
+	return *r;
 }
 
 /*
@@ -127,38 +157,50 @@ void abnf_matcher_altch::commit_impl(void)
 
 bool abnf_matcher_altch::match_impl(istream& is)
 {
-	if (is.bad())
-		return false;
-	
 	char c;
-	is.get(c);
-	size_t len = strlen(_altch);
-	
-	for (int i = 0; i < len; ++i)
-		if (_altch[i] == c)
-			return true;
-	return false;
+	return is.get(c) and _cs.test(c);
 }
 
 /*
  * abnf_rule_altch implementation
  */
 
-abnf_matcher* abnf_rule_altch::matcher_new(void)
+abnf_matcher* abnf_rule_altch::matcher_new_impl(void)
+{
+	return new (arena()) abnf_matcher_altch(*this, _cs);
+}
+
+bool abnf_rule_altch::charset(abnf_charset& cs)
 {
-	return new abnf_matcher_altch(*this, _altch);
+	cs |= _cs;
+	return true;
 }
 
 void abnf_rule_altch::clear_impl(void)
 {
 }
 
-void abnf_rule_altch::stream_update_impl(std::istream& is)
+void abnf_rule_altch::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_altch::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_altch(rset, _altch);
+	return new (rset) abnf_rule_altch(rset, _cs);
+}
+
+int abnf_rule_altch::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_CLASS, prog.class_id(_cs));
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_altch::first_impl(abnf_charset& cs)
+{
+	charset(cs);
+	return false;
 }
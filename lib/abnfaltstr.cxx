@@ -0,0 +1,246 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "abnfm.h"
+#include "abnfp.h"
+
+namespace xspider {
+
+/*
+ * Matcher for strings alternate rule.
+ *
+ * The strings beginning the stream are found at first matching. Then, every
+ * matching takes the next of them, in alternative order.
+ */
+class abnf_matcher_altstr:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized strings alternate matcher.
+	 */
+	abnf_matcher_altstr(abnf_rule_ri& r, const abnf_trie& trie):
+	abnf_matcher(r),
+	_trie(trie),
+	_i(0)
+	{
+	}
+	
+	/*
+	 * Available if, and only if any of the found strings was not matched
+	 * yet.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Nothing to be done.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if the next found string begins the stream.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	const abnf_trie& _trie;
+	std::vector<size_t> _idx;
+	size_t _i;
+};
+
+/*
+ * Strings alternate rule.
+ */
+class abnf_rule_altstr:
+public abnf_rule_ri
+{
+	public:
+	
+	/*
+	 * Initialized strings alternate rule, with the given strings.
+	 */
+	abnf_rule_altstr(const abnf_ruleset& rset,
+			const std::vector<std::string>& str_vect):
+	abnf_rule_ri(rset),
+	_str_vect(str_vect)
+	{
+		for (size_t i = 0; i < _str_vect.size(); ++i)
+			_trie.add(_str_vect[i]);
+	}
+	
+	/*
+	 * Not a single character.
+	 */
+	bool charset(abnf_charset& cs);
+	
+	protected:
+	
+	/*
+	 * Creates a strings alternate matcher.
+	 */
+	abnf_matcher* matcher_new_impl(void);
+	
+	/*
+	 * Nothing to be done
+	 */
+	void clear_impl(void);
+	
+	/*
+	 * Nothing to be done.
+	 */
+	void stream_update_impl(std::istream* is, const char* buf);
+	
+	/*
+	 * Duplicate operation implementation.
+	 */
+	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
+			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
+			
+	private:
+	
+	std::vector<std::string> _str_vect;
+	abnf_trie _trie;
+};
+
+} // namespace xspider
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * abnf_ruleset implementation
+ */
+ 
+abnf_rule& abnf_ruleset::alternat(const char* const altstr[], int n)
+{
+	abnf_rule_key key(ABNF_RULE_ALTSTR);
+	for (int i = 0; i < n; ++i)
+		key << altstr[i];
+	
+	abnf_rule*& r = cons(key);
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	vector<string> str_vect(altstr, altstr + max(n, 0));
+	r = store(new (*this) abnf_rule_altstr(*this, str_vect));
+	return *r;
+}
+
+/*
+ * abnf_matcher_altstr implementation
+ */
+
+bool abnf_matcher_altstr::available(void) const
+{
+	return _i < _idx.size();
+}
+ 
+void abnf_matcher_altstr::commit_impl(void)
+{
+}
+
+bool abnf_matcher_altstr::match_impl(istream& is)
+{
+	if (_i == 0)
+		_trie.find(is, _idx);
+	if (_i == _idx.size())
+		return false;
+	
+	is.clear();
+	is.seekg(stream_beg() + streamoff(_trie.length(_idx[_i++])));
+	return true;
+}
+
+/*
+ * abnf_rule_altstr implementation
+ */
+
+abnf_matcher* abnf_rule_altstr::matcher_new_impl(void)
+{
+	return new (arena()) abnf_matcher_altstr(*this, _trie);
+}
+
+bool abnf_rule_altstr::charset(abnf_charset& cs)
+{
+	return false;
+}
+
+void abnf_rule_altstr::clear_impl(void)
+{
+}
+
+void abnf_rule_altstr::stream_update_impl(std::istream* is,
+		const char* buf)
+{
+}
+
+abnf_rule_ri* abnf_rule_altstr::dupl_impl(const abnf_ruleset& rset,
+		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
+{
+	return new (rset) abnf_rule_altstr(rset, _str_vect);
+}
+
+int abnf_rule_altstr::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	int n = _trie.size();
+	prog.emit(ABNF_OP_TRIE, prog.trie_id(_trie));
+	for (int i = 0; i < n; ++i)
+		prog.emit(ABNF_OP_JMP, pc + n + 1);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_altstr::first_impl(abnf_charset& cs)
+{
+	vector<string>::const_iterator it = _str_vect.begin();
+	while (it not_eq _str_vect.end())
+	{
+		if (not it->empty())
+		{
+			int ch = tolower((unsigned char) (*it)[0]);
+			for (int c = 0; c < 256; ++c)
+				if (tolower(c) == ch)
+					cs.set(c);
+		}
+		++it;
+	}
+	return false;
+}
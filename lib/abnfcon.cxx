@@ -18,7 +18,10 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
  */
  
+#include <vector>
+
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -32,13 +35,15 @@ public abnf_matcher
 	
 	/*
 	 * Initialized concatenation matcher.
+	 *
+	 * The right matcher is created once the left one matches.
 	 */
 	abnf_matcher_con(abnf_rule_ri& r, abnf_rule_ri& rl, abnf_rule_ri& rr):
 	abnf_matcher(r),
 	_l_test(true),
 	_rr(rr),
 	_ml(rl.matcher_new()),
-	_mr(rr.matcher_new())
+	_mr(NULL)
 	{
 	}
 	
@@ -72,6 +77,57 @@ public abnf_matcher
 	abnf_matcher* _mr;
 };
 
+/*
+ * Matcher for a flattened chain of concatenation rules, matching each child at
+ * the end of the previous one.
+ */
+class abnf_matcher_seq:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized sequence matcher.
+	 *
+	 * Children matchers are created once their previous one matches.
+	 */
+	abnf_matcher_seq(abnf_rule_ri& r, const std::vector<abnf_rule_ri*>& seq,
+			const std::vector<abnf_rule_span>& spans):
+	abnf_matcher(r),
+	_seq(seq),
+	_spans(spans)
+	{
+	}
+	
+	/*
+	 * Delete children matchers.
+	 */
+	~abnf_matcher_seq(void);
+	
+	/*
+	 * Available if, and only if any of children matchers is available.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Add the segments of absorbed rules and commit children matchers.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if, and only if all children matchers match one after another.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	const std::vector<abnf_rule_ri*>& _seq;
+	const std::vector<abnf_rule_span>& _spans;
+	std::vector<abnf_matcher*> _m_vect;
+};
+
 /*
  * Concatenation rule.
  */
@@ -85,17 +141,51 @@ public abnf_rule_ri
 	 */
 	abnf_rule_con(const abnf_ruleset& rset, abnf_rule_ri& rl, abnf_rule_ri& rr):
 	abnf_rule_ri(rset),
+	_opt(false),
 	_rl(rl),
 	_rr(rr)
 	{
 	}
 	
+	/*
+	 * Structural key of a concatenation of the given rules.
+	 */
+	static abnf_rule_key key(abnf_rule_ri& rl, abnf_rule_ri& rr);
+	
+	/*
+	 * Structural key of this rule.
+	 */
+	std::string key(void);
+	
+	/*
+	 * Appends the left and right rules.
+	 */
+	void children(std::vector<abnf_rule_ri*>& ch);
+	
+	/*
+	 * Not a single character.
+	 */
+	bool charset(abnf_charset& cs);
+	
+	/*
+	 * Flattens the chain of concatenation rules below this one, if any, to
+	 * a sequence of children matched by a single matcher, through sequence.
+	 */
+	void optimize(void);
+	
+	/*
+	 * Appends the flattened children of this rule to seq, and this rule to
+	 * spans, unless it is memoized.
+	 */
+	void sequence(std::vector<abnf_rule_ri*>& seq,
+			std::vector<abnf_rule_span>& spans);
+	
 	protected:
 	
 	/*
 	 * Creates a concatenation matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Clear left and right rules.
@@ -105,16 +195,35 @@ public abnf_rule_ri
 	/*
 	 * Update stream of left and right rules.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Rebuild operation implementation.
+	 */
+	abnf_rule_ri* rebuild_impl(const abnf_ruleset& rset,
+			const std::vector<abnf_rule_ri*>& ch) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
+	bool _opt;
+	std::vector<abnf_rule_ri*> _seq;
+	std::vector<abnf_rule_span> _spans;
 	abnf_rule_ri& _rl;
 	abnf_rule_ri& _rr;
 };
@@ -135,7 +244,12 @@ abnf_rule& abnf_ruleset::concat(abnf_rule& rl, abnf_rule& rr)
 	
 	abnf_rule_ri& rl_ri = abnf_rule_ri::cast(rl);
 	abnf_rule_ri& rr_ri = abnf_rule_ri::cast(rr);
-	return **_r_set.insert(new abnf_rule_con(*this, rl_ri, rr_ri)).first;
+	abnf_rule*& r = cons(abnf_rule_con::key(rl_ri, rr_ri));
+	if (r not_eq NULL)
+		return alias(*r, &rl, &rr);
+	
+	r = store(new (*this) abnf_rule_con(*this, rl_ri, rr_ri));
+	return *r;
 }
 
 /*
@@ -150,7 +264,7 @@ abnf_matcher_con::~abnf_matcher_con(void)
 
 bool abnf_matcher_con::available(void) const
 {
-	return _ml->available() or _mr->available();
+	return _ml->available() or (_mr not_eq NULL and _mr->available());
 }
 
 void abnf_matcher_con::commit_impl(void)
@@ -173,8 +287,13 @@ bool abnf_matcher_con::match_impl(istream& is)
 		{
 			is.seekg(_ml->stream_end());
 			
+			if (_mr == NULL)
+				_mr = _rr.matcher_new();
 			if (_l_test = not (r_matched = _mr->match(is)))
-				_mr = (delete _mr, _rr.matcher_new());
+			{
+				delete _mr;
+				_mr = NULL;
+			}
 		}
 	}
 	while (l_matched and not r_matched);
@@ -182,13 +301,111 @@ bool abnf_matcher_con::match_impl(istream& is)
 	return l_matched and r_matched;
 }
 
+/*
+ * abnf_matcher_seq implementation
+ */
+
+abnf_matcher_seq::~abnf_matcher_seq(void)
+{
+	vector<abnf_matcher*>::const_iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		delete *it++;
+}
+
+bool abnf_matcher_seq::available(void) const
+{
+	vector<abnf_matcher*>::const_iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		if ((*it++)->available())
+			return true;
+	return false;
+}
+
+void abnf_matcher_seq::commit_impl(void)
+{
+	vector<abnf_rule_span>::const_iterator s_it = _spans.begin();
+	while (s_it not_eq _spans.end())
+	{
+		streampos beg = _m_vect[s_it->first]->stream_beg();
+		streampos end = _m_vect[s_it->last]->stream_end();
+		if (end > beg)
+			s_it->r->segment_add(beg, end);
+		++s_it;
+	}
+	
+	vector<abnf_matcher*>::const_iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		(*it++)->commit();
+}
+
+bool abnf_matcher_seq::match_impl(istream& is)
+{
+	// Retry the last matcher, backtracking to the previous ones
+	if (_m_vect.empty())
+		_m_vect.push_back(_seq.front()->matcher_new());
+	
+	while (not _m_vect.empty())
+	{
+		size_t n = _m_vect.size();
+		is.clear();
+		is.seekg(n > 1 ? _m_vect[n - 2]->stream_end() : stream_beg());
+		
+		if (_m_vect.back()->match(is))
+		{
+			if (n == _seq.size())
+				return true;
+			_m_vect.push_back(_seq[n]->matcher_new());
+		}
+		else
+		{
+			delete _m_vect.back();
+			_m_vect.pop_back();
+		}
+	}
+	return false;
+}
+
 /*
  * abnf_rule_con implementation
  */
 
-abnf_matcher* abnf_rule_con::matcher_new(void)
+abnf_matcher* abnf_rule_con::matcher_new_impl(void)
+{
+	if (_seq.size() > 2)
+		return new (arena()) abnf_matcher_seq(*this, _seq, _spans);
+	return new (arena()) abnf_matcher_con(*this, _rl, _rr);
+}
+
+bool abnf_rule_con::charset(abnf_charset& cs)
+{
+	return false;
+}
+
+void abnf_rule_con::optimize(void)
 {
-	return new abnf_matcher_con(*this, _rl, _rr);
+	if (_opt)
+		return;
+	_opt = true;
+	
+	_rl.sequence(_seq, _spans);
+	_rr.sequence(_seq, _spans);
+}
+
+void abnf_rule_con::sequence(vector<abnf_rule_ri*>& seq,
+		vector<abnf_rule_span>& spans)
+{
+	if (memo_max() > 0)
+	{
+		seq.push_back(this);
+		return;
+	}
+	
+	// Segments of absorbed rules span their flattened children
+	size_t s = spans.size();
+	spans.push_back(abnf_rule_span(this, seq.size()));
+	_rl.sequence(seq, spans);
+	_rr.sequence(seq, spans);
+	spans[s].last = seq.size() - 1;
 }
 
 void abnf_rule_con::clear_impl(void)
@@ -197,14 +414,59 @@ void abnf_rule_con::clear_impl(void)
 	_rr.clear();
 }
 
-void abnf_rule_con::stream_update_impl(std::istream& is)
+void abnf_rule_con::stream_update_impl(std::istream* is,
+		const char* buf)
 {
-	_rl.stream_update(is);
-	_rr.stream_update(is);
+	_rl.stream_update(is, buf);
+	_rr.stream_update(is, buf);
 }
 
 abnf_rule_ri* abnf_rule_con::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_con(rset, _rl, _rr);
+	return new (rset) abnf_rule_con(rset, *_rl.dupl(rset, d_map),
+			*_rr.dupl(rset, d_map));
+}
+
+abnf_rule_ri* abnf_rule_con::rebuild_impl(const abnf_ruleset& rset,
+		const vector<abnf_rule_ri*>& ch) const
+{
+	return new (rset) abnf_rule_con(rset, *ch[0], *ch[1]);
+}
+
+abnf_rule_key abnf_rule_con::key(abnf_rule_ri& rl, abnf_rule_ri& rr)
+{
+	return abnf_rule_key(ABNF_RULE_CON) << &rl.body() << &rr.body();
+}
+
+string abnf_rule_con::key(void)
+{
+	return key(_rl, _rr);
+}
+
+void abnf_rule_con::children(vector<abnf_rule_ri*>& ch)
+{
+	ch.push_back(&_rl);
+	ch.push_back(&_rr);
+}
+
+int abnf_rule_con::compile_impl(abnf_program& prog)
+{
+	int l = prog.entry(_rl);
+	int r = prog.entry(_rr);
+	
+	int pc = prog.size();
+	prog.emit_call(l);
+	prog.emit_call(r);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_con::first_impl(abnf_charset& cs)
+{
+	cs |= _rl.first();
+	if (not _rl.nullable())
+		return false;
+	cs |= _rr.first();
+	return _rr.nullable();
 }
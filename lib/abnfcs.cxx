@@ -0,0 +1,141 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "abnfr.h"
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__)) and \
+		(__GNUC__ > 4 or (__GNUC__ == 4 and __GNUC_MINOR__ >= 9))
+#define ABNF_CS_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Character span implementations
+ */
+
+/*
+ * Number of leading characters of s, up to len, whose bit is set in map.
+ */
+static size_t abnf_span_scalar(const unsigned char (&map)[2][16],
+		const char* s, size_t len)
+{
+	size_t i = 0;
+	while (i < len)
+	{
+		unsigned char c = s[i];
+		if (not ((map[c >> 7][c & 15] >> ((c >> 4) & 7)) & 1))
+			break;
+		++i;
+	}
+	return i;
+}
+
+#ifdef ABNF_CS_X86
+
+/*
+ * Same as abnf_span_scalar, classifying 16 characters at once.
+ *
+ * The low nibble of every character selects its bits from both halves of
+ * map, the high nibble selects the half and the bit.
+ */
+__attribute__((target("ssse3")))
+static size_t abnf_span_ssse3(const unsigned char (&map)[2][16],
+		const char* s, size_t len)
+{
+	const __m128i map_lo = _mm_loadu_si128((const __m128i*) map[0]);
+	const __m128i map_hi = _mm_loadu_si128((const __m128i*) map[1]);
+	const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+			1, 2, 4, 8, 16, 32, 64, -128);
+	const __m128i nibble = _mm_set1_epi8(0x0f);
+	const __m128i seven = _mm_set1_epi8(7);
+	
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*) (s + i));
+		__m128i lo = _mm_and_si128(v, nibble);
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+		__m128i upper = _mm_cmpgt_epi8(hi, seven);
+		__m128i row = _mm_or_si128(
+				_mm_andnot_si128(upper, _mm_shuffle_epi8(map_lo, lo)),
+				_mm_and_si128(upper, _mm_shuffle_epi8(map_hi, lo)));
+		__m128i bit = _mm_shuffle_epi8(bits, hi);
+		__m128i in = _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+		unsigned int mask = _mm_movemask_epi8(in) ^ 0xffff;
+		if (mask not_eq 0)
+			return i + __builtin_ctz(mask);
+	}
+	return i + abnf_span_scalar(map, s + i, len - i);
+}
+
+/*
+ * Same as abnf_span_ssse3, with 32 characters at once.
+ */
+__attribute__((target("avx2")))
+static size_t abnf_span_avx2(const unsigned char (&map)[2][16],
+		const char* s, size_t len)
+{
+	const __m256i map_lo = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*) map[0]));
+	const __m256i map_hi = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*) map[1]));
+	const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+			1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+			1, 2, 4, 8, 16, 32, 64, -128);
+	const __m256i nibble = _mm256_set1_epi8(0x0f);
+	const __m256i seven = _mm256_set1_epi8(7);
+	
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*) (s + i));
+		__m256i lo = _mm256_and_si256(v, nibble);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+		__m256i upper = _mm256_cmpgt_epi8(hi, seven);
+		__m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(map_lo, lo),
+				_mm256_shuffle_epi8(map_hi, lo), upper);
+		__m256i bit = _mm256_shuffle_epi8(bits, hi);
+		__m256i in = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+		unsigned int mask = ~(unsigned int) _mm256_movemask_epi8(in);
+		if (mask not_eq 0)
+			return i + __builtin_ctz(mask);
+	}
+	return i + abnf_span_ssse3(map, s + i, len - i);
+}
+
+#endif // ABNF_CS_X86
+
+/*
+ * abnf_charset implementation
+ */
+
+size_t abnf_charset::span(const char* s, size_t len) const
+{
+#ifdef ABNF_CS_X86
+	if (__builtin_cpu_supports("avx2"))
+		return abnf_span_avx2(_map, s, len);
+	if (__builtin_cpu_supports("ssse3"))
+		return abnf_span_ssse3(_map, s, len);
+#endif
+	return abnf_span_scalar(_map, s, len);
+}
@@ -0,0 +1,315 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef ABNFD_H
+#define ABNFD_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include <pthread.h>
+
+#include "abnfr.h"
+
+/*
+ * Limits of the lazily built automata. An automaton needing more threads or
+ * states than these gives up, and its rule runs by backtracking.
+ */
+#define ABNF_DFA_THREAD_MAX 4096
+#define ABNF_DFA_STATE_MAX 512
+
+namespace xspider {
+
+class abnf_capture;
+class abnf_program;
+
+#if not defined(__GNUC__)
+#error "automata are published with GCC atomic builtins"
+#endif
+
+/*
+ * Pointer loaded after the objects it points to were stored by other thread.
+ */
+template<typename T>
+inline T* abnf_load(T* const& p)
+{
+	return __atomic_load_n(&p, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Pointer stored after the objects it points to, for other threads.
+ */
+template<typename T>
+inline void abnf_store(T*& p, T* v)
+{
+	__atomic_store_n(&p, v, __ATOMIC_RELEASE);
+}
+
+/*
+ * Mutex, serializing the lazy construction of automata shared by const
+ * read operations.
+ */
+class abnf_lock
+{
+	public:
+	
+	/*
+	 * Unlocked lock.
+	 */
+	abnf_lock(void)
+	{
+		pthread_mutex_init(&_mutex, NULL);
+	}
+	
+	/*
+	 * Release the lock resources.
+	 */
+	~abnf_lock(void)
+	{
+		pthread_mutex_destroy(&_mutex);
+	}
+	
+	/*
+	 * Waits until the lock is acquired.
+	 */
+	void acquire(void)
+	{
+		pthread_mutex_lock(&_mutex);
+	}
+	
+	/*
+	 * Release the lock.
+	 */
+	void release(void)
+	{
+		pthread_mutex_unlock(&_mutex);
+	}
+	
+	private:
+	
+	pthread_mutex_t _mutex;
+	
+	/*
+	 * Locks are not copied.
+	 */
+	abnf_lock(const abnf_lock& lock);
+	
+	/*
+	 * Locks are not assigned.
+	 */
+	abnf_lock& operator = (const abnf_lock& lock);
+};
+
+class abnf_dfa_state;
+
+/*
+ * Transition from a deterministic automaton state by a character, or by the
+ * end of input.
+ */
+class abnf_dfa_trans
+{
+	public:
+	
+	/*
+	 * Transition to nowhere, without matching.
+	 */
+	abnf_dfa_trans(void):
+	next(NULL),
+	match(-1)
+	{
+	}
+	
+	/*
+	 * Next state, or NULL if no thread survives.
+	 */
+	abnf_dfa_state* next;
+	
+	/*
+	 * Index of the thread of the source state completing the rule before the
+	 * character, or -1 if none does.
+	 */
+	int match;
+	
+	/*
+	 * Events of the completing thread.
+	 */
+	std::vector<int> match_events;
+	
+	/*
+	 * Index of the source thread of each thread of the next state.
+	 */
+	std::vector<int> parents;
+	
+	/*
+	 * Events of the source thread of each thread of the next state, before
+	 * the character.
+	 */
+	std::vector<std::vector<int> > events;
+};
+
+/*
+ * Deterministic automaton state: threads of the program waiting for the
+ * next character, from the highest priority to the lowest one.
+ */
+class abnf_dfa_state
+{
+	public:
+	
+	/*
+	 * State with the given threads and unknown transitions.
+	 */
+	abnf_dfa_state(const std::vector<int>& threads);
+	
+	std::vector<int> threads;
+	
+	/*
+	 * Transitions by every character and by the end of input, built on
+	 * demand.
+	 */
+	abnf_dfa_trans* trans[257];
+};
+
+/*
+ * Deterministic automaton matching a compiled rule, built lazily from its
+ * program.
+ *
+ * Threads are the configurations the program may reach without backtracking:
+ * address, repetition counters and called rules. Every state holds the
+ * threads alive at some input position in the order backtracking would try
+ * them, so the first completing thread gives the same match than the program.
+ * Its captures are recovered afterwards, replaying the events of the threads
+ * leading to it: calls, returns and stored segments.
+ *
+ * Those rules whose program drops backtracking points of a called rule, that
+ * is, possessive repetitions other than the matched one, cannot be run by
+ * threads.
+ */
+class abnf_dfa
+{
+	public:
+	
+	/*
+	 * Empty automaton for the rule with index r of the given program.
+	 */
+	abnf_dfa(const abnf_program& prog, int r);
+	
+	/*
+	 * Release states.
+	 */
+	~abnf_dfa(void);
+	
+	/*
+	 * Matches the rule against the characters of buf from beg to len. It may
+	 * be called concurrently.
+	 *
+	 * Returns 1 if it matches, 0 if it does not, or -1 if the automaton gave
+	 * up.
+	 *
+	 * Postcondition:
+	 *		end is the end of matching, if it matches
+	 *		the non empty segments of the matching rules are appended to caps,
+	 *		if it matches
+	 */
+	int run(const char* buf, size_t beg, size_t len, size_t& end,
+			std::vector<abnf_capture>& caps);
+	
+	private:
+	
+	/*
+	 * Thread configuration: address, auxiliary counters and a quadruplet for
+	 * every called rule, with its return address, index, repetition counter
+	 * and whether it matched characters since its last occurrence.
+	 */
+	typedef std::vector<int> config;
+	
+	/*
+	 * Closure leaf: thread waiting for a character, or completing the rule.
+	 */
+	class leaf
+	{
+		public:
+		
+		/*
+		 * Initialized leaf.
+		 */
+		leaf(int src, int t, const std::vector<int>& events):
+		src(src),
+		t(t),
+		events(events)
+		{
+		}
+		
+		int src;
+		int t;
+		std::vector<int> events;
+	};
+	
+	const abnf_program& _prog;
+	abnf_lock _lock;
+	bool _failed;
+	abnf_dfa_state* _start;
+	std::vector<abnf_dfa_state*> _states;
+	std::map<std::vector<int>, abnf_dfa_state*> _state_map;
+	std::vector<config> _threads;
+	std::map<config, int> _thread_map;
+	std::vector<abnf_charset> _cs;
+	std::vector<int> _next;
+	
+	/*
+	 * Index of the given thread configuration.
+	 */
+	int thread(const config& cf);
+	
+	/*
+	 * Index of the thread of the given configuration continuing at pc.
+	 */
+	int thread(config cf, int pc, int a = 0, int b = 0)
+	{
+		cf[0] = pc;
+		cf[1] = a;
+		cf[2] = b;
+		return thread(cf);
+	}
+	
+	/*
+	 * Appends to leaves those reached from thread t without reading, given
+	 * the next character c or -1 at the end of input.
+	 */
+	void closure(int src, int t, int c, std::vector<int>& events,
+			std::vector<bool>& seen, std::vector<leaf>& leaves);
+	
+	/*
+	 * Sets the characters read by thread t, and its thread after reading
+	 * them.
+	 */
+	void reading(int t);
+	
+	/*
+	 * Transition of state s by character c, or 256 for the end of input.
+	 *
+	 * Returns NULL if the automaton gives up.
+	 */
+	abnf_dfa_trans* trans_new(abnf_dfa_state* s, int c);
+};
+
+} // namespace xspider
+
+#endif // ABNFD_H
@@ -0,0 +1,509 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+
+#include "abnfd.h"
+#include "abnfp.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Counter of a character run after one more character, those beyond the
+ * minimum being all alike if there is no maximum.
+ */
+static int abnf_dfa_count(const abnf_instr& in, int count)
+{
+	return in.c == INT_MAX ? min(count + 1, in.b) : count + 1;
+}
+
+/*
+ * abnf_dfa_state implementation
+ */
+
+abnf_dfa_state::abnf_dfa_state(const vector<int>& threads):
+threads(threads)
+{
+	fill(trans, trans + 257, (abnf_dfa_trans*) NULL);
+}
+
+/*
+ * abnf_dfa implementation
+ */
+
+abnf_dfa::abnf_dfa(const abnf_program& prog, int r):
+_prog(prog),
+_failed(false)
+{
+	config cf(3, 0);
+	cf[0] = prog._r_pc[r];
+	cf.push_back(-1);
+	cf.push_back(r);
+	cf.push_back(0);
+	cf.push_back(0);
+	
+	vector<int> threads(1, thread(cf));
+	_start = new abnf_dfa_state(threads);
+	_states.push_back(_start);
+	_state_map[threads] = _start;
+}
+
+abnf_dfa::~abnf_dfa(void)
+{
+	vector<abnf_dfa_state*>::const_iterator it = _states.begin();
+	while (it not_eq _states.end())
+	{
+		for (int c = 0; c < 257; ++c)
+			delete (*it)->trans[c];
+		delete *it++;
+	}
+}
+
+int abnf_dfa::run(const char* buf, size_t beg, size_t len, size_t& end,
+		vector<abnf_capture>& caps)
+{
+	abnf_dfa_state* s = abnf_load(_start);
+	if (s == NULL)
+		return -1;
+	
+	vector<const abnf_dfa_state*> path;
+	const abnf_dfa_trans* m_trans = NULL;
+	size_t m_pos = 0;
+	for (size_t pos = beg; ; ++pos)
+	{
+		int c = pos < len ? (unsigned char) buf[pos] : 256;
+		const abnf_dfa_trans* t = abnf_load(s->trans[c]);
+		if (t == NULL and (t = trans_new(s, c)) == NULL)
+			return -1;
+		
+		// Later matches come from threads of higher priority
+		if (t->match >= 0)
+		{
+			m_trans = t;
+			m_pos = pos;
+		}
+		if (t->next == NULL)
+			break;
+		path.push_back(s);
+		s = t->next;
+	}
+	if (m_trans == NULL)
+		return 0;
+	
+	// Walk back the threads leading to the match
+	vector<const vector<int>*> ev_vect(m_pos - beg + 1);
+	ev_vect.back() = &m_trans->match_events;
+	int i = m_trans->match;
+	for (size_t pos = m_pos; pos > beg; --pos)
+	{
+		const abnf_dfa_trans* t = abnf_load(path[pos - 1 - beg]->trans[
+				(unsigned char) buf[pos - 1]]);
+		ev_vect[pos - 1 - beg] = &t->events[i];
+		i = t->parents[i];
+	}
+	
+	// Replay their events, as the program would do
+	vector<size_t> beg_vect(1, beg);
+	for (size_t pos = beg; pos <= m_pos; ++pos)
+	{
+		const vector<int>& ev = *ev_vect[pos - beg];
+		vector<int>::const_iterator it = ev.begin();
+		while (it not_eq ev.end())
+		{
+			int e = *it++;
+			if (e < 0)
+			{
+				beg_vect.push_back(pos);
+				continue;
+			}
+			size_t b = beg_vect.back();
+			if (e % 2 == 0)
+				beg_vect.pop_back();
+			if (pos > b and _prog._r_cap[e / 2])
+				caps.push_back(abnf_capture(e / 2, b, pos));
+		}
+	}
+	end = m_pos;
+	return 1;
+}
+
+int abnf_dfa::thread(const config& cf)
+{
+	map<config, int>::const_iterator it = _thread_map.find(cf);
+	if (it not_eq _thread_map.end())
+		return it->second;
+	
+	if (_threads.size() >= ABNF_DFA_THREAD_MAX)
+	{
+		_failed = true;
+		return 0;
+	}
+	_threads.push_back(cf);
+	_cs.push_back(abnf_charset());
+	_next.push_back(-1);
+	return _thread_map[cf] = _threads.size() - 1;
+}
+
+void abnf_dfa::closure(int src, int t, int c, vector<int>& events,
+		vector<bool>& seen, vector<leaf>& leaves)
+{
+	if (_failed)
+		return;
+	
+	// A thread reached again has lower priority, with the same future
+	if (seen.size() < _threads.size())
+		seen.resize(_threads.size(), false);
+	if (seen[t])
+		return;
+	seen[t] = true;
+	
+	const config cf = _threads[t];
+	const int pc = cf[0];
+	const size_t top = cf.size() - 4;
+	const abnf_instr& in = _prog._code[pc];
+	switch (in.op)
+	{
+		case ABNF_OP_FAIL:
+		break;
+		
+		case ABNF_OP_CHAR:
+		case ABNF_OP_RANGE:
+		case ABNF_OP_FN:
+		case ABNF_OP_CLASS:
+		case ABNF_OP_MORE:
+		case ABNF_OP_LESS:
+		leaves.push_back(leaf(src, t, events));
+		break;
+		
+		case ABNF_OP_STR:
+		if (not _prog._strs[in.a].empty())
+			leaves.push_back(leaf(src, t, events));
+		break;
+		
+		case ABNF_OP_EOF:
+		if (c < 0)
+			closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+		break;
+		
+		case ABNF_OP_CALL:
+		{
+			config cl(cf);
+			cl.push_back(pc + 1);
+			cl.push_back(in.b);
+			cl.push_back(0);
+			cl.push_back(0);
+			events.push_back(-1);
+			closure(src, thread(cl, in.a), c, events, seen, leaves);
+			events.pop_back();
+		}
+		break;
+		
+		case ABNF_OP_RET:
+		events.push_back(2 * cf[top + 1]);
+		if (top == 3)
+			leaves.push_back(leaf(src, -1, events));
+		else
+			closure(src, thread(config(cf.begin(), cf.begin() + top),
+					cf[top]), c, events, seen, leaves);
+		events.pop_back();
+		break;
+		
+		case ABNF_OP_CHOICE:
+		closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+		closure(src, thread(cf, in.a), c, events, seen, leaves);
+		break;
+		
+		case ABNF_OP_JMP:
+		closure(src, thread(cf, in.a), c, events, seen, leaves);
+		break;
+		
+		case ABNF_OP_REP:
+		{
+			int count = cf[top + 2];
+			if (count < in.a)
+				closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+			else if (count >= in.b)
+				closure(src, thread(cf, pc + 3), c, events, seen, leaves);
+			else if (in.c == ABNF_REPET_LAZY)
+			{
+				closure(src, thread(cf, pc + 3), c, events, seen, leaves);
+				closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+			}
+			else
+			{
+				closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+				closure(src, thread(cf, pc + 3), c, events, seen, leaves);
+			}
+		}
+		break;
+		
+		case ABNF_OP_LOOP:
+		{
+			const abnf_instr& rep = _prog._code[in.a];
+			int count = cf[top + 2];
+			if (not cf[top + 3] and count >= rep.a)
+				break;
+			
+			// Counters beyond the minimum are all alike if there is no maximum
+			config cl(cf);
+			cl[top + 2] = rep.b == INT_MAX ? min(count + 1, rep.a) : count + 1;
+			cl[top + 3] = 0;
+			closure(src, thread(cl, in.a), c, events, seen, leaves);
+		}
+		break;
+		
+		case ABNF_OP_CUT:
+		
+		// Dropping the backtracking points of the matched rule keeps its
+		// first match, which is the one of the first completing thread
+		if (top == 3)
+			closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+		else
+			_failed = true;
+		break;
+		
+		case ABNF_OP_TEST:
+		if (c >= 0 and _prog._classes[in.a].test(c))
+			closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+		else
+			closure(src, thread(cf, in.b), c, events, seen, leaves);
+		break;
+		
+		case ABNF_OP_CAP:
+		events.push_back(2 * in.a + 1);
+		closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+		events.pop_back();
+		break;
+		
+		case ABNF_OP_TRIE:
+		if (cf[1] > 0)
+			leaves.push_back(leaf(src, t, events));
+		else
+		{
+			const abnf_trie& trie = _prog._tries[in.a];
+			for (size_t i = 0; i < trie.size(); ++i)
+				if (trie.length(i) > 0)
+					closure(src, thread(cf, pc, i + 1), c, events, seen,
+							leaves);
+		}
+		break;
+		
+		case ABNF_OP_RUN:
+		if (cf[1] < in.b)
+			leaves.push_back(leaf(src, t, events));
+		else
+		{
+			closure(src, thread(cf, pc + 2), c, events, seen, leaves);
+			if (cf[1] < in.c)
+				closure(src, thread(cf, pc + 1, cf[1]), c, events, seen,
+						leaves);
+		}
+		break;
+		
+		case ABNF_OP_SPAN:
+		if (_prog._code[pc + 1].op == ABNF_OP_LESS)
+		{
+			if (cf[1] < in.c)
+				closure(src, thread(cf, pc + 1, cf[1]), c, events, seen,
+						leaves);
+			if (cf[1] >= in.b)
+				closure(src, thread(cf, pc + 2), c, events, seen, leaves);
+		}
+		else if (cf[2])
+			leaves.push_back(leaf(src, t, events));
+		
+		// Possessive runs read every character they can
+		else if (c >= 0 and cf[1] < in.c and _prog._classes[in.a].test(c))
+			closure(src, thread(cf, pc, cf[1], 1), c, events, seen, leaves);
+		else if (cf[1] >= in.b)
+			closure(src, thread(cf, pc + 1), c, events, seen, leaves);
+		break;
+	}
+}
+
+void abnf_dfa::reading(int t)
+{
+	if (_next[t] >= 0)
+		return;
+	
+	config cf = _threads[t];
+	int pc = cf[0], a = 0, b = 0;
+	const abnf_instr& in = _prog._code[pc];
+	abnf_charset cs;
+	switch (in.op)
+	{
+		case ABNF_OP_CHAR:
+		if (in.a < 256)
+			cs.set(in.a);
+		++pc;
+		break;
+		
+		case ABNF_OP_RANGE:
+		for (int c = in.a; c <= in.b and c < 256; ++c)
+			cs.set(c);
+		++pc;
+		break;
+		
+		case ABNF_OP_FN:
+		for (int c = 0; c < 256; ++c)
+			if (_prog._fns[in.a](c) > 0)
+				cs.set(c);
+		++pc;
+		break;
+		
+		case ABNF_OP_CLASS:
+		cs = _prog._classes[in.a];
+		++pc;
+		break;
+		
+		case ABNF_OP_STR:
+		{
+			const string& str = _prog._strs[in.a];
+			size_t pos = cf[1];
+			for (int c = 0; c < 256; ++c)
+				if (tolower(c) == tolower((unsigned char) str[pos]))
+					cs.set(c);
+			if (pos + 1 < str.size())
+				a = pos + 1;
+			else
+				++pc;
+		}
+		break;
+		
+		case ABNF_OP_TRIE:
+		{
+			const string& str = _prog._tries[in.a].str(cf[1] - 1);
+			size_t pos = cf[2];
+			for (int c = 0; c < 256; ++c)
+				if (tolower(c) == (unsigned char) str[pos])
+					cs.set(c);
+			if (pos + 1 < str.size())
+			{
+				a = cf[1];
+				b = pos + 1;
+			}
+			else
+				pc += cf[1];
+		}
+		break;
+		
+		case ABNF_OP_RUN:
+		cs = _prog._classes[in.a];
+		a = cf[1] + 1;
+		break;
+		
+		case ABNF_OP_MORE:
+		case ABNF_OP_LESS:
+		{
+			const abnf_instr& run = _prog._code[--pc];
+			cs = _prog._classes[run.a];
+			a = abnf_dfa_count(run, cf[1]);
+		}
+		break;
+		
+		case ABNF_OP_SPAN:
+		cs = _prog._classes[in.a];
+		a = abnf_dfa_count(in, cf[1]);
+		break;
+		
+		default:
+		break;
+	}
+	
+	// Repeated rules remember that their occurrence is not empty
+	for (size_t f = 3; f < cf.size(); f += 4)
+		if (_prog._code[_prog._r_pc[cf[f + 1]]].op == ABNF_OP_REP)
+			cf[f + 3] = 1;
+	
+	int n = thread(cf, pc, a, b);
+	_cs[t] = cs;
+	_next[t] = n;
+}
+
+abnf_dfa_trans* abnf_dfa::trans_new(abnf_dfa_state* s, int c)
+{
+	_lock.acquire();
+	abnf_dfa_trans* t = s->trans[c];
+	if (t == NULL and not _failed)
+	{
+		int la = c < 256 ? c : -1;
+		vector<int> events;
+		vector<bool> seen;
+		vector<leaf> leaves;
+		for (size_t i = 0; i < s->threads.size(); ++i)
+			closure(i, s->threads[i], la, events, seen, leaves);
+		
+		// Threads after the first completing one are never needed
+		t = new abnf_dfa_trans();
+		vector<int> threads;
+		vector<leaf>::const_iterator it = leaves.begin();
+		while (not _failed and it not_eq leaves.end())
+		{
+			const leaf& l = *it++;
+			if (l.t < 0)
+			{
+				t->match = l.src;
+				t->match_events = l.events;
+				break;
+			}
+			if (la < 0)
+				continue;
+			
+			reading(l.t);
+			int n = _next[l.t];
+			if (not _cs[l.t].test(la) or
+					find(threads.begin(), threads.end(), n) not_eq threads.end())
+				continue;
+			threads.push_back(n);
+			t->parents.push_back(l.src);
+			t->events.push_back(l.events);
+		}
+		
+		if (not _failed and not threads.empty())
+		{
+			map<vector<int>, abnf_dfa_state*>::const_iterator st =
+					_state_map.find(threads);
+			if (st not_eq _state_map.end())
+				t->next = st->second;
+			else if (_states.size() < ABNF_DFA_STATE_MAX)
+			{
+				t->next = new abnf_dfa_state(threads);
+				_states.push_back(t->next);
+				_state_map[threads] = t->next;
+			}
+			else
+				_failed = true;
+		}
+		
+		if (_failed)
+		{
+			delete t;
+			t = NULL;
+			abnf_store(_start, (abnf_dfa_state*) NULL);
+		}
+		else
+			abnf_store(s->trans[c], t);
+	}
+	_lock.release();
+	return t;
+}
@@ -19,6 +19,7 @@
  */
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -67,12 +68,17 @@ public abnf_rule_ri
 	{
 	}
 	
+	/*
+	 * Not a single character.
+	 */
+	bool charset(abnf_charset& cs);
+	
 	protected:
 	
 	/*
 	 * Creates an EOF matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done
@@ -82,13 +88,23 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 };
 
 } // namespace xspider
@@ -102,7 +118,12 @@ using namespace xspider;
  
 abnf_rule& abnf_ruleset::eof(void)
 {
-	return **_r_set.insert(new abnf_rule_eof(*this)).first;
+	abnf_rule*& r = cons(abnf_rule_key(ABNF_RULE_EOF));
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	r = store(new (*this) abnf_rule_eof(*this));
+	return *r;
 }
 
 /*
@@ -124,21 +145,40 @@ bool abnf_matcher_eof::match_impl(istream& is)
  * abnf_rule_eof implementation
  */
 
-abnf_matcher* abnf_rule_eof::matcher_new(void)
+abnf_matcher* abnf_rule_eof::matcher_new_impl(void)
 {
-	return new abnf_matcher_eof(*this);
+	return new (arena()) abnf_matcher_eof(*this);
+}
+
+bool abnf_rule_eof::charset(abnf_charset& cs)
+{
+	return false;
 }
 
 void abnf_rule_eof::clear_impl(void)
 {
 }
 
-void abnf_rule_eof::stream_update_impl(std::istream& is)
+void abnf_rule_eof::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_eof::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_eof(rset);
+	return new (rset) abnf_rule_eof(rset);
+}
+
+int abnf_rule_eof::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_EOF);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_eof::first_impl(abnf_charset& cs)
+{
+	return true;
 }
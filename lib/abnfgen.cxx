@@ -0,0 +1,508 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <sstream>
+
+#include "abnfp.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Upper case identifier made of the given string.
+ */
+static string abnf_gen_id(const string& str)
+{
+	string id = str;
+	for (size_t i = 0; i < id.size(); ++i)
+		id[i] = isalnum((unsigned char) id[i]) ? toupper(id[i]) : '_';
+	return id;
+}
+
+/*
+ * Name of the given rule, or a description if it has none.
+ */
+static string abnf_gen_name(const map<string, abnf_rule_ri*>& names,
+		const abnf_rule_ri* r)
+{
+	map<string, abnf_rule_ri*>::const_iterator it = names.begin();
+	while (it not_eq names.end())
+		if (it++->second == r)
+			return "\"" + (--it)->first + "\"";
+	return "unnamed";
+}
+
+/*
+ * Writes the bit table of the given character set.
+ */
+static void abnf_gen_class(ostream& os, const string& id,
+		const abnf_charset& cs)
+{
+	os << "static const unsigned char " << id << "[32] =\n{";
+	for (int i = 0; i < 32; ++i)
+	{
+		int bits = 0;
+		for (int b = 0; b < 8; ++b)
+			if (cs.test(i * 8 + b))
+				bits |= 1 << b;
+		os << (i % 8 == 0 ? "\n\t" : " ") << bits << (i < 31 ? "," : "");
+	}
+	os << "\n};\n\n";
+}
+
+/*
+ * Writes the given string, in lower case, as an array of characters.
+ */
+static void abnf_gen_string(ostream& os, const string& id, const string& str)
+{
+	os << "static const unsigned char " << id << "[] =\n{\n\t";
+	for (size_t i = 0; i < str.size(); ++i)
+		os << tolower((unsigned char) str[i]) << ", ";
+	os << "0\n};\n\n";
+}
+
+/*
+ * abnf_ruleset implementation
+ */
+
+void abnf_ruleset::generate(const abnf_rule& r, const char* name,
+		ostream& hs, ostream& cs) const
+{
+	owner_test(*this, r);
+	
+	abnf_program prog;
+	int id = prog.entry(abnf_rule_ri::cast(const_cast<abnf_rule&>(r)));
+	
+	map<string, abnf_rule_ri*> names;
+	map<string, abnf_rule*>::const_iterator it = _r_map.begin();
+	while (it not_eq _r_map.end())
+	{
+		names[it->first] = &abnf_rule_ri::cast(*it->second);
+		++it;
+	}
+	prog.generate(id, names, name, hs, cs);
+}
+
+/*
+ * abnf_program implementation
+ */
+
+void abnf_program::generate(int r, const map<string, abnf_rule_ri*>& names,
+		const string& name, ostream& hs, ostream& cs) const
+{
+	const string id = abnf_gen_id(name);
+	
+	// Named rules of the program, those with many names sharing their value
+	vector<int> named(_rules.size(), -1);
+	vector<int> named_rules;
+	hs << "/*\n * Parser of the " << abnf_gen_name(names, _rules[r]) <<
+			" rule, generated by abnf_ruleset::generate.\n */\n\n";
+	hs << "#ifndef " << id << "_H\n#define " << id << "_H\n\n";
+	hs << "#include <cstddef>\n\n#include \"abnfgen.h\"\n\n";
+	hs << "namespace xspider {\n\n";
+	hs << "/*!\n * \\brief Named rules matched by " << name << "_read.\n */\n";
+	hs << "enum " << name << "_rule\n{";
+	map<string, abnf_rule_ri*>::const_iterator n_it = names.begin();
+	bool first = true;
+	while (n_it not_eq names.end())
+	{
+		map<const abnf_rule_ri*, int>::const_iterator it =
+				_r_map.find(n_it->second);
+		if (it not_eq _r_map.end())
+		{
+			if (named[it->second] < 0)
+			{
+				named[it->second] = named_rules.size();
+				named_rules.push_back(it->second);
+			}
+			hs << (first ? "\n\t" : ",\n\t") << id << "_" <<
+					abnf_gen_id(n_it->first) << " = " << named[it->second];
+			first = false;
+		}
+		++n_it;
+	}
+	hs << "\n};\n\n";
+	hs << "/*!\n * \\brief Matches the " << abnf_gen_name(names, _rules[r]) <<
+			" rule against the len characters of buf.\n *\n" <<
+			" * \\return\n" <<
+			" *\t\t\t1 if it matches, 0 if it does not, or -1 if it exceeds" <<
+			" the\n *\t\t\tlimits of generated parsers.\n */\n";
+	hs << "int " << name << "_read(const char* buf, size_t len, " <<
+			"abnf_gen_result& res);\n\n";
+	hs << "} // namespace xspider\n\n#endif // " << id << "_H\n";
+	
+	cs << "/*\n * Parser of the " << abnf_gen_name(names, _rules[r]) <<
+			" rule, generated by abnf_ruleset::generate.\n */\n\n";
+	cs << "#include \"" << name << ".h\"\n\n";
+	cs << "using namespace xspider;\n\n";
+	
+	// Character sets, functions being turned to character sets as well
+	for (size_t i = 0; i < _classes.size(); ++i)
+	{
+		ostringstream oss;
+		oss << name << "_class_" << i;
+		abnf_gen_class(cs, oss.str(), _classes[i]);
+	}
+	for (size_t i = 0; i < _fns.size(); ++i)
+	{
+		abnf_charset fn_cs;
+		for (int c = 0; c < 256; ++c)
+			if (_fns[i](c) > 0)
+				fn_cs.set(c);
+		ostringstream oss;
+		oss << name << "_fn_" << i;
+		abnf_gen_class(cs, oss.str(), fn_cs);
+	}
+	for (size_t i = 0; i < _strs.size(); ++i)
+	{
+		ostringstream oss;
+		oss << name << "_str_" << i;
+		abnf_gen_string(cs, oss.str(), _strs[i]);
+	}
+	for (size_t i = 0; i < _tries.size(); ++i)
+	{
+		const abnf_trie& trie = _tries[i];
+		for (size_t j = 0; j < trie.size(); ++j)
+		{
+			ostringstream oss;
+			oss << name << "_trie_" << i << "_" << j;
+			abnf_gen_string(cs, oss.str(), trie.str(j));
+		}
+		cs << "static const unsigned char* const " << name << "_trie_" << i <<
+				"[] =\n{";
+		for (size_t j = 0; j < trie.size(); ++j)
+			cs << "\n\t" << name << "_trie_" << i << "_" << j <<
+					(j + 1 < trie.size() ? "," : "");
+		cs << "\n};\n\n";
+		cs << "static const size_t " << name << "_trie_" << i <<
+				"_len[] =\n{\n\t";
+		for (size_t j = 0; j < trie.size(); ++j)
+			cs << trie.length(j) << (j + 1 < trie.size() ? ", " : "");
+		cs << "\n};\n\n";
+	}
+	
+	// Segments of named rules, those of fused rules being split by character
+	cs << "/*\n * Stores the beg,end segment of the rule with index r, if it" <<
+			" is named or its\n * characters are.\n */\n";
+	cs << "static bool " << name << "_capture(abnf_gen_result& res, " <<
+			"const char* buf, int r,\n\t\tsize_t beg, size_t end)\n{\n";
+	cs << "\tswitch (r)\n\t{\n";
+	abnf_result res;
+	for (size_t i = 0; i < _rules.size(); ++i)
+	{
+		vector<vector<int> > fused(256);
+		size_t fused_max = 0;
+		for (int c = 0; c < 256; ++c)
+		{
+			char ch = c;
+			res.clear();
+			_rules[i]->fused_segment_add(res, &ch, 0, 1);
+			for (size_t j = 0; j < named_rules.size(); ++j)
+			{
+				size_t n = res.read_count(*_rules[named_rules[j]]);
+				if (named_rules[j] == (int) i and n > 0)
+					--n;
+				fused[c].insert(fused[c].end(), n, j);
+			}
+			fused_max = max(fused_max, fused[c].size());
+		}
+		if (named[i] < 0 and fused_max == 0)
+			continue;
+		
+		cs << "\t\tcase " << i << ":\n";
+		if (named[i] >= 0)
+			cs << "\t\tif (not res.segment_add(" << named[i] <<
+					", beg, end))\n\t\t\treturn false;\n";
+		if (fused_max > 0)
+		{
+			cs << "\t\t{\n\t\t\tstatic const short fused[256][" <<
+					fused_max << "] =\n\t\t\t{";
+			for (int c = 0; c < 256; ++c)
+			{
+				cs << "\n\t\t\t\t{ ";
+				for (size_t j = 0; j < fused_max; ++j)
+					cs << (j < fused[c].size() ? fused[c][j] : -1) <<
+							(j + 1 < fused_max ? ", " : " ");
+				cs << (c < 255 ? "}," : "}");
+			}
+			cs << "\n\t\t\t};\n";
+			cs << "\t\t\tfor (size_t pos = beg; pos < end; ++pos)\n";
+			cs << "\t\t\t\tfor (size_t j = 0; j < " << fused_max << "; ++j)\n";
+			cs << "\t\t\t\t{\n";
+			cs << "\t\t\t\t\tint n = fused[(unsigned char) buf[pos]][j];\n";
+			cs << "\t\t\t\t\tif (n >= 0 and not res.segment_add(n, pos, " <<
+					"pos + 1))\n\t\t\t\t\t\treturn false;\n";
+			cs << "\t\t\t\t}\n\t\t}\n";
+		}
+		cs << "\t\tbreak;\n\t\t\n";
+	}
+	cs << "\t\tdefault:\n\t\tbreak;\n\t}\n\treturn true;\n}\n\n";
+	
+	// Addresses continued at by jumps, and by returns or backtracking
+	set<int> labels, cases;
+	labels.insert(_r_pc[r]);
+	for (int pc = 0; pc < (int) _code.size(); ++pc)
+	{
+		const abnf_instr& in = _code[pc];
+		switch (in.op)
+		{
+			case ABNF_OP_CALL:
+			labels.insert(in.a);
+			cases.insert(pc + 1);
+			break;
+			
+			case ABNF_OP_CHOICE:
+			cases.insert(in.a);
+			break;
+			
+			case ABNF_OP_JMP:
+			case ABNF_OP_LOOP:
+			labels.insert(in.a);
+			break;
+			
+			case ABNF_OP_REP:
+			labels.insert(pc + 3);
+			cases.insert(in.c == ABNF_REPET_LAZY ? pc + 1 : pc + 3);
+			break;
+			
+			case ABNF_OP_RUN:
+			labels.insert(pc + 2);
+			cases.insert(pc + 1);
+			break;
+			
+			case ABNF_OP_MORE:
+			case ABNF_OP_LESS:
+			cases.insert(pc);
+			break;
+			
+			case ABNF_OP_TEST:
+			labels.insert(in.b);
+			break;
+			
+			case ABNF_OP_TRIE:
+			for (size_t i = 0; i < _tries[in.a].size(); ++i)
+				cases.insert(pc + 1 + i);
+			break;
+			
+			default:
+			break;
+		}
+	}
+	labels.insert(cases.begin(), cases.end());
+	
+	cs << "int xspider::" << name << "_read(const char* buf, size_t len, " <<
+			"abnf_gen_result& res)\n{\n";
+	cs << "\tabnf_gen_frame f_vect[ABNF_GEN_STACK_MAX];\n";
+	cs << "\tabnf_gen_choice ch_vect[ABNF_GEN_STACK_MAX];\n";
+	cs << "\tsize_t f_count = 1, ch_count = 0, pos = 0;\n";
+	cs << "\tint f = 0, pc;\n\t\n";
+	cs << "\tres.start(buf);\n";
+	cs << "\tf_vect[0] = abnf_gen_frame(-1, -1, " << r << ", 0, 0, 0, 0);\n";
+	cs << "\tgoto L" << _r_pc[r] << ";\n\t\n";
+	cs << "\tdispatch:\n\tswitch (pc)\n\t{\n";
+	for (set<int>::const_iterator it = cases.begin(); it not_eq cases.end();
+			++it)
+		cs << "\t\tcase " << *it << ":\n\t\tgoto L" << *it << ";\n\t\t\n";
+	cs << "\t\tdefault:\n\t\tbreak;\n\t}\n\t\n";
+	cs << "\tfail:\n";
+	cs << "\tif (ch_count == 0)\n\t{\n\t\tres.start(buf);\n\t\treturn 0;\n\t}\n";
+	cs << "\t{\n\t\tconst abnf_gen_choice& ch = ch_vect[--ch_count];\n";
+	cs << "\t\tpc = ch.pc;\n\t\tpos = ch.pos;\n\t\tf = ch.f;\n";
+	cs << "\t\tf_count = ch.f_count;\n\t\tres.resize(ch.seg_count);\n\t}\n";
+	cs << "\tgoto dispatch;\n";
+	
+	const char* choice = "if (ch_count == ABNF_GEN_STACK_MAX)\n"
+			"\t\treturn -1;\n\tch_vect[ch_count++] = abnf_gen_choice(";
+	const char* choice_end = ", f, f_count,\n\t\t\tres.size());\n";
+	for (int pc = 0; pc < (int) _code.size(); ++pc)
+	{
+		const abnf_instr& in = _code[pc];
+		if (labels.count(pc))
+			cs << "\t\n\tL" << pc << ":\n";
+		switch (in.op)
+		{
+			case ABNF_OP_FAIL:
+			cs << "\tgoto fail;\n";
+			break;
+			
+			case ABNF_OP_CHAR:
+			cs << "\tif (pos == len or (unsigned char) buf[pos] not_eq " <<
+					in.a << ")\n\t\tgoto fail;\n\t++pos;\n";
+			break;
+			
+			case ABNF_OP_RANGE:
+			cs << "\tif (pos == len or (unsigned char) buf[pos] < " << in.a <<
+					" or\n\t\t\t(unsigned char) buf[pos] > " << in.b <<
+					")\n\t\tgoto fail;\n\t++pos;\n";
+			break;
+			
+			case ABNF_OP_FN:
+			case ABNF_OP_CLASS:
+			cs << "\tif (pos == len or not abnf_gen_test(" << name <<
+					(in.op == ABNF_OP_FN ? "_fn_" : "_class_") << in.a <<
+					", buf[pos]))\n\t\tgoto fail;\n\t++pos;\n";
+			break;
+			
+			case ABNF_OP_STR:
+			{
+				size_t n = _strs[in.a].size();
+				if (n == 0)
+					cs << "\tgoto fail;\n";
+				else
+					cs << "\tif (len - pos < " << n << " or not abnf_gen_equal(" <<
+							name << "_str_" << in.a << ", buf + pos, " << n <<
+							"))\n\t\tgoto fail;\n\tpos += " << n << ";\n";
+			}
+			break;
+			
+			case ABNF_OP_EOF:
+			cs << "\tif (pos < len)\n\t\tgoto fail;\n";
+			break;
+			
+			case ABNF_OP_CALL:
+			cs << "\tif (f_count == ABNF_GEN_STACK_MAX)\n\t\treturn -1;\n";
+			cs << "\tf_vect[f_count] = abnf_gen_frame(f, " << pc + 1 << ", " <<
+					in.b << ", pos, 0, pos, ch_count);\n";
+			cs << "\tf = f_count++;\n\tgoto L" << in.a << ";\n";
+			break;
+			
+			case ABNF_OP_RET:
+			cs << "\t{\n\t\tconst abnf_gen_frame& fr = f_vect[f];\n";
+			cs << "\t\tif (pos > fr.beg and not " << name <<
+					"_capture(res, buf, fr.r, fr.beg, pos))\n" <<
+					"\t\t\treturn -1;\n";
+			cs << "\t\tif (fr.parent < 0)\n\t\t{\n\t\t\tres.finish(pos);\n" <<
+					"\t\t\treturn 1;\n\t\t}\n";
+			cs << "\t\tpc = fr.ret;\n\t\tint parent = fr.parent;\n";
+			cs << "\t\tif ((size_t) f == f_count - 1 and (ch_count == 0 or\n" <<
+					"\t\t\t\tch_vect[ch_count - 1].f_count <= (size_t) f))\n" <<
+					"\t\t\t--f_count;\n";
+			cs << "\t\tf = parent;\n\t}\n\tgoto dispatch;\n";
+			break;
+			
+			case ABNF_OP_CHOICE:
+			cs << "\t" << choice << in.a << ", pos" << choice_end;
+			break;
+			
+			case ABNF_OP_JMP:
+			cs << "\tgoto L" << in.a << ";\n";
+			break;
+			
+			case ABNF_OP_REP:
+			cs << "\tif (f_vect[f].count >= " << in.a << ")\n\t{\n";
+			cs << "\t\tif (f_vect[f].count >= " << in.b << ")\n\t\t\tgoto L" <<
+					pc + 3 << ";\n";
+			cs << "\t\t" << choice << (in.c == ABNF_REPET_LAZY ? pc + 1 :
+					pc + 3) << ", pos" << choice_end;
+			if (in.c == ABNF_REPET_LAZY)
+				cs << "\t\tgoto L" << pc + 3 << ";\n";
+			cs << "\t}\n";
+			break;
+			
+			case ABNF_OP_LOOP:
+			cs << "\t{\n\t\tabnf_gen_frame fr = f_vect[f];\n";
+			cs << "\t\tif (pos == fr.iter and fr.count >= " << _code[in.a].a <<
+					")\n\t\t\tgoto fail;\n";
+			cs << "\t\t++fr.count;\n\t\tfr.iter = pos;\n";
+			cs << "\t\tif ((size_t) f == f_count - 1 and (ch_count == 0 or\n" <<
+					"\t\t\t\tch_vect[ch_count - 1].f_count <= (size_t) f))\n" <<
+					"\t\t\tf_vect[f] = fr;\n";
+			cs << "\t\telse if (f_count == ABNF_GEN_STACK_MAX)\n" <<
+					"\t\t\treturn -1;\n";
+			cs << "\t\telse\n\t\t{\n\t\t\tf_vect[f_count] = fr;\n" <<
+					"\t\t\tf = f_count++;\n\t\t}\n\t}\n";
+			cs << "\tgoto L" << in.a << ";\n";
+			break;
+			
+			case ABNF_OP_RUN:
+			case ABNF_OP_SPAN:
+			cs << "\t{\n\t\tsize_t max = len - pos < " << in.c << "u ? len - pos : " <<
+					in.c << "u;\n";
+			cs << "\t\tsize_t n = abnf_gen_span(" << name << "_class_" << in.a <<
+					", buf + pos, max);\n";
+			cs << "\t\tif (n < " << in.b << ")\n\t\t\tgoto fail;\n";
+			if (in.op == ABNF_OP_SPAN)
+				cs << "\t\tpos += n;\n\t}\n";
+			else
+			{
+				cs << "\t\tf_vect[f].iter = pos + n;\n\t\tpos += " << in.b <<
+						";\n";
+				cs << "\t\tif (pos < f_vect[f].iter)\n\t\t{\n\t\t\t" <<
+						choice << pc + 1 << ", pos" << choice_end;
+				cs << "\t\t}\n\t}\n\tgoto L" << pc + 2 << ";\n";
+			}
+			break;
+			
+			case ABNF_OP_MORE:
+			cs << "\t++pos;\n\tif (pos < f_vect[f].iter)\n\t{\n\t\t" << choice <<
+					pc << ", pos" << choice_end << "\t}\n";
+			break;
+			
+			case ABNF_OP_LESS:
+			cs << "\tif (pos > f_vect[f].beg + " << in.a << ")\n\t{\n\t\t" <<
+					choice << pc << ", pos - 1" << choice_end << "\t}\n";
+			break;
+			
+			case ABNF_OP_CUT:
+			cs << "\tch_count = f_vect[f].cut;\n";
+			break;
+			
+			case ABNF_OP_TEST:
+			cs << "\tif (pos == len or not abnf_gen_test(" << name << "_class_" <<
+					in.a << ", buf[pos]))\n\t\tgoto L" << in.b << ";\n";
+			break;
+			
+			case ABNF_OP_CAP:
+			cs << "\tif (pos > f_vect[f].beg and not " << name <<
+					"_capture(res, buf, " << in.a << ",\n" <<
+					"\t\t\tf_vect[f].beg, pos))\n\t\treturn -1;\n";
+			break;
+			
+			case ABNF_OP_TRIE:
+			{
+				ostringstream oss;
+				oss << name << "_trie_" << in.a;
+				const string t = oss.str();
+				cs << "\t{\n\t\tint first = -1;\n";
+				cs << "\t\tfor (int i = " << _tries[in.a].size() - 1 <<
+						"; i >= 0; --i)\n";
+				cs << "\t\t\tif (" << t << "_len[i] > 0 and len - pos >= " << t <<
+						"_len[i] and\n\t\t\t\t\tabnf_gen_equal(" << t << "[i], " <<
+						"buf + pos, " << t << "_len[i]))\n\t\t\t{\n";
+				cs << "\t\t\t\tif (first >= 0)\n\t\t\t\t{\n\t\t\t\t\t" <<
+						"if (ch_count == ABNF_GEN_STACK_MAX)\n" <<
+						"\t\t\t\t\t\treturn -1;\n" <<
+						"\t\t\t\t\tch_vect[ch_count++] = abnf_gen_choice(" <<
+						pc + 1 << " + first,\n\t\t\t\t\t\t\tpos + " << t <<
+						"_len[first], f, f_count, res.size());\n\t\t\t\t}\n";
+				cs << "\t\t\t\tfirst = i;\n\t\t\t}\n";
+				cs << "\t\tif (first < 0)\n\t\t\tgoto fail;\n";
+				cs << "\t\tpos += " << t << "_len[first];\n";
+				cs << "\t\tpc = " << pc + 1 << " + first;\n\t}\n";
+				cs << "\tgoto dispatch;\n";
+			}
+			break;
+		}
+	}
+	cs << "}\n";
+}
@@ -0,0 +1,343 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef ABNFJ_H
+#define ABNFJ_H
+
+#include <cstddef>
+#include <vector>
+
+#include "abnfp.h"
+
+/*
+ * Native code is emitted for x86-64 processors, with the System V calling
+ * convention and executable memory mapped through mmap.
+ */
+#if defined(__x86_64__) and defined(__unix__)
+#define ABNF_JIT
+#endif
+
+/*
+ * Initial capacities of the stacks of native code runs, held by the run state
+ * itself. They grow on demand.
+ */
+#define ABNF_JIT_FRAME_MIN 64
+#define ABNF_JIT_CHOICE_MIN 64
+#define ABNF_JIT_CAPTURE_MIN 256
+
+namespace xspider {
+
+class abnf_jit;
+class abnf_jit_capture;
+class abnf_jit_choice;
+
+/*
+ * Native code address where a program continues, and its input position.
+ * Returned by helper functions in two registers.
+ */
+class abnf_jit_next
+{
+	public:
+	
+	const void* addr;
+	size_t pos;
+};
+
+/*
+ * Rule call of a native code run, as abnf_frame, with pointers instead of
+ * indexes. Native code accesses its fields by offset.
+ */
+class abnf_jit_frame
+{
+	public:
+	
+	abnf_jit_frame* parent;
+	const void* ret;
+	size_t r;
+	size_t beg;
+	size_t count;
+	size_t iter;
+	abnf_jit_choice* cut;
+};
+
+/*
+ * Backtracking point of a native code run, as abnf_choice, holding the tops
+ * of the frame and capture stacks to restore.
+ */
+class abnf_jit_choice
+{
+	public:
+	
+	const void* addr;
+	size_t pos;
+	abnf_jit_frame* f;
+	abnf_jit_frame* f_top;
+	abnf_jit_capture* cap_top;
+};
+
+/*
+ * Capture of a native code run.
+ */
+class abnf_jit_capture
+{
+	public:
+	
+	size_t r;
+	size_t beg;
+	size_t end;
+};
+
+/*
+ * State of a native code run: the input and the stacks, each one as its base,
+ * top and end. The stacks are first the arrays held by the state, and they
+ * are moved to the heap when growing. Native code accesses its fields by
+ * offset.
+ */
+class abnf_jit_state
+{
+	public:
+	
+	abnf_jit_frame* f;
+	abnf_jit_frame* f_beg;
+	abnf_jit_frame* f_top;
+	abnf_jit_frame* f_end;
+	abnf_jit_choice* ch_beg;
+	abnf_jit_choice* ch_top;
+	abnf_jit_choice* ch_end;
+	abnf_jit_capture* cap_beg;
+	abnf_jit_capture* cap_top;
+	abnf_jit_capture* cap_end;
+	size_t end;
+	const abnf_jit* jit;
+	const char* buf;
+	size_t len;
+	abnf_jit_frame f_arr[ABNF_JIT_FRAME_MIN];
+	abnf_jit_choice ch_arr[ABNF_JIT_CHOICE_MIN];
+	abnf_jit_capture cap_arr[ABNF_JIT_CAPTURE_MIN];
+};
+
+/*
+ * Program translated to native code.
+ *
+ * Instructions are emitted inline: character sets as bit tests against tables
+ * following the code, SPAN and RUN as scanning loops, and the instructions
+ * handling frames, backtracking points and captures as pushes and pops on the
+ * stacks of the state. The stacks grow through a helper function, which moves
+ * them and redoes the instruction. FN, TRIE and the calls of possessive
+ * repetitions call helper functions doing what the interpreter does. Helpers
+ * return the native address where to continue, as the backtracking points
+ * hold. Failures jump to common code which backtracks.
+ *
+ * While running, the buffer, position, length, state and current frame are
+ * kept in the rbx, r12, r13, r14 and r15 registers.
+ */
+class abnf_jit
+{
+	public:
+	
+	/*
+	 * Translates the given program. If the translation is not supported, or
+	 * executable memory can not be allocated, there is no native code.
+	 */
+	abnf_jit(const abnf_program& prog);
+	
+	/*
+	 * Release the native code.
+	 */
+	~abnf_jit(void);
+	
+	/*
+	 * Matches the rule with index r against the len characters of buf.
+	 *
+	 * Returns 1 if it matches, 0 if it does not, or -1 if there is no native
+	 * code or it gave up because a called function threw an exception or
+	 * memory could not be allocated.
+	 *
+	 * Postcondition:
+	 *		end is the matching length, if it matches
+	 *		caps contains the non empty segments of the matching rules, if it
+	 *		matches
+	 */
+	int run(int r, const char* buf, size_t len, size_t& end,
+			std::vector<abnf_capture>& caps) const;
+	
+	private:
+	
+	const abnf_program& _prog;
+	unsigned char* _code;
+	size_t _size;
+	std::vector<const unsigned char*> _addr;
+	std::vector<const unsigned char*> _calls;
+	const unsigned char* _fail;
+	const unsigned char* _abort;
+	
+	/*
+	 * Code being emitted, offsets of its common code and of the calls of the
+	 * instructions calling possessive repetitions, references to instructions,
+	 * common code and tables to be resolved, and character sets of the tables.
+	 */
+	std::vector<unsigned char> _emit;
+	std::vector<size_t> _stubs;
+	std::vector<size_t> _call_offs;
+	std::vector<std::pair<size_t, int> > _pc_refs;
+	std::vector<std::pair<size_t, int> > _table_refs;
+	std::vector<abnf_charset> _tables;
+	
+	/*
+	 * Emits the native code of the instruction at pc.
+	 */
+	void emit_instr(int pc);
+	
+	/*
+	 * Emits the given bytes.
+	 */
+	void emit(const char* bytes, size_t n);
+	
+	/*
+	 * Emits a 32 bit value.
+	 */
+	void emit32(int v);
+	
+	/*
+	 * Emits a 64 bit value.
+	 */
+	void emit64(size_t v);
+	
+	/*
+	 * Emits an instruction with the given opcode bytes, a 64 bit operand size
+	 * and a memory operand at base plus disp, being reg its register operand
+	 * or opcode extension.
+	 */
+	void emit_mem(const char* op, size_t n, int reg, int base, int disp);
+	
+	/*
+	 * Emits an instruction with the given opcode bytes, a 64 bit operand size
+	 * and the register operands reg and rm.
+	 */
+	void emit_reg(const char* op, size_t n, int reg, int rm);
+	
+	/*
+	 * Emits a jump with the given opcode bytes to the native code of the
+	 * instruction at target, or to common code if target is negative.
+	 */
+	void emit_jump(const char* op, size_t n, int target);
+	
+	/*
+	 * Emits a forward jump with the given opcode bytes, returning the offset of
+	 * its displacement for emit_label.
+	 */
+	size_t emit_forward(const char* op, size_t n);
+	
+	/*
+	 * Resolves the forward jump at ref to the code emitted next.
+	 */
+	void emit_label(size_t ref);
+	
+	/*
+	 * Emits the check that the stack with the top and end fields at the given
+	 * offsets of the state has room for a new element, leaving its top in rax.
+	 * Otherwise it grows, and the instruction at pc is redone.
+	 */
+	void emit_room(int top, int end, int pc);
+	
+	/*
+	 * Emits the push of a backtracking point to the instruction at target,
+	 * with the position in the pos register, being the top of the stack in
+	 * rax.
+	 */
+	void emit_choice(int target, int pos);
+	
+	/*
+	 * Emits the push of the capture of the current frame as rule r, or as its
+	 * rule if r is negative, if it is not empty, being the top of the stack in
+	 * rax.
+	 */
+	void emit_capture(int r);
+	
+	/*
+	 * Emits the check that the current frame is the top of the stack and no
+	 * backtracking point refers to it, adding to refs the forward jumps taken
+	 * otherwise.
+	 */
+	void emit_unshared(std::vector<size_t>& refs);
+	
+	/*
+	 * Emits the scan of the next characters in the given set, up to max,
+	 * leaving their count in r8.
+	 */
+	void emit_scan(const abnf_charset& cs, int max);
+	
+	/*
+	 * Emits the test of the character in eax against the given set, setting
+	 * the carry flag if it is in.
+	 */
+	void emit_test(const abnf_charset& cs);
+	
+	/*
+	 * Emits the loading of the next character to eax, jumping as emit_jump
+	 * does to target at the end of input.
+	 */
+	void emit_load(int target);
+	
+	/*
+	 * Emits the call of fn with the state, position and pc, continuing where
+	 * it returns.
+	 */
+	void emit_helper(int pc, size_t fn);
+	
+	/*
+	 * Index of the table of the given character set.
+	 */
+	int table(const abnf_charset& cs);
+	
+	/*
+	 * Continues the state after the instruction at pc was done by a helper,
+	 * at the given position.
+	 */
+	abnf_jit_next next(int pc, size_t pos) const
+	{
+		abnf_jit_next n = {_addr[pc], pos};
+		return n;
+	}
+	
+	/*
+	 * Helper doing the instruction at pc from pos, as the interpreter does.
+	 */
+	static abnf_jit_next step(abnf_jit_state* st, size_t pos, int pc);
+	
+	/*
+	 * Helper growing the full stacks, to redo the instruction at pc from pos.
+	 */
+	static abnf_jit_next grow(abnf_jit_state* st, size_t pos, int pc);
+	
+	/*
+	 * Does the instruction at pc from pos for step.
+	 */
+	abnf_jit_next step_impl(abnf_jit_state& st, size_t pos, int pc) const;
+	
+	/*
+	 * Doubles the capacity of the full stacks of st.
+	 */
+	static void grow_impl(abnf_jit_state& st);
+};
+
+} // namespace xspider
+
+#endif // ABNFJ_H
@@ -0,0 +1,952 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+#include "abnfj.h"
+#include "abnfp.h"
+
+#if defined(ABNF_JIT)
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Offsets of the fields accessed by native code.
+ */
+#define ABNF_JIT_ST(m) ((int) offsetof(abnf_jit_state, m))
+#define ABNF_JIT_FR(m) ((int) offsetof(abnf_jit_frame, m))
+#define ABNF_JIT_CH(m) ((int) offsetof(abnf_jit_choice, m))
+#define ABNF_JIT_CP(m) ((int) offsetof(abnf_jit_capture, m))
+
+/*
+ * Registers, as numbered by instruction encodings.
+ */
+enum abnf_jit_reg
+{
+	RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+	R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+/*
+ * Common code jumped to, as negative jump targets.
+ */
+enum abnf_jit_stub
+{
+	ABNF_JIT_FAIL = -1,
+	ABNF_JIT_SUCCEED = -2,
+	ABNF_JIT_GROW = -3
+};
+
+/*
+ * Native code entry: saves the callee saved registers, loads the state, buffer,
+ * length, position and frame to them and jumps to the given address.
+ */
+typedef int (*abnf_jit_fn)(abnf_jit_state* st, const char* buf, size_t len,
+		size_t pos, const void* addr, abnf_jit_frame* f);
+
+/*
+ *		push rbx; push r12; push r13; push r14; push r15
+ *		mov r14, rdi; mov rbx, rsi; mov r13, rdx; mov r12, rcx; mov r15, r9
+ *		jmp r8
+ */
+static const char abnf_jit_prologue[] =
+		"\x53\x41\x54\x41\x55\x41\x56\x41\x57"
+		"\x49\x89\xfe\x48\x89\xf3\x49\x89\xd5\x49\x89\xcc\x4d\x89\xcf"
+		"\x41\xff\xe0";
+
+/*
+ *		pop r15; pop r14; pop r13; pop r12; pop rbx
+ *		ret
+ */
+static const char abnf_jit_epilogue[] =
+		"\x41\x5f\x41\x5e\x41\x5d\x41\x5c\x5b"
+		"\xc3";
+
+/*
+ * abnf_ruleset implementation
+ */
+
+void abnf_ruleset::jit(void)
+{
+	if (_prog == NULL)
+		throw logic_error("rule set not compiled");
+	_prog->jit();
+}
+
+/*
+ * abnf_program implementation
+ */
+
+void abnf_program::jit(void)
+{
+	if (_jit == NULL)
+		_jit = new abnf_jit(*this);
+}
+
+/*
+ * abnf_jit implementation
+ */
+
+abnf_jit::abnf_jit(const abnf_program& prog):
+_prog(prog),
+_code(NULL),
+_size(0),
+_fail(NULL),
+_abort(NULL),
+_stubs(3)
+{
+#if defined(ABNF_JIT)
+	emit(abnf_jit_prologue, sizeof(abnf_jit_prologue) - 1);
+	
+	// Exits, returning 1, 0 or -1
+	_stubs[-ABNF_JIT_SUCCEED - 1] = _emit.size();
+	emit("\xb8\x01\x00\x00\x00", 5);
+	emit(abnf_jit_epilogue, sizeof(abnf_jit_epilogue) - 1);
+	size_t failed = _emit.size();
+	emit("\x31\xc0", 2);
+	emit(abnf_jit_epilogue, sizeof(abnf_jit_epilogue) - 1);
+	size_t abort = _emit.size();
+	emit("\xb8\xff\xff\xff\xff", 5);
+	emit(abnf_jit_epilogue, sizeof(abnf_jit_epilogue) - 1);
+	
+	// Failures pop the last backtracking point, restoring its position, frame
+	// and stack tops, and jump to its address
+	_stubs[-ABNF_JIT_FAIL - 1] = _emit.size();
+	emit_mem("\x8b", 1, RAX, R14, ABNF_JIT_ST(ch_top));
+	emit_mem("\x3b", 1, RAX, R14, ABNF_JIT_ST(ch_beg));
+	emit("\x0f\x84", 2);
+	emit32(failed - (_emit.size() + 4));
+	emit_reg("\x81", 1, 5, RAX);
+	emit32(sizeof(abnf_jit_choice));
+	emit_mem("\x89", 1, RAX, R14, ABNF_JIT_ST(ch_top));
+	emit_mem("\x8b", 1, R12, RAX, ABNF_JIT_CH(pos));
+	emit_mem("\x8b", 1, R15, RAX, ABNF_JIT_CH(f));
+	emit_mem("\x8b", 1, RCX, RAX, ABNF_JIT_CH(f_top));
+	emit_mem("\x89", 1, RCX, R14, ABNF_JIT_ST(f_top));
+	emit_mem("\x8b", 1, RCX, RAX, ABNF_JIT_CH(cap_top));
+	emit_mem("\x89", 1, RCX, R14, ABNF_JIT_ST(cap_top));
+	emit_mem("\xff", 1, 4, RAX, ABNF_JIT_CH(addr));
+	
+	// Full stacks grow, with the instruction in edx
+	_stubs[-ABNF_JIT_GROW - 1] = _emit.size();
+	emit_helper(-1, reinterpret_cast<size_t>(&abnf_jit::grow));
+	
+	vector<size_t> offs(_prog._code.size());
+	_call_offs.resize(offs.size());
+	for (size_t pc = 0; pc < _prog._code.size(); ++pc)
+	{
+		offs[pc] = _emit.size();
+		emit_instr(pc);
+	}
+	
+	// Character set tables, aligned to their size
+	while (_emit.size() % 32 not_eq 0)
+		emit("\xcc", 1);
+	size_t tables = _emit.size();
+	for (size_t i = 0; i < _tables.size(); ++i)
+	{
+		unsigned char bits[32] = {0};
+		for (int c = 0; c < 256; ++c)
+			if (_tables[i].test(c))
+				bits[c >> 3] |= 1 << (c & 7);
+		emit((const char*) bits, 32);
+	}
+	
+	// Relative displacements from the end of the referencing instructions
+	for (size_t i = 0; i < _pc_refs.size(); ++i)
+	{
+		int d = offs[_pc_refs[i].second] - (_pc_refs[i].first + 4);
+		memcpy(&_emit[_pc_refs[i].first], &d, 4);
+	}
+	for (size_t i = 0; i < _table_refs.size(); ++i)
+	{
+		int d = tables + 32 * _table_refs[i].second -
+				(_table_refs[i].first + 4);
+		memcpy(&_emit[_table_refs[i].first], &d, 4);
+	}
+	
+	void* code = mmap(NULL, _emit.size(), PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (code == MAP_FAILED)
+		return;
+	memcpy(code, &_emit[0], _emit.size());
+	if (mprotect(code, _emit.size(), PROT_READ | PROT_EXEC) not_eq 0)
+	{
+		munmap(code, _emit.size());
+		return;
+	}
+	
+	_code = (unsigned char*) code;
+	_size = _emit.size();
+	_fail = _code + _stubs[-ABNF_JIT_FAIL - 1];
+	_abort = _code + abort;
+	_addr.resize(offs.size());
+	_calls.resize(offs.size());
+	for (size_t pc = 0; pc < offs.size(); ++pc)
+	{
+		_addr[pc] = _code + offs[pc];
+		_calls[pc] = _code + _call_offs[pc];
+	}
+	
+	_emit.clear();
+	_call_offs.clear();
+	_pc_refs.clear();
+	_table_refs.clear();
+	_tables.clear();
+#endif
+}
+
+abnf_jit::~abnf_jit(void)
+{
+#if defined(ABNF_JIT)
+	if (_code not_eq NULL)
+		munmap(_code, _size);
+#endif
+}
+
+int abnf_jit::run(int r, const char* buf, size_t len, size_t& end,
+		vector<abnf_capture>& caps) const
+{
+	if (_code == NULL)
+		return -1;
+	
+	abnf_jit_state st;
+	st.jit = this;
+	st.buf = buf;
+	st.len = len;
+	st.end = 0;
+	st.f_beg = st.f_arr;
+	st.f_top = st.f_arr + 1;
+	st.f_end = st.f_arr + ABNF_JIT_FRAME_MIN;
+	st.ch_beg = st.ch_top = st.ch_arr;
+	st.ch_end = st.ch_arr + ABNF_JIT_CHOICE_MIN;
+	st.cap_beg = st.cap_top = st.cap_arr;
+	st.cap_end = st.cap_arr + ABNF_JIT_CAPTURE_MIN;
+	
+	st.f = st.f_arr;
+	st.f->parent = NULL;
+	st.f->ret = NULL;
+	st.f->r = r;
+	st.f->beg = 0;
+	st.f->count = 0;
+	st.f->iter = 0;
+	st.f->cut = st.ch_beg;
+	
+	abnf_jit_fn fn = reinterpret_cast<abnf_jit_fn>(_code);
+	int m = fn(&st, buf, len, 0, _addr[_prog._r_pc[r]], st.f);
+	if (m > 0)
+	{
+		end = st.end;
+		caps.reserve(caps.size() + (st.cap_top - st.cap_beg));
+		for (const abnf_jit_capture* k = st.cap_beg; k < st.cap_top; ++k)
+			if (_prog._r_cap[k->r])
+				caps.push_back(abnf_capture(k->r, k->beg, k->end));
+	}
+	
+	if (st.f_beg not_eq st.f_arr)
+		delete[] st.f_beg;
+	if (st.ch_beg not_eq st.ch_arr)
+		delete[] st.ch_beg;
+	if (st.cap_beg not_eq st.cap_arr)
+		delete[] st.cap_beg;
+	return m;
+}
+
+void abnf_jit::emit_instr(int pc)
+{
+	const abnf_instr& in = _prog._code[pc];
+	vector<size_t> refs;
+	switch (in.op)
+	{
+		case ABNF_OP_FAIL:
+		emit_jump("\xe9", 1, ABNF_JIT_FAIL);
+		return;
+		
+		case ABNF_OP_CHAR:
+		emit_load(ABNF_JIT_FAIL);
+		emit("\x3d", 1);
+		emit32(in.a);
+		emit_jump("\x0f\x85", 2, ABNF_JIT_FAIL);
+		break;
+		
+		case ABNF_OP_RANGE:
+		if (in.b < in.a)
+		{
+			emit_jump("\xe9", 1, ABNF_JIT_FAIL);
+			return;
+		}
+		
+		// sub eax, ci; cmp eax, ce - ci; ja fail
+		emit_load(ABNF_JIT_FAIL);
+		emit("\x2d", 1);
+		emit32(in.a);
+		emit("\x3d", 1);
+		emit32(in.b - in.a);
+		emit_jump("\x0f\x87", 2, ABNF_JIT_FAIL);
+		break;
+		
+		case ABNF_OP_FN:
+		emit_helper(pc, reinterpret_cast<size_t>(&abnf_jit::step));
+		return;
+		
+		case ABNF_OP_CLASS:
+		emit_load(ABNF_JIT_FAIL);
+		emit_test(_prog._classes[in.a]);
+		emit_jump("\x0f\x83", 2, ABNF_JIT_FAIL);
+		break;
+		
+		case ABNF_OP_STR:
+		{
+			const string& str = _prog._strs[in.a];
+			if (str.empty())
+			{
+				emit_jump("\xe9", 1, ABNF_JIT_FAIL);
+				return;
+			}
+			
+			// mov rcx, r13; sub rcx, r12; cmp rcx, n; jb fail
+			emit("\x4c\x89\xe9\x4c\x29\xe1\x48\x81\xf9", 9);
+			emit32(str.size());
+			emit_jump("\x0f\x82", 2, ABNF_JIT_FAIL);
+			for (size_t i = 0; i < str.size(); ++i)
+			{
+				// movzx eax, byte [rbx + r12 + i]
+				emit("\x42\x0f\xb6\x84\x23", 5);
+				emit32(i);
+				
+				abnf_charset cs;
+				vector<int> chs;
+				int ch = tolower((unsigned char) str[i]);
+				for (int c = 0; c < 256; ++c)
+					if (tolower(c) == ch)
+					{
+						cs.set(c);
+						chs.push_back(c);
+					}
+				
+				// Case variants of letters differ in a single bit
+				if (chs.size() == 1)
+				{
+					emit("\x3d", 1);
+					emit32(chs[0]);
+					emit_jump("\x0f\x85", 2, ABNF_JIT_FAIL);
+				}
+				else if (chs.size() == 2 and (chs[0] ^ chs[1]) == 0x20)
+				{
+					emit("\x83\xc8\x20\x3d", 4);
+					emit32(chs[0] | 0x20);
+					emit_jump("\x0f\x85", 2, ABNF_JIT_FAIL);
+				}
+				else
+				{
+					emit_test(cs);
+					emit_jump("\x0f\x83", 2, ABNF_JIT_FAIL);
+				}
+			}
+			
+			// add r12, n
+			emit_reg("\x81", 1, 0, R12);
+			emit32(str.size());
+		}
+		return;
+		
+		case ABNF_OP_EOF:
+		// cmp r12, r13; jb fail
+		emit_reg("\x39", 1, R13, R12);
+		emit_jump("\x0f\x82", 2, ABNF_JIT_FAIL);
+		return;
+		
+		case ABNF_OP_CALL:
+		if (_prog._code[in.a].op == ABNF_OP_REP and
+				_prog._code[in.a].c == ABNF_REPET_POSSESSIVE)
+		{
+			// Possessive repetitions run their automaton first, going on
+			// with the call if it gives up
+			emit_helper(pc, reinterpret_cast<size_t>(&abnf_jit::step));
+			_call_offs[pc] = _emit.size();
+		}
+		
+		// Push a frame returning to the next instruction
+		emit_room(ABNF_JIT_ST(f_top), ABNF_JIT_ST(f_end), pc);
+		emit_mem("\x89", 1, R15, RAX, ABNF_JIT_FR(parent));
+		emit("\x48\x8d\x0d", 3);
+		_pc_refs.push_back(make_pair(_emit.size(), pc + 1));
+		emit32(0);
+		emit_mem("\x89", 1, RCX, RAX, ABNF_JIT_FR(ret));
+		emit_mem("\xc7", 1, 0, RAX, ABNF_JIT_FR(r));
+		emit32(in.b);
+		emit_mem("\x89", 1, R12, RAX, ABNF_JIT_FR(beg));
+		emit_mem("\xc7", 1, 0, RAX, ABNF_JIT_FR(count));
+		emit32(0);
+		emit_mem("\x89", 1, R12, RAX, ABNF_JIT_FR(iter));
+		emit_mem("\x8b", 1, RCX, R14, ABNF_JIT_ST(ch_top));
+		emit_mem("\x89", 1, RCX, RAX, ABNF_JIT_FR(cut));
+		emit_reg("\x89", 1, RAX, R15);
+		emit_reg("\x81", 1, 0, RAX);
+		emit32(sizeof(abnf_jit_frame));
+		emit_mem("\x89", 1, RAX, R14, ABNF_JIT_ST(f_top));
+		emit_jump("\xe9", 1, in.a);
+		return;
+		
+		case ABNF_OP_RET:
+		{
+			emit_room(ABNF_JIT_ST(cap_top), ABNF_JIT_ST(cap_end), pc);
+			emit_capture(-1);
+			
+			// The top frame succeeds
+			emit_mem("\x8b", 1, RCX, R15, ABNF_JIT_FR(parent));
+			emit_reg("\x85", 1, RCX, RCX);
+			size_t top = emit_forward("\x0f\x84", 2);
+			
+			// Release the frame if no backtracking point refers to it
+			emit_mem("\x8b", 1, RDX, R15, ABNF_JIT_FR(ret));
+			emit_unshared(refs);
+			emit_mem("\x89", 1, R15, R14, ABNF_JIT_ST(f_top));
+			for (size_t i = 0; i < refs.size(); ++i)
+				emit_label(refs[i]);
+			emit_reg("\x89", 1, RCX, R15);
+			emit_reg("\xff", 1, 4, RDX);
+			
+			emit_label(top);
+			emit_mem("\x89", 1, R12, R14, ABNF_JIT_ST(end));
+			emit_jump("\xe9", 1, ABNF_JIT_SUCCEED);
+		}
+		return;
+		
+		case ABNF_OP_CHOICE:
+		emit_room(ABNF_JIT_ST(ch_top), ABNF_JIT_ST(ch_end), pc);
+		emit_choice(in.a, R12);
+		return;
+		
+		case ABNF_OP_JMP:
+		emit_jump("\xe9", 1, in.a);
+		return;
+		
+		case ABNF_OP_REP:
+		emit_room(ABNF_JIT_ST(ch_top), ABNF_JIT_ST(ch_end), pc);
+		emit_mem("\x8b", 1, RCX, R15, ABNF_JIT_FR(count));
+		emit_reg("\x81", 1, 7, RCX);
+		emit32(in.a);
+		emit_jump("\x0f\x8c", 2, pc + 1);
+		emit_reg("\x81", 1, 7, RCX);
+		emit32(in.b);
+		emit_jump("\x0f\x8d", 2, pc + 3);
+		if (in.c == ABNF_REPET_LAZY)
+		{
+			emit_choice(pc + 1, R12);
+			emit_jump("\xe9", 1, pc + 3);
+		}
+		else
+			emit_choice(pc + 3, R12);
+		return;
+		
+		case ABNF_OP_LOOP:
+		{
+			emit_room(ABNF_JIT_ST(f_top), ABNF_JIT_ST(f_end), pc);
+			
+			// Empty occurrences beyond the minimum lead nowhere new
+			emit_mem("\x3b", 1, R12, R15, ABNF_JIT_FR(iter));
+			size_t next = emit_forward("\x0f\x85", 2);
+			emit_mem("\x81", 1, 7, R15, ABNF_JIT_FR(count));
+			emit32(_prog._code[in.a].a);
+			emit_jump("\x0f\x8d", 2, ABNF_JIT_FAIL);
+			emit_label(next);
+			
+			// The frame is updated, if no backtracking point refers to it,
+			// or copied
+			emit_unshared(refs);
+			emit_mem("\xff", 1, 0, R15, ABNF_JIT_FR(count));
+			emit_mem("\x89", 1, R12, R15, ABNF_JIT_FR(iter));
+			emit_jump("\xe9", 1, in.a);
+			
+			for (size_t i = 0; i < refs.size(); ++i)
+				emit_label(refs[i]);
+			emit_mem("\x8b", 1, RAX, R14, ABNF_JIT_ST(f_top));
+			for (size_t i = 0; i < sizeof(abnf_jit_frame); i += 8)
+			{
+				emit_mem("\x8b", 1, RCX, R15, i);
+				emit_mem("\x89", 1, RCX, RAX, i);
+			}
+			emit_mem("\xff", 1, 0, RAX, ABNF_JIT_FR(count));
+			emit_mem("\x89", 1, R12, RAX, ABNF_JIT_FR(iter));
+			emit_reg("\x89", 1, RAX, R15);
+			emit_reg("\x81", 1, 0, RAX);
+			emit32(sizeof(abnf_jit_frame));
+			emit_mem("\x89", 1, RAX, R14, ABNF_JIT_ST(f_top));
+			emit_jump("\xe9", 1, in.a);
+		}
+		return;
+		
+		case ABNF_OP_RUN:
+		{
+			emit_room(ABNF_JIT_ST(ch_top), ABNF_JIT_ST(ch_end), pc);
+			emit_scan(_prog._classes[in.a], in.c);
+			emit_reg("\x81", 1, 7, R8);
+			emit32(in.b);
+			emit_jump("\x0f\x82", 2, ABNF_JIT_FAIL);
+			
+			// lea rax, [r12 + r8]
+			emit("\x4b\x8d\x04\x04", 4);
+			emit_mem("\x89", 1, RAX, R15, ABNF_JIT_FR(iter));
+			emit_reg("\x81", 1, 0, R12);
+			emit32(in.b);
+			emit_reg("\x39", 1, RAX, R12);
+			size_t skip = emit_forward("\x0f\x83", 2);
+			emit_mem("\x8b", 1, RAX, R14, ABNF_JIT_ST(ch_top));
+			emit_choice(pc + 1, R12);
+			emit_label(skip);
+			emit_jump("\xe9", 1, pc + 2);
+		}
+		return;
+		
+		case ABNF_OP_SPAN:
+		emit_scan(_prog._classes[in.a], in.c);
+		
+		// cmp r8, min; jb fail; add r12, r8
+		emit_reg("\x81", 1, 7, R8);
+		emit32(in.b);
+		emit_jump("\x0f\x82", 2, ABNF_JIT_FAIL);
+		emit_reg("\x01", 1, R8, R12);
+		return;
+		
+		case ABNF_OP_MORE:
+		{
+			emit_room(ABNF_JIT_ST(ch_top), ABNF_JIT_ST(ch_end), pc);
+			emit_reg("\xff", 1, 0, R12);
+			emit_mem("\x3b", 1, R12, R15, ABNF_JIT_FR(iter));
+			size_t skip = emit_forward("\x0f\x83", 2);
+			emit_choice(pc, R12);
+			emit_label(skip);
+		}
+		return;
+		
+		case ABNF_OP_LESS:
+		{
+			emit_room(ABNF_JIT_ST(ch_top), ABNF_JIT_ST(ch_end), pc);
+			emit_mem("\x8b", 1, RCX, R15, ABNF_JIT_FR(beg));
+			emit_reg("\x81", 1, 0, RCX);
+			emit32(in.a);
+			emit_reg("\x39", 1, RCX, R12);
+			size_t skip = emit_forward("\x0f\x86", 2);
+			emit_mem("\x8d", 1, RDX, R12, -1);
+			emit_choice(pc, RDX);
+			emit_label(skip);
+		}
+		return;
+		
+		case ABNF_OP_CUT:
+		emit_mem("\x8b", 1, RAX, R15, ABNF_JIT_FR(cut));
+		emit_mem("\x89", 1, RAX, R14, ABNF_JIT_ST(ch_top));
+		return;
+		
+		case ABNF_OP_TEST:
+		emit_load(in.b);
+		emit_test(_prog._classes[in.a]);
+		emit_jump("\x0f\x83", 2, in.b);
+		return;
+		
+		case ABNF_OP_CAP:
+		emit_room(ABNF_JIT_ST(cap_top), ABNF_JIT_ST(cap_end), pc);
+		emit_capture(in.a);
+		return;
+		
+		case ABNF_OP_TRIE:
+		emit_helper(pc, reinterpret_cast<size_t>(&abnf_jit::step));
+		return;
+		
+		default:
+		emit_jump("\xe9", 1, ABNF_JIT_FAIL);
+		return;
+	}
+	
+	// A character matched: inc r12
+	emit_reg("\xff", 1, 0, R12);
+}
+
+void abnf_jit::emit(const char* bytes, size_t n)
+{
+	_emit.insert(_emit.end(), bytes, bytes + n);
+}
+
+void abnf_jit::emit32(int v)
+{
+	emit((const char*) &v, 4);
+}
+
+void abnf_jit::emit64(size_t v)
+{
+	emit((const char*) &v, 8);
+}
+
+void abnf_jit::emit_mem(const char* op, size_t n, int reg, int base, int disp)
+{
+	// REX.W prefix, with the high bits of the registers
+	_emit.push_back(0x48 | (reg & 8) >> 1 | (base & 8) >> 3);
+	emit(op, n);
+	
+	// ModRM with a 32 bit displacement, and SIB for rsp and r12 bases
+	_emit.push_back(0x80 | (reg & 7) << 3 | (base & 7));
+	if ((base & 7) == RSP)
+		_emit.push_back(0x24);
+	emit32(disp);
+}
+
+void abnf_jit::emit_reg(const char* op, size_t n, int reg, int rm)
+{
+	_emit.push_back(0x48 | (reg & 8) >> 1 | (rm & 8) >> 3);
+	emit(op, n);
+	_emit.push_back(0xc0 | (reg & 7) << 3 | (rm & 7));
+}
+
+void abnf_jit::emit_jump(const char* op, size_t n, int target)
+{
+	emit(op, n);
+	if (target < 0)
+		emit32(_stubs[-target - 1] - (_emit.size() + 4));
+	else
+	{
+		_pc_refs.push_back(make_pair(_emit.size(), target));
+		emit32(0);
+	}
+}
+
+size_t abnf_jit::emit_forward(const char* op, size_t n)
+{
+	emit(op, n);
+	emit32(0);
+	return _emit.size() - 4;
+}
+
+void abnf_jit::emit_label(size_t ref)
+{
+	int d = _emit.size() - (ref + 4);
+	memcpy(&_emit[ref], &d, 4);
+}
+
+void abnf_jit::emit_room(int top, int end, int pc)
+{
+	// mov rax, [r14 + top]; cmp rax, [r14 + end]; jb +10; mov edx, pc;
+	// jmp grow
+	emit_mem("\x8b", 1, RAX, R14, top);
+	emit_mem("\x3b", 1, RAX, R14, end);
+	emit("\x72\x0a\xba", 3);
+	emit32(pc);
+	emit_jump("\xe9", 1, ABNF_JIT_GROW);
+}
+
+void abnf_jit::emit_choice(int target, int pos)
+{
+	emit("\x48\x8d\x0d", 3);
+	_pc_refs.push_back(make_pair(_emit.size(), target));
+	emit32(0);
+	emit_mem("\x89", 1, RCX, RAX, ABNF_JIT_CH(addr));
+	emit_mem("\x89", 1, pos, RAX, ABNF_JIT_CH(pos));
+	emit_mem("\x89", 1, R15, RAX, ABNF_JIT_CH(f));
+	emit_mem("\x8b", 1, RCX, R14, ABNF_JIT_ST(f_top));
+	emit_mem("\x89", 1, RCX, RAX, ABNF_JIT_CH(f_top));
+	emit_mem("\x8b", 1, RCX, R14, ABNF_JIT_ST(cap_top));
+	emit_mem("\x89", 1, RCX, RAX, ABNF_JIT_CH(cap_top));
+	emit_reg("\x81", 1, 0, RAX);
+	emit32(sizeof(abnf_jit_choice));
+	emit_mem("\x89", 1, RAX, R14, ABNF_JIT_ST(ch_top));
+}
+
+void abnf_jit::emit_capture(int r)
+{
+	// mov rcx, [r15 + beg]; cmp r12, rcx; jbe skip
+	emit_mem("\x8b", 1, RCX, R15, ABNF_JIT_FR(beg));
+	emit_reg("\x39", 1, RCX, R12);
+	size_t skip = emit_forward("\x0f\x86", 2);
+	if (r < 0)
+	{
+		emit_mem("\x8b", 1, RDX, R15, ABNF_JIT_FR(r));
+		emit_mem("\x89", 1, RDX, RAX, ABNF_JIT_CP(r));
+	}
+	else
+	{
+		emit_mem("\xc7", 1, 0, RAX, ABNF_JIT_CP(r));
+		emit32(r);
+	}
+	emit_mem("\x89", 1, RCX, RAX, ABNF_JIT_CP(beg));
+	emit_mem("\x89", 1, R12, RAX, ABNF_JIT_CP(end));
+	emit_reg("\x81", 1, 0, RAX);
+	emit32(sizeof(abnf_jit_capture));
+	emit_mem("\x89", 1, RAX, R14, ABNF_JIT_ST(cap_top));
+	emit_label(skip);
+}
+
+void abnf_jit::emit_unshared(vector<size_t>& refs)
+{
+	// lea rax, [r15 + size]; cmp rax, [r14 + f_top]; jne shared
+	emit_mem("\x8d", 1, RAX, R15, sizeof(abnf_jit_frame));
+	emit_mem("\x3b", 1, RAX, R14, ABNF_JIT_ST(f_top));
+	refs.push_back(emit_forward("\x0f\x85", 2));
+	
+	// mov rsi, [r14 + ch_top]; cmp rsi, [r14 + ch_beg]; je unshared
+	emit_mem("\x8b", 1, RSI, R14, ABNF_JIT_ST(ch_top));
+	emit_mem("\x3b", 1, RSI, R14, ABNF_JIT_ST(ch_beg));
+	size_t unshared = emit_forward("\x0f\x84", 2);
+	
+	// The last backtracking point restores a frame stack top above
+	emit_mem("\x8b", 1, RSI, RSI, ABNF_JIT_CH(f_top) -
+			(int) sizeof(abnf_jit_choice));
+	emit_reg("\x39", 1, R15, RSI);
+	refs.push_back(emit_forward("\x0f\x87", 2));
+	emit_label(unshared);
+}
+
+void abnf_jit::emit_scan(const abnf_charset& cs, int max)
+{
+	// mov rcx, r13; sub rcx, r12; cmp rcx, max; jbe +5; mov ecx, max
+	emit("\x4c\x89\xe9\x4c\x29\xe1\x48\x81\xf9", 9);
+	emit32(max);
+	emit("\x76\x05\xb9", 3);
+	emit32(max);
+	
+	// lea rsi, [rbx + r12]; lea rdx, [rip + table]; xor r8d, r8d
+	emit("\x4a\x8d\x34\x23\x48\x8d\x15", 7);
+	_table_refs.push_back(make_pair(_emit.size(), table(cs)));
+	emit32(0);
+	emit("\x45\x31\xc0", 3);
+	
+	// loop: cmp r8, rcx; jae done
+	//		movzx eax, byte [rsi + r8]
+	//		mov r9d, eax; shr r9d, 5; mov r9d, [rdx + r9 * 4]; bt r9d, eax
+	//		jnc done; inc r8; jmp loop
+	emit("\x49\x39\xc8\x73\x1b", 5);
+	emit("\x42\x0f\xb6\x04\x06", 5);
+	emit("\x41\x89\xc1\x41\xc1\xe9\x05\x46\x8b\x0c\x8a\x41\x0f\xa3\xc1",
+			15);
+	emit("\x73\x05\x49\xff\xc0\xeb\xe0", 7);
+}
+
+void abnf_jit::emit_test(const abnf_charset& cs)
+{
+	// mov ecx, eax; shr ecx, 5; lea rdx, [rip + table];
+	// mov ecx, [rdx + rcx * 4]; bt ecx, eax
+	emit("\x89\xc1\xc1\xe9\x05\x48\x8d\x15", 8);
+	_table_refs.push_back(make_pair(_emit.size(), table(cs)));
+	emit32(0);
+	emit("\x8b\x0c\x8a\x0f\xa3\xc1", 6);
+}
+
+void abnf_jit::emit_load(int target)
+{
+	// cmp r12, r13; jae target; movzx eax, byte [rbx + r12]
+	emit_reg("\x39", 1, R13, R12);
+	emit_jump("\x0f\x83", 2, target);
+	emit("\x42\x0f\xb6\x04\x23", 5);
+}
+
+void abnf_jit::emit_helper(int pc, size_t fn)
+{
+	// The frame is saved to the state, as helpers may move it
+	emit_mem("\x89", 1, R15, R14, ABNF_JIT_ST(f));
+	
+	// mov rdi, r14; mov rsi, r12; mov edx, pc; mov rax, fn; call rax
+	emit_reg("\x89", 1, R14, RDI);
+	emit_reg("\x89", 1, R12, RSI);
+	if (pc >= 0)
+	{
+		emit("\xba", 1);
+		emit32(pc);
+	}
+	emit("\x48\xb8", 2);
+	emit64(fn);
+	emit("\xff\xd0", 2);
+	
+	// mov r15, [r14 + f]; mov r12, rdx; jmp rax
+	emit_mem("\x8b", 1, R15, R14, ABNF_JIT_ST(f));
+	emit_reg("\x89", 1, RDX, R12);
+	emit("\xff\xe0", 2);
+}
+
+int abnf_jit::table(const abnf_charset& cs)
+{
+	for (size_t i = 0; i < _tables.size(); ++i)
+	{
+		int c = 0;
+		while (c < 256 and _tables[i].test(c) == cs.test(c))
+			++c;
+		if (c == 256)
+			return i;
+	}
+	_tables.push_back(cs);
+	return _tables.size() - 1;
+}
+
+abnf_jit_next abnf_jit::step(abnf_jit_state* st, size_t pos, int pc)
+{
+	try
+	{
+		return st->jit->step_impl(*st, pos, pc);
+	}
+	catch (...)
+	{
+		// Exceptions can not unwind native code, so the interpreter runs
+		// again, throwing them
+		abnf_jit_next n = {st->jit->_abort, pos};
+		return n;
+	}
+}
+
+abnf_jit_next abnf_jit::grow(abnf_jit_state* st, size_t pos, int pc)
+{
+	try
+	{
+		grow_impl(*st);
+		return st->jit->next(pc, pos);
+	}
+	catch (...)
+	{
+		abnf_jit_next n = {st->jit->_abort, pos};
+		return n;
+	}
+}
+
+abnf_jit_next abnf_jit::step_impl(abnf_jit_state& st, size_t pos,
+		int pc) const
+{
+	const abnf_instr& in = _prog._code[pc];
+	switch (in.op)
+	{
+		case ABNF_OP_FN:
+		if (pos < st.len and
+				_prog._fns[in.a]((unsigned char) st.buf[pos]) > 0)
+			return next(pc + 1, pos + 1);
+		break;
+		
+		case ABNF_OP_CALL:
+		{
+			vector<abnf_capture> caps;
+			size_t n;
+			int m = _prog.dfa_run(in.b, st.buf, pos, st.len, n, caps);
+			if (m == 0)
+				break;
+			if (m < 0)
+			{
+				abnf_jit_next call = {_calls[pc], pos};
+				return call;
+			}
+			
+			for (size_t i = 0; i < caps.size(); ++i)
+			{
+				if (st.cap_top == st.cap_end)
+					grow_impl(st);
+				st.cap_top->r = caps[i].r;
+				st.cap_top->beg = caps[i].beg;
+				st.cap_top->end = caps[i].end;
+				++st.cap_top;
+			}
+			return next(pc + 1, n);
+		}
+		
+		case ABNF_OP_TRIE:
+		{
+			const abnf_trie& trie = _prog._tries[in.a];
+			vector<size_t> idx;
+			trie.find(st.buf + pos, st.len - pos, idx);
+			if (idx.empty())
+				break;
+			
+			// Next strings are retried in increasing index order
+			for (size_t i = idx.size() - 1; i > 0; --i)
+			{
+				if (st.ch_top == st.ch_end)
+					grow_impl(st);
+				st.ch_top->addr = _addr[pc + 1 + idx[i]];
+				st.ch_top->pos = pos + trie.length(idx[i]);
+				st.ch_top->f = st.f;
+				st.ch_top->f_top = st.f_top;
+				st.ch_top->cap_top = st.cap_top;
+				++st.ch_top;
+			}
+			return next(pc + 1 + idx.front(), pos + trie.length(idx.front()));
+		}
+		
+		default:
+		break;
+	}
+	
+	abnf_jit_next n = {_fail, pos};
+	return n;
+}
+
+void abnf_jit::grow_impl(abnf_jit_state& st)
+{
+	// Pointers to the moved stacks are relocated
+	if (st.f_top == st.f_end)
+	{
+		size_t n = st.f_end - st.f_beg;
+		abnf_jit_frame* f_beg = new abnf_jit_frame[2 * n];
+		copy(st.f_beg, st.f_end, f_beg);
+		for (abnf_jit_frame* f = f_beg; f < f_beg + n; ++f)
+			if (f->parent not_eq NULL)
+				f->parent = f_beg + (f->parent - st.f_beg);
+		for (abnf_jit_choice* ch = st.ch_beg; ch < st.ch_top; ++ch)
+		{
+			ch->f = f_beg + (ch->f - st.f_beg);
+			ch->f_top = f_beg + (ch->f_top - st.f_beg);
+		}
+		st.f = f_beg + (st.f - st.f_beg);
+		
+		if (st.f_beg not_eq st.f_arr)
+			delete[] st.f_beg;
+		st.f_beg = f_beg;
+		st.f_top = f_beg + n;
+		st.f_end = f_beg + 2 * n;
+	}
+	
+	if (st.ch_top == st.ch_end)
+	{
+		size_t n = st.ch_end - st.ch_beg;
+		abnf_jit_choice* ch_beg = new abnf_jit_choice[2 * n];
+		copy(st.ch_beg, st.ch_end, ch_beg);
+		for (abnf_jit_frame* f = st.f_beg; f < st.f_top; ++f)
+			f->cut = ch_beg + (f->cut - st.ch_beg);
+		
+		if (st.ch_beg not_eq st.ch_arr)
+			delete[] st.ch_beg;
+		st.ch_beg = ch_beg;
+		st.ch_top = ch_beg + n;
+		st.ch_end = ch_beg + 2 * n;
+	}
+	
+	if (st.cap_top == st.cap_end)
+	{
+		size_t n = st.cap_end - st.cap_beg;
+		abnf_jit_capture* cap_beg = new abnf_jit_capture[2 * n];
+		copy(st.cap_beg, st.cap_end, cap_beg);
+		for (abnf_jit_choice* ch = st.ch_beg; ch < st.ch_top; ++ch)
+			ch->cap_top = cap_beg + (ch->cap_top - st.cap_beg);
+		
+		if (st.cap_beg not_eq st.cap_arr)
+			delete[] st.cap_beg;
+		st.cap_beg = cap_beg;
+		st.cap_top = cap_beg + n;
+		st.cap_end = cap_beg + 2 * n;
+	}
+}
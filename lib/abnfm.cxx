@@ -20,6 +20,9 @@
 
 #include "abnfm.h"
 
+#define ARENA_BLOCK 65536
+#define ARENA_ALIGN 16
+
 using namespace xspider;
 
 /*
@@ -34,3 +37,61 @@ bool abnf_matcher::available(void) const
 {
 	return false;
 }
+
+/*
+ * abnf_arena implementation
+ */
+
+abnf_arena::~abnf_arena(void)
+{
+	std::vector<char*>::const_iterator it = _blk_vect.begin();
+	while (it not_eq _blk_vect.end())
+		delete[] *it++;
+}
+
+void* abnf_arena::alloc(size_t size)
+{
+	size = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+	
+	// Free blocks of a size are linked through their first bytes
+	size_t n = size / ARENA_ALIGN;
+	if (n < _free_vect.size() and _free_vect[n] not_eq NULL)
+	{
+		void* p = _free_vect[n];
+		_free_vect[n] = *static_cast<void**>(p);
+		return p;
+	}
+	
+	while (_blk < _blk_vect.size() and _pos + size > _size_vect[_blk])
+	{
+		++_blk;
+		_pos = 0;
+	}
+	if (_blk == _blk_vect.size())
+	{
+		size_t blk_size = size > ARENA_BLOCK ? size : ARENA_BLOCK;
+		_blk_vect.push_back(new char[blk_size]);
+		_size_vect.push_back(blk_size);
+	}
+	void* p = _blk_vect[_blk] + _pos;
+	_pos += size;
+	return p;
+}
+
+void* abnf_arena::owned_alloc(size_t size)
+{
+	char* p = static_cast<char*>(alloc(size + ARENA_ALIGN));
+	*reinterpret_cast<abnf_arena**>(p) = this;
+	return p + ARENA_ALIGN;
+}
+
+void abnf_arena::owned_free(void* p, size_t size)
+{
+	char* blk = static_cast<char*>(p) - ARENA_ALIGN;
+	abnf_arena& arena = **reinterpret_cast<abnf_arena**>(blk);
+	size_t n = (size + 2 * ARENA_ALIGN - 1) / ARENA_ALIGN;
+	if (n >= arena._free_vect.size())
+		arena._free_vect.resize(n + 1, NULL);
+	*reinterpret_cast<void**>(blk) = arena._free_vect[n];
+	arena._free_vect[n] = blk;
+}
@@ -21,10 +21,78 @@
 #ifndef ABNFM_H
 #define ABNFM_H
 
+#include <cstddef>
+
 #include "abnfr.h"
 
 namespace xspider {
 
+/*
+ * Bump allocator for matchers and rules.
+ *
+ * Memory is taken from big blocks which are kept after a reset, so every read
+ * operation reuses the blocks of the previous ones. Rules are never released
+ * one by one, so their arena is only deleted with their rule set. Matchers
+ * released while backtracking are kept in free lists by size, so their memory
+ * is reused by the next matchers of that size instead of growing the arena.
+ */
+class abnf_arena
+{
+	public:
+	
+	/*
+	 * Empty arena, without blocks.
+	 */
+	abnf_arena(void):
+	_blk(0),
+	_pos(0)
+	{
+	}
+	
+	/*
+	 * Release all blocks.
+	 */
+	~abnf_arena(void);
+	
+	/*
+	 * Allocates size bytes, aligned for any matcher or rule, taking them from
+	 * the free list of their size if it is not empty.
+	 */
+	void* alloc(size_t size);
+	
+	/*
+	 * Allocates size bytes as alloc does, after a header referring to this
+	 * arena, so that they can be released through owned_free.
+	 */
+	void* owned_alloc(size_t size);
+	
+	/*
+	 * Adds the size bytes at p, given by the owned_alloc of some arena, to the
+	 * free list of their size in that arena.
+	 */
+	static void owned_free(void* p, size_t size);
+	
+	/*
+	 * Makes all the allocated memory available again.
+	 *
+	 * Precondition:
+	 *		objects allocated from this arena are destroyed
+	 */
+	void reset(void)
+	{
+		_blk = 0;
+		_pos = 0;
+		_free_vect.clear();
+	}
+	
+	private:
+	
+	std::vector<char*> _blk_vect;
+	std::vector<size_t> _size_vect;
+	size_t _blk, _pos;
+	std::vector<void*> _free_vect;
+};
+
 /*
  * Generic rule matcher.
  */
@@ -48,6 +116,31 @@ class abnf_matcher
 	 */
 	virtual ~abnf_matcher(void);
 	
+	/*
+	 * Matchers are allocated from an arena.
+	 */
+	static void* operator new(size_t size, abnf_arena& arena)
+	{
+		return arena.owned_alloc(size);
+	}
+	
+	/*
+	 * Memory of matchers is reused by the next ones of their size allocated
+	 * from their arena, until it is reset.
+	 */
+	static void operator delete(void* p, size_t size)
+	{
+		abnf_arena::owned_free(p, size);
+	}
+	
+	/*
+	 * Memory of matchers whose construction fails is released by resetting
+	 * their arena.
+	 */
+	static void operator delete(void* p, abnf_arena& arena)
+	{
+	}
+	
 	/*
 	 * Begin of mathing stream.
 	 */
@@ -127,6 +220,17 @@ class abnf_matcher
 	abnf_rule_ri& _r;
 	bool _avail;
 	std::streampos _beg, _end;
+	
+	/*
+	 * Memoized results commit children segments of their own matchers.
+	 */
+	friend class abnf_memo_entry;
+	
+	/*
+	 * Alias matchers commit children segments of the matchers of their
+	 * bodies.
+	 */
+	friend class abnf_matcher_alias;
 };
 
 } // namespace xspider
@@ -0,0 +1,392 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "abnfm.h"
+
+namespace xspider {
+
+/*
+ * Matching result of a memoized rule: its end and the segments its children
+ * rules store when it is committed.
+ */
+class abnf_memo_result
+{
+	public:
+	
+	/*
+	 * Initialized result without segments.
+	 */
+	abnf_memo_result(std::streampos end):
+	end(end)
+	{
+	}
+	
+	std::streampos end;
+	std::vector<abnf_rule_segment> seg_vect;
+};
+
+/*
+ * Matching results of a memoized rule from a single stream position.
+ *
+ * Results are computed on demand by a matcher of the rule, which is shared by
+ * all those matchers referencing this entry and kept until it has no more
+ * results. The segments of every result are recorded when it is found, so
+ * they are committed without matching again.
+ */
+class abnf_memo_entry
+{
+	public:
+	
+	/*
+	 * Initialized entry without results.
+	 *
+	 * If size is not null, it is increased by the size of every stored result.
+	 */
+	abnf_memo_entry(abnf_rule_ri& r, std::streampos beg, size_t* size):
+	_r(r),
+	_beg(beg),
+	_size(size),
+	_gen(NULL),
+	_done(false)
+	{
+	}
+	
+	/*
+	 * Delete the results matcher.
+	 */
+	~abnf_memo_entry(void)
+	{
+		delete _gen;
+	}
+	
+	/*
+	 * Indicates if this entry is shared through a memo.
+	 */
+	bool shared(void) const
+	{
+		return _size not_eq NULL;
+	}
+	
+	/*
+	 * Positions the given stream at the end of the nth result, which is
+	 * computed if it was not yet.
+	 *
+	 * Returns true if there is such result; false otherwise.
+	 *
+	 * Precondition:
+	 *		results before the nth one were already computed
+	 */
+	bool result(long n, std::istream& is);
+	
+	/*
+	 * Availability test of more results after the nth one.
+	 */
+	bool available(long n) const;
+	
+	/*
+	 * Commit children segments of the nth result.
+	 */
+	void commit(long n);
+	
+	private:
+	
+	abnf_rule_ri& _r;
+	const std::streampos _beg;
+	size_t* _size;
+	std::vector<abnf_memo_result> _res;
+	abnf_matcher* _gen;
+	bool _done;
+};
+
+/*
+ * Memoized matching results of a rule.
+ */
+class abnf_memo
+{
+	public:
+	
+	/*
+	 * Initialized memo without entries.
+	 */
+	abnf_memo(abnf_rule_ri& r, size_t mem_max):
+	_r(r),
+	_size(0),
+	_size_max(mem_max)
+	{
+	}
+	
+	/*
+	 * Delete all entries.
+	 */
+	~abnf_memo(void)
+	{
+		clear();
+	}
+	
+	/*
+	 * Memory limit.
+	 */
+	size_t size_max(void) const
+	{
+		return _size_max;
+	}
+	
+	/*
+	 * Entry for the given stream position.
+	 *
+	 * If the memory limit has been reached by the entries and their results,
+	 * an unshared entry is created and must be deleted by the caller.
+	 */
+	abnf_memo_entry* entry(std::streampos beg);
+	
+	/*
+	 * Delete all entries.
+	 *
+	 * Precondition:
+	 *		no entry is referenced
+	 */
+	void clear(void);
+	
+	private:
+	
+	abnf_rule_ri& _r;
+	size_t _size;
+	const size_t _size_max;
+	std::map<std::streamoff, abnf_memo_entry*> _e_map;
+};
+
+/*
+ * Matcher for memoized rule.
+ */
+class abnf_matcher_memo:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized memoized matcher.
+	 */
+	abnf_matcher_memo(abnf_rule_ri& r, abnf_memo& memo):
+	abnf_matcher(r),
+	_memo(memo),
+	_e(NULL),
+	_n(-1l)
+	{
+	}
+	
+	/*
+	 * Release the referenced entry.
+	 */
+	~abnf_matcher_memo(void);
+	
+	/*
+	 * Available if, and only if the entry has more results.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Commit children segments of the current result.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches if, and only if the entry has a next result.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	abnf_memo& _memo;
+	abnf_memo_entry* _e;
+	long _n;
+};
+
+} // namespace xspider
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * abnf_ruleset implementation
+ */
+ 
+abnf_rule& abnf_ruleset::memoize(abnf_rule& r, size_t mem_max)
+{
+	owner_only_test(*this, r);
+	
+	abnf_rule_ri& r_ri = abnf_rule_ri::cast(r);
+	r_ri.memo_enable(mem_max);
+	++_changes;
+	return r_ri;
+}
+
+/*
+ * abnf_rule_ri implementation
+ */
+
+abnf_rule_ri::~abnf_rule_ri(void)
+{
+	delete _memo;
+}
+
+void abnf_rule_ri::memo_enable(size_t mem_max)
+{
+	delete _memo;
+	_memo = new abnf_memo(*this, mem_max);
+}
+
+size_t abnf_rule_ri::memo_max(void) const
+{
+	return _memo == NULL ? 0 : _memo->size_max();
+}
+
+abnf_matcher* abnf_rule_ri::memo_matcher_new(void)
+{
+	return new (arena()) abnf_matcher_memo(*this, *_memo);
+}
+
+void abnf_rule_ri::memo_clear(void)
+{
+	if (_memo not_eq NULL)
+		_memo->clear();
+}
+
+/*
+ * abnf_memo_entry implementation
+ */
+
+bool abnf_memo_entry::result(long n, istream& is)
+{
+	if (n < (long) _res.size())
+	{
+		is.clear();
+		is.seekg(_res[n].end);
+		return true;
+	}
+	if (_done)
+		return false;
+	
+	if (_gen == NULL)
+		_gen = _r.matcher_new_impl();
+	is.clear();
+	is.seekg(_beg);
+	if (not _gen->match(is))
+	{
+		// No more results, matcher is useless from now
+		_done = true;
+		delete _gen;
+		_gen = NULL;
+		return false;
+	}
+	
+	// Segments are recorded instead of stored, to be committed by any
+	// matcher taking this result
+	_res.push_back(abnf_memo_result(_gen->stream_end()));
+	vector<abnf_rule_segment>* rec =
+			abnf_rule_ri::segment_record(&_res.back().seg_vect);
+	_gen->commit_impl();
+	abnf_rule_ri::segment_record(rec);
+	if (_size not_eq NULL)
+		*_size += sizeof (abnf_memo_result) +
+				_res.back().seg_vect.size() * sizeof (abnf_rule_segment);
+	
+	is.clear();
+	is.seekg(_res.back().end);
+	return true;
+}
+
+bool abnf_memo_entry::available(long n) const
+{
+	if (n + 1 < (long) _res.size())
+		return true;
+	if (_done)
+		return false;
+	if (_gen not_eq NULL)
+		return _gen->available();
+	return true;
+}
+
+void abnf_memo_entry::commit(long n)
+{
+	vector<abnf_rule_segment>::const_iterator it = _res[n].seg_vect.begin();
+	while (it not_eq _res[n].seg_vect.end())
+	{
+		it->r->segment_add(streamoff(it->seg.beg()), streamoff(it->seg.end()));
+		++it;
+	}
+}
+
+/*
+ * abnf_memo implementation
+ */
+
+abnf_memo_entry* abnf_memo::entry(streampos beg)
+{
+	map<streamoff, abnf_memo_entry*>::const_iterator it = _e_map.find(beg);
+	if (it not_eq _e_map.end())
+		return it->second;
+	
+	// Limit reached, do not memoize
+	size_t e_size = sizeof (abnf_memo_entry) +
+			sizeof (pair<streamoff, abnf_memo_entry*>);
+	if (_size + e_size > _size_max)
+		return new abnf_memo_entry(_r, beg, NULL);
+	
+	_size += e_size;
+	return _e_map[beg] = new abnf_memo_entry(_r, beg, &_size);
+}
+
+void abnf_memo::clear(void)
+{
+	map<streamoff, abnf_memo_entry*>::const_iterator it = _e_map.begin();
+	while (it not_eq _e_map.end())
+		delete it++->second;
+	_e_map.clear();
+	_size = 0;
+}
+
+/*
+ * abnf_matcher_memo implementation
+ */
+
+abnf_matcher_memo::~abnf_matcher_memo(void)
+{
+	if (_e not_eq NULL and not _e->shared())
+		delete _e;
+}
+
+bool abnf_matcher_memo::available(void) const
+{
+	return _e == NULL or _e->available(_n);
+}
+
+void abnf_matcher_memo::commit_impl(void)
+{
+	_e->commit(_n);
+}
+
+bool abnf_matcher_memo::match_impl(istream& is)
+{
+	if (_e == NULL)
+		_e = _memo.entry(stream_beg());
+	return _e->result(++_n, is);
+}
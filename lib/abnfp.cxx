@@ -0,0 +1,616 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "abnfj.h"
+#include "abnfp.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * abnf_ruleset implementation
+ */
+
+void abnf_ruleset::compile(void)
+{
+	abnf_program* prog = new abnf_program();
+	
+	prog->attach(abnf_rule_ri::cast(*_empty_r));
+	vector<abnf_rule*>::const_iterator it = _r_vect.begin();
+	while (it not_eq _r_vect.end())
+		prog->attach(abnf_rule_ri::cast(**it++));
+	
+	delete _prog;
+	_prog = prog;
+}
+
+/*
+ * abnf_program implementation
+ */
+
+abnf_program::abnf_program(void):
+_jit(NULL)
+{
+}
+
+abnf_program::~abnf_program(void)
+{
+	vector<abnf_dfa*>::const_iterator it = _dfas.begin();
+	while (it not_eq _dfas.end())
+		delete *it++;
+	delete _jit;
+}
+
+int abnf_program::entry(abnf_rule_ri& r)
+{
+	map<const abnf_rule_ri*, int>::const_iterator it = _r_map.find(&r);
+	if (it not_eq _r_map.end())
+		return it->second;
+	
+	int pc = r.compile_impl(*this);
+	int id = _rules.size();
+	_rules.push_back(&r);
+	_r_pc.push_back(pc);
+	_r_cap.push_back(r.capture_needed());
+	_r_first.push_back(r.first());
+	_r_null.push_back(r.nullable());
+	_dfas.push_back(NULL);
+	return _r_map[&r] = id;
+}
+
+void abnf_program::attach(abnf_rule_ri& r)
+{
+	r._prog_r = entry(r);
+	r._prog = this;
+}
+
+int abnf_program::string_id(const string& str)
+{
+	for (size_t i = 0; i < _strs.size(); ++i)
+		if (_strs[i] == str)
+			return i;
+	_strs.push_back(str);
+	return _strs.size() - 1;
+}
+
+int abnf_program::fn_id(int (*fn)(int))
+{
+	for (size_t i = 0; i < _fns.size(); ++i)
+		if (_fns[i] == fn)
+			return i;
+	_fns.push_back(fn);
+	return _fns.size() - 1;
+}
+
+int abnf_program::class_id(const abnf_charset& cs)
+{
+	_classes.push_back(cs);
+	return _classes.size() - 1;
+}
+
+int abnf_program::trie_id(const abnf_trie& trie)
+{
+	_tries.push_back(trie);
+	return _tries.size() - 1;
+}
+
+bool abnf_program::run(int r, const char* buf, size_t len, size_t& end,
+		vector<abnf_capture>& caps) const
+{
+	if (_jit not_eq NULL)
+	{
+		int m = _jit->run(r, buf, len, end, caps);
+		if (m >= 0)
+			return m > 0;
+	}
+	
+	int m = dfa_run(r, buf, 0, len, end, caps);
+	if (m >= 0)
+		return m > 0;
+	
+	abnf_vm vm(r, _r_pc[r]);
+	vm.caps.swap(caps);
+	m = exec(vm, buf, 0, len, true);
+	vm.caps.swap(caps);
+	end = vm.end;
+	return m > 0;
+}
+
+int abnf_program::exec(abnf_vm& vm, const char* buf, size_t base, size_t len,
+		bool last) const
+{
+	vector<abnf_frame>& f_vect = vm.f_vect;
+	vector<abnf_choice>& ch_vect = vm.ch_vect;
+	vector<abnf_capture>& caps = vm.caps;
+	vector<size_t>& idx = vm.idx;
+	
+	size_t pos = vm.pos;
+	int pc = vm.pc;
+	int f = vm.f;
+	
+	// Characters are read as buf[pos - base], and instructions needing those
+	// after len are suspended unless it is the last input
+	for (;;)
+	{
+		const abnf_instr& in = _code[pc];
+		bool matched = false;
+		
+		switch (in.op)
+		{
+			case ABNF_OP_FAIL:
+			break;
+			
+			case ABNF_OP_CHAR:
+			if (pos < len)
+				matched = (unsigned char) buf[pos - base] == in.a;
+			else if (not last)
+				return suspend(vm, pc, pos, f);
+			break;
+			
+			case ABNF_OP_RANGE:
+			if (pos < len)
+			{
+				unsigned char c = buf[pos - base];
+				matched = c >= in.a and c <= in.b;
+			}
+			else if (not last)
+				return suspend(vm, pc, pos, f);
+			break;
+			
+			case ABNF_OP_FN:
+			if (pos < len)
+				matched = _fns[in.a]((unsigned char) buf[pos - base]) > 0;
+			else if (not last)
+				return suspend(vm, pc, pos, f);
+			break;
+			
+			case ABNF_OP_CLASS:
+			if (pos < len)
+				matched = _classes[in.a].test(buf[pos - base]);
+			else if (not last)
+				return suspend(vm, pc, pos, f);
+			break;
+			
+			case ABNF_OP_STR:
+			{
+				const string& str = _strs[in.a];
+				if (str.empty())
+					break;
+				if (len - pos < str.size())
+				{
+					if (not last)
+						return suspend(vm, pc, pos, f);
+					break;
+				}
+				
+				const char* s = buf + (pos - base);
+				size_t i = 0;
+				while (i < str.size() and tolower((unsigned char) str[i]) ==
+						tolower((unsigned char) s[i]))
+					++i;
+				if (i < str.size())
+					break;
+				pos += str.size();
+				++pc;
+			}
+			continue;
+			
+			case ABNF_OP_EOF:
+			if (pos < len)
+				break;
+			if (not last)
+				return suspend(vm, pc, pos, f);
+			++pc;
+			continue;
+			
+			case ABNF_OP_CALL:
+			if (not vm.stream and _code[in.a].op == ABNF_OP_REP and
+					_code[in.a].c == ABNF_REPET_POSSESSIVE)
+			{
+				size_t n;
+				int m = dfa_run(in.b, buf, pos, len, n, caps);
+				if (m == 0)
+					break;
+				if (m > 0)
+				{
+					pos = n;
+					++pc;
+					continue;
+				}
+			}
+			f_vect.push_back(abnf_frame(f, pc + 1, in.b, pos, 0, pos,
+					ch_vect.size()));
+			f = f_vect.size() - 1;
+			pc = in.a;
+			continue;
+			
+			case ABNF_OP_RET:
+			{
+				// Segments nobody stores are skipped, except the one of the
+				// read rule
+				const abnf_frame& fr = f_vect[f];
+				if (pos > fr.beg and (_r_cap[fr.r] or fr.parent < 0))
+					caps.push_back(abnf_capture(fr.r, fr.beg, pos));
+				if (fr.parent < 0)
+				{
+					vm.end = pos;
+					return 1;
+				}
+				pc = fr.ret;
+				
+				// Release the frame if no backtracking point refers to it
+				int parent = fr.parent;
+				if (f == (int) f_vect.size() - 1 and (ch_vect.empty() or
+						ch_vect.back().f_count <= (size_t) f))
+					f_vect.pop_back();
+				f = parent;
+			}
+			continue;
+			
+			case ABNF_OP_CHOICE:
+			ch_vect.push_back(abnf_choice(in.a, pos, f, f_vect.size(),
+					caps.size()));
+			++pc;
+			continue;
+			
+			case ABNF_OP_JMP:
+			pc = in.a;
+			continue;
+			
+			case ABNF_OP_REP:
+			{
+				int count = f_vect[f].count;
+				if (count < in.a)
+					++pc;
+				else if (count >= in.b)
+					pc += 3;
+				else if (in.c == ABNF_REPET_LAZY)
+				{
+					ch_vect.push_back(abnf_choice(pc + 1, pos, f,
+							f_vect.size(), caps.size()));
+					pc += 3;
+				}
+				else if (in.c == ABNF_REPET_POSSESSIVE)
+				{
+					// Stopping here always succeeds, so previous occurrences
+					// are never retried, and the frame is moved over those
+					// only they refer to
+					ch_vect.erase(ch_vect.begin() + f_vect[f].cut,
+							ch_vect.end());
+					size_t f_count = f_vect[f].parent + 1;
+					if (not ch_vect.empty())
+						f_count = max(f_count, ch_vect.back().f_count);
+					if (f_count < (size_t) f)
+					{
+						f_vect[f_count] = f_vect[f];
+						f = f_count;
+					}
+					f_vect.resize(f + 1, f_vect.front());
+					ch_vect.push_back(abnf_choice(pc + 3, pos, f,
+							f_vect.size(), caps.size()));
+					++pc;
+				}
+				else
+				{
+					ch_vect.push_back(abnf_choice(pc + 3, pos, f,
+							f_vect.size(), caps.size()));
+					++pc;
+				}
+			}
+			continue;
+			
+			case ABNF_OP_LOOP:
+			{
+				abnf_frame fr = f_vect[f];
+				
+				// Empty occurrences beyond the minimum lead nowhere new
+				if (pos == fr.iter and fr.count >= _code[in.a].a)
+					break;
+				
+				++fr.count;
+				fr.iter = pos;
+				if (f == (int) f_vect.size() - 1 and (ch_vect.empty() or
+						ch_vect.back().f_count <= (size_t) f))
+					f_vect[f] = fr;
+				else
+				{
+					f_vect.push_back(fr);
+					f = f_vect.size() - 1;
+				}
+				pc = in.a;
+			}
+			continue;
+			
+			case ABNF_OP_RUN:
+			{
+				size_t max = min(len - pos, (size_t) in.c);
+				size_t n = _classes[in.a].span(buf + (pos - base), max);
+				if (n == len - pos and n < (size_t) in.c and not last)
+					return suspend(vm, pc, pos, f);
+				if (n < (size_t) in.b)
+					break;
+				
+				// The frame was just created by the call to this rule, so no
+				// backtracking point refers to it yet
+				f_vect[f].iter = pos + n;
+				pos += in.b;
+				if (pos < f_vect[f].iter)
+					ch_vect.push_back(abnf_choice(pc + 1, pos, f,
+							f_vect.size(), caps.size()));
+				pc += 2;
+			}
+			continue;
+			
+			case ABNF_OP_MORE:
+			++pos;
+			if (pos < f_vect[f].iter)
+				ch_vect.push_back(abnf_choice(pc, pos, f, f_vect.size(),
+						caps.size()));
+			++pc;
+			continue;
+			
+			case ABNF_OP_SPAN:
+			{
+				size_t max = min(len - pos, (size_t) in.c);
+				size_t n = _classes[in.a].span(buf + (pos - base), max);
+				if (n == len - pos and n < (size_t) in.c and not last)
+					return suspend(vm, pc, pos, f);
+				if (n < (size_t) in.b)
+					break;
+				pos += n;
+				++pc;
+			}
+			continue;
+			
+			case ABNF_OP_LESS:
+			if (pos > f_vect[f].beg + in.a)
+				ch_vect.push_back(abnf_choice(pc, pos - 1, f, f_vect.size(),
+						caps.size()));
+			++pc;
+			continue;
+			
+			case ABNF_OP_CUT:
+			ch_vect.erase(ch_vect.begin() + f_vect[f].cut, ch_vect.end());
+			++pc;
+			continue;
+			
+			case ABNF_OP_TEST:
+			if (pos < len and _classes[in.a].test(buf[pos - base]))
+				++pc;
+			else if (pos >= len and not last)
+				return suspend(vm, pc, pos, f);
+			else
+				pc = in.b;
+			continue;
+			
+			case ABNF_OP_CAP:
+			if (pos > f_vect[f].beg and _r_cap[in.a])
+				caps.push_back(abnf_capture(in.a, f_vect[f].beg, pos));
+			++pc;
+			continue;
+			
+			case ABNF_OP_TRIE:
+			{
+				const abnf_trie& trie = _tries[in.a];
+				if (not last)
+				{
+					// Longer strings may match with more input
+					size_t i = 0;
+					while (i < trie.size() and trie.length(i) <= len - pos)
+						++i;
+					if (i < trie.size())
+						return suspend(vm, pc, pos, f);
+				}
+				
+				idx.clear();
+				trie.find(buf + (pos - base), len - pos, idx);
+				if (idx.empty())
+					break;
+				
+				// Next strings are retried in increasing index order
+				for (size_t i = idx.size() - 1; i > 0; --i)
+					ch_vect.push_back(abnf_choice(pc + 1 + idx[i],
+							pos + trie.length(idx[i]), f, f_vect.size(),
+							caps.size()));
+				pos += trie.length(idx.front());
+				pc += 1 + idx.front();
+			}
+			continue;
+		}
+		
+		if (matched)
+		{
+			++pos;
+			++pc;
+			continue;
+		}
+		
+		// Backtrack
+		if (ch_vect.empty())
+			return 0;
+		const abnf_choice& ch = ch_vect.back();
+		pc = ch.pc;
+		pos = ch.pos;
+		f = ch.f;
+		f_vect.resize(ch.f_count, f_vect.front());
+		caps.resize(ch.cap_count, abnf_capture(-1, 0, 0));
+		ch_vect.pop_back();
+	}
+}
+
+int abnf_program::dfa_run(int r, const char* buf, size_t beg, size_t len,
+		size_t& end, vector<abnf_capture>& caps) const
+{
+	abnf_dfa* dfa = abnf_load(_dfas[r]);
+	if (dfa == NULL)
+	{
+		_dfa_lock.acquire();
+		dfa = _dfas[r];
+		if (dfa == NULL)
+		{
+			dfa = new abnf_dfa(*this, r);
+			abnf_store(_dfas[r], dfa);
+		}
+		_dfa_lock.release();
+	}
+	return dfa->run(buf, beg, len, end, caps);
+}
+
+void abnf_program::read(int r, istream& is) const
+{
+	streampos beg = is.tellg();
+	string buf;
+	size_t end = 0;
+	vector<abnf_capture> caps;
+	if (stream_run(r, is, buf, end, caps))
+		segments_add(buf.data(), caps, beg);
+}
+
+size_t abnf_program::read(int r, istream& is, abnf_result& res) const
+{
+	size_t end = 0;
+	vector<abnf_capture> caps;
+	if (not stream_run(r, is, res._str, end, caps))
+		return 0;
+	
+	segments_add(res._str.data(), caps, 0, res);
+	return end;
+}
+
+size_t abnf_program::read(int r, const char* buf, size_t len) const
+{
+	size_t end = 0;
+	vector<abnf_capture> caps;
+	if (not run(r, buf, len, end, caps))
+		return abnf_rule::npos;
+	segments_add(buf, caps, 0);
+	return end;
+}
+
+size_t abnf_program::read(int r, const char* buf, size_t len,
+		abnf_result& res) const
+{
+	size_t end = 0;
+	vector<abnf_capture> caps;
+	if (not run(r, buf, len, end, caps))
+		return abnf_rule::npos;
+	
+	segments_add(buf, caps, 0, res);
+	return end;
+}
+
+size_t abnf_program::scan(int r, const char* buf, size_t len, size_t& end,
+		abnf_result& res) const
+{
+	// Unless the rule is nullable, matches only begin with its first
+	// characters, so others are skipped. A single one is found by memchr
+	const abnf_charset skip = ~_r_first[r];
+	int c = _r_null[r] ? -1 : _r_first[r].single();
+	
+	size_t n = 0;
+	size_t pos = 0;
+	vector<abnf_capture> caps;
+	end = 0;
+	while (pos < len)
+	{
+		if (c >= 0)
+		{
+			const char* p = (const char*) memchr(buf + pos, c, len - pos);
+			if (p == NULL)
+				break;
+			pos = p - buf;
+		}
+		else if (not _r_null[r])
+		{
+			pos += skip.span(buf + pos, len - pos);
+			if (pos == len)
+				break;
+		}
+		
+		// Empty matches are not reported, and would not advance
+		size_t m_end = 0;
+		caps.clear();
+		if (not run(r, buf + pos, len - pos, m_end, caps) or m_end == 0)
+		{
+			++pos;
+			continue;
+		}
+		
+		segments_add(buf + pos, caps, pos, res);
+		_rules[r]->match_add(res, pos, pos + m_end);
+		
+		++n;
+		pos += m_end;
+		end = pos;
+	}
+	return n;
+}
+
+bool abnf_program::stream_run(int r, istream& is, string& buf, size_t& end,
+		vector<abnf_capture>& caps) const
+{
+	// The stream is read in chunks, as far as the result depends on it, by
+	// a streamed run which suspends when it needs more input
+	streampos beg = is.tellg();
+	abnf_vm vm(r, _r_pc[r], true);
+	char chunk[4096];
+	int m = -1;
+	while (m < 0)
+	{
+		is.read(chunk, sizeof (chunk));
+		size_t n = is.gcount();
+		buf.append(chunk, n);
+		m = exec(vm, buf.data(), 0, buf.size(), n < sizeof (chunk));
+	}
+	
+	end = m > 0 ? vm.end : 0;
+	caps.swap(vm.caps);
+	is.clear();
+	is.seekg(beg + streamoff(end));
+	return m > 0;
+}
+
+void abnf_program::segments_add(const char* buf,
+		const vector<abnf_capture>& caps, streampos beg) const
+{
+	vector<abnf_capture>::const_iterator it = caps.begin();
+	while (it not_eq caps.end())
+	{
+		_rules[it->r]->fused_segment_add(buf + it->beg,
+				beg + streamoff(it->beg), beg + streamoff(it->end));
+		++it;
+	}
+}
+
+void abnf_program::segments_add(const char* buf,
+		const vector<abnf_capture>& caps, size_t beg, abnf_result& res) const
+{
+	vector<abnf_capture>::const_iterator it = caps.begin();
+	while (it not_eq caps.end())
+	{
+		_rules[it->r]->fused_segment_add(res, buf + it->beg, beg + it->beg,
+				beg + it->end);
+		++it;
+	}
+}
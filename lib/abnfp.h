@@ -0,0 +1,500 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef ABNFP_H
+#define ABNFP_H
+
+#include <string>
+#include <vector>
+
+#include "abnfd.h"
+#include "abnfr.h"
+
+namespace xspider {
+
+class abnf_jit;
+
+/*
+ * Program operation codes.
+ *
+ * Every compiled rule is a subroutine ending with RET, called through CALL.
+ * Those operations testing input characters fail when the input is
+ * exhausted. A failure makes the program backtrack to the last CHOICE.
+ */
+enum abnf_opcode
+{
+	ABNF_OP_FAIL,
+	ABNF_OP_CHAR,
+	ABNF_OP_RANGE,
+	ABNF_OP_FN,
+	ABNF_OP_CLASS,
+	ABNF_OP_STR,
+	ABNF_OP_EOF,
+	ABNF_OP_CALL,
+	ABNF_OP_RET,
+	ABNF_OP_CHOICE,
+	ABNF_OP_JMP,
+	ABNF_OP_REP,
+	ABNF_OP_LOOP,
+	ABNF_OP_RUN,
+	ABNF_OP_MORE,
+	ABNF_OP_SPAN,
+	ABNF_OP_LESS,
+	ABNF_OP_CUT,
+	ABNF_OP_TEST,
+	ABNF_OP_CAP,
+	ABNF_OP_TRIE
+};
+
+/*
+ * Program instruction.
+ *
+ *		FAIL			fails
+ *		CHAR c			matches c character
+ *		RANGE ci ce		matches any character in [ci,ce]
+ *		FN fn			matches any character accepted by fn function
+ *		CLASS cs		matches any character of cs character set
+ *		STR str			matches case insensitive str string
+ *		EOF				matches the end of input
+ *		CALL pc r		calls r rule at pc
+ *		RET				returns from current rule, storing its segment
+ *		CHOICE pc		continues at pc when backtracking
+ *		JMP pc			continues at pc
+ *		REP min max m	repeats next CALL in m mode, lazily or greedily once
+ *						min is reached
+ *		LOOP pc			counts an occurrence and continues at REP pc
+ *		RUN cs min max	matches min characters of cs, lazily followed by the
+ *						next MORE up to max characters
+ *		MORE			matches one more character of the current RUN
+ *		SPAN cs min max	matches the longest run of cs characters, of at least
+ *						min and up to max characters
+ *		LESS min		matches one less character of the current SPAN, down
+ *						to min characters, when backtracking
+ *		CUT				drops the backtracking points of the current rule
+ *		TEST cs pc		continues at pc unless the next character is in cs
+ *		CAP r			stores the segment of r rule from the begin of the
+ *						current rule
+ *		TRIE t			matches the first string of t trie beginning the
+ *						input and continues at the nth next instruction, n
+ *						being its index, or at those of the next strings
+ *						when backtracking
+ */
+class abnf_instr
+{
+	public:
+	
+	/*
+	 * Initialized instruction.
+	 */
+	abnf_instr(abnf_opcode op, int a = 0, int b = 0, int c = 0):
+	op(op),
+	a(a),
+	b(b),
+	c(c)
+	{
+	}
+	
+	abnf_opcode op;
+	int a, b, c;
+};
+
+/*
+ * Input segment matching a compiled rule.
+ */
+class abnf_capture
+{
+	public:
+	
+	/*
+	 * Initialized capture.
+	 */
+	abnf_capture(int r, size_t beg, size_t end):
+	r(r),
+	beg(beg),
+	end(end)
+	{
+	}
+	
+	int r;
+	size_t beg, end;
+};
+
+/*
+ * Called rule frame. Frames referred by a backtracking point are never
+ * modified, since they may be restored by backtracking. Instead, LOOP pushes
+ * a modified copy, and only modifies the last frame in place if no point
+ * refers to it, as RUN does with the frame just created by its rule call.
+ */
+class abnf_frame
+{
+	public:
+	
+	/*
+	 * Initialized frame.
+	 */
+	abnf_frame(int parent, int ret, int r, size_t beg, int count,
+			size_t iter, size_t cut):
+	parent(parent),
+	ret(ret),
+	r(r),
+	beg(beg),
+	count(count),
+	iter(iter),
+	cut(cut)
+	{
+	}
+	
+	int parent;
+	int ret;
+	int r;
+	size_t beg;
+	int count;
+	size_t iter;
+	size_t cut;
+};
+
+/*
+ * Backtracking point.
+ */
+class abnf_choice
+{
+	public:
+	
+	/*
+	 * Initialized backtracking point.
+	 */
+	abnf_choice(int pc, size_t pos, int f, size_t f_count, size_t cap_count):
+	pc(pc),
+	pos(pos),
+	f(f),
+	f_count(f_count),
+	cap_count(cap_count)
+	{
+	}
+	
+	int pc;
+	size_t pos;
+	int f;
+	size_t f_count;
+	size_t cap_count;
+};
+
+/*
+ * State of an interpreted run, which is suspended at the end of the input
+ * given so far if more may follow, and resumed with it. Positions are offsets
+ * from the beginning of the whole input.
+ */
+class abnf_vm
+{
+	public:
+	
+	/*
+	 * State calling the rule with index r, whose instructions begin at pc.
+	 * Streamed runs do not use automata, which need the whole input.
+	 */
+	abnf_vm(int r, int pc, bool stream = false):
+	pc(pc),
+	pos(0),
+	f(0),
+	end(0),
+	stream(stream)
+	{
+		f_vect.push_back(abnf_frame(-1, -1, r, 0, 0, 0, 0));
+	}
+	
+	int pc;
+	size_t pos;
+	int f;
+	size_t end;
+	bool stream;
+	std::vector<abnf_frame> f_vect;
+	std::vector<abnf_choice> ch_vect;
+	std::vector<abnf_capture> caps;
+	std::vector<size_t> idx;
+};
+
+/*
+ * Rules compiled to a flat instruction array, and its interpreter.
+ */
+class abnf_program
+{
+	public:
+	
+	/*
+	 * Empty program.
+	 */
+	abnf_program(void);
+	
+	/*
+	 * Release automata.
+	 */
+	~abnf_program(void);
+	
+	/*
+	 * Index of the given rule in this program. It is compiled through
+	 * compile_impl if it was not yet.
+	 */
+	int entry(abnf_rule_ri& r);
+	
+	/*
+	 * Compiles the given rule through entry, and makes its read operations
+	 * run this program. Rules of included rule sets are not attached, since
+	 * they are read through their owners.
+	 *
+	 * Postcondition:
+	 *		r.program() is this program
+	 */
+	void attach(abnf_rule_ri& r);
+	
+	/*
+	 * Address of the first instruction of the rule with index r.
+	 */
+	int entry_pc(int r) const
+	{
+		return _r_pc[r];
+	}
+	
+	/*
+	 * Address of the next instruction to be emitted.
+	 */
+	int size(void) const
+	{
+		return _code.size();
+	}
+	
+	/*
+	 * Append an instruction.
+	 */
+	void emit(abnf_opcode op, int a = 0, int b = 0, int c = 0)
+	{
+		_code.push_back(abnf_instr(op, a, b, c));
+	}
+	
+	/*
+	 * Append a call to the rule with index r.
+	 */
+	void emit_call(int r)
+	{
+		emit(ABNF_OP_CALL, _r_pc[r], r);
+	}
+	
+	/*
+	 * Index of the given string in the string pool.
+	 */
+	int string_id(const std::string& str);
+	
+	/*
+	 * Index of the given function in the function pool.
+	 */
+	int fn_id(int (*fn)(int));
+	
+	/*
+	 * Index of the given character set in the character set pool.
+	 */
+	int class_id(const abnf_charset& cs);
+	
+	/*
+	 * Index of the given trie in the trie pool.
+	 */
+	int trie_id(const abnf_trie& trie);
+	
+	/*
+	 * Writes to hs and cs the C++ header and source of a parser of the rule
+	 * with index r, whose functions and types are prefixed by name. Segments
+	 * of the given named rules are stored.
+	 */
+	void generate(int r, const std::map<std::string, abnf_rule_ri*>& names,
+			const std::string& name, std::ostream& hs, std::ostream& cs) const;
+	
+	/*
+	 * Translates this program to native code, if it is supported and was not
+	 * translated yet.
+	 */
+	void jit(void);
+	
+	/*
+	 * Matches the rule with index r against the len characters of buf. Its
+	 * native code is run first, if translated, then its automaton, and the
+	 * program is interpreted if both give up. Calls to possessive repetitions
+	 * run their automata as well, since they match once.
+	 *
+	 * Returns true if it matches; false otherwise.
+	 *
+	 * Postcondition:
+	 *		end is the matching length, if it matches
+	 *		caps contains the non empty segments of the matching rules
+	 */
+	bool run(int r, const char* buf, size_t len, size_t& end,
+			std::vector<abnf_capture>& caps) const;
+	
+	/*
+	 * Interprets the program from the state of vm against the characters of
+	 * buf, which are those from base to len of the input. If last, there is
+	 * no more input after them.
+	 *
+	 * Returns 1 if it matches, 0 if it does not, or -1 if the result depends
+	 * on more input, suspending vm at the instruction needing it.
+	 *
+	 * Postcondition:
+	 *		vm.end is the matching length, if it matches
+	 *		vm.caps contains the non empty segments of the matching rules
+	 */
+	int exec(abnf_vm& vm, const char* buf, size_t base, size_t len,
+			bool last) const;
+	
+	/*
+	 * Matches the rule with index r from the current position of the given
+	 * stream, adding the matching segments to their rules.
+	 *
+	 * Postcondition:
+	 *		is.tellg() is the end of matching, or is'.tellg() if it does not
+	 *		match
+	 */
+	void read(int r, std::istream& is) const;
+	
+	/*
+	 * Matches the rule with index r from the current position of the given
+	 * stream, adding the matching segments to res instead of their rules.
+	 * The characters read are appended to res._str, and positions are
+	 * offsets from the initial stream position.
+	 *
+	 * Returns the matching length, or zero if it does not match.
+	 *
+	 * Postcondition:
+	 *		is.tellg() is the end of matching, or is'.tellg() if it does not
+	 *		match
+	 */
+	size_t read(int r, std::istream& is, abnf_result& res) const;
+	
+	/*
+	 * Matches the rule with index r against the len characters of buf,
+	 * adding the matching segments to their rules.
+	 *
+	 * Returns the matching length, or abnf_rule::npos if it does not match.
+	 */
+	size_t read(int r, const char* buf, size_t len) const;
+	
+	/*
+	 * Matches the rule with index r against the len characters of buf,
+	 * adding the matching segments to res instead of their rules.
+	 *
+	 * Returns the matching length, or abnf_rule::npos if it does not match.
+	 */
+	size_t read(int r, const char* buf, size_t len, abnf_result& res) const;
+	
+	/*
+	 * Matches the rule with index r along the len characters of buf, from
+	 * the end of each match, adding the segments of every match to res.
+	 * Positions where the rule can not begin are skipped through its first
+	 * characters.
+	 *
+	 * Returns the number of matches.
+	 *
+	 * Postcondition:
+	 *		end is the end of the last match, or zero if there is none
+	 */
+	size_t scan(int r, const char* buf, size_t len, size_t& end,
+			abnf_result& res) const;
+	
+	/*
+	 * Adds the given captures of buf to res instead of their rules, as
+	 * segments starting at beg.
+	 */
+	void segments_add(const char* buf, const std::vector<abnf_capture>& caps,
+			size_t beg, abnf_result& res) const;
+	
+	private:
+	
+	std::vector<abnf_instr> _code;
+	std::vector<std::string> _strs;
+	std::vector<int (*)(int)> _fns;
+	std::vector<abnf_charset> _classes;
+	std::vector<abnf_trie> _tries;
+	std::vector<abnf_rule_ri*> _rules;
+	std::vector<int> _r_pc;
+	std::vector<bool> _r_cap;
+	std::vector<abnf_charset> _r_first;
+	std::vector<bool> _r_null;
+	std::map<const abnf_rule_ri*, int> _r_map;
+	mutable std::vector<abnf_dfa*> _dfas;
+	mutable abnf_lock _dfa_lock;
+	abnf_jit* _jit;
+	
+	/*
+	 * Runs the automaton of the rule with index r from beg, building it if
+	 * needed.
+	 *
+	 * Returns as abnf_dfa::run does.
+	 */
+	int dfa_run(int r, const char* buf, size_t beg, size_t len, size_t& end,
+			std::vector<abnf_capture>& caps) const;
+	
+	/*
+	 * Runs the rule with index r from the current position of the given
+	 * stream, which is read in chunks appended to buf until the result does
+	 * not depend on more input. Positions are offsets from the initial
+	 * stream position.
+	 *
+	 * Returns true if it matches; false otherwise.
+	 *
+	 * Postcondition:
+	 *		end is the matching length, if it matches
+	 *		caps contains the non empty segments of the matching rules
+	 *		is.tellg() is the end of matching, or is'.tellg() if it does not
+	 *		match
+	 */
+	bool stream_run(int r, std::istream& is, std::string& buf, size_t& end,
+			std::vector<abnf_capture>& caps) const;
+	
+	/*
+	 * Saves the position of a run which needs more input to vm.
+	 *
+	 * Returns -1, as exec does.
+	 */
+	int suspend(abnf_vm& vm, int pc, size_t pos, int f) const
+	{
+		vm.pc = pc;
+		vm.pos = pos;
+		vm.f = f;
+		return -1;
+	}
+	
+	/*
+	 * Adds the given captures of buf to their rules, as segments starting at
+	 * beg.
+	 */
+	void segments_add(const char* buf, const std::vector<abnf_capture>& caps,
+			std::streampos beg) const;
+	
+	/*
+	 * Automata and native code read the program.
+	 */
+	friend class abnf_dfa;
+	friend class abnf_jit;
+	
+	/*
+	 * Parsers run programs incrementally.
+	 */
+	friend class abnf_parser;
+};
+
+} // namespace xspider
+
+#endif // ABNFP_H
@@ -0,0 +1,180 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "abnfp.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * abnf_parser implementation
+ */
+
+abnf_parser::abnf_parser(const abnf_rule& r):
+_prog(abnf_rule_ri::cast(const_cast<abnf_rule&>(r)).program()),
+_vm(NULL),
+_base(0),
+_m(-1),
+_hold_root(false)
+{
+	if (_prog == NULL)
+		throw logic_error("rule not compiled");
+	
+	int id = abnf_rule_ri::cast(const_cast<abnf_rule&>(r))._prog_r;
+	_vm = new abnf_vm(id, _prog->_r_pc[id], true);
+	
+	// The characters of a rule being matched are needed if its segment is
+	// reported, or if it stores segments of other rules from its begin. The
+	// segment of the read rule is given by length instead.
+	_held.resize(_prog->_rules.size(), false);
+	for (size_t i = 0; i < _held.size(); ++i)
+	{
+		bool cap = false;
+		int pc = _prog->_r_pc[i];
+		while (_prog->_code[pc].op not_eq ABNF_OP_RET)
+		{
+			if (_prog->_code[pc].op == ABNF_OP_CAP)
+				cap = true;
+			++pc;
+		}
+		_held[i] = cap or _prog->_r_cap[i];
+		if ((int) i == id)
+			_hold_root = cap;
+	}
+}
+
+abnf_parser::~abnf_parser(void)
+{
+	delete _vm;
+}
+
+bool abnf_parser::feed(const char* buf, size_t len)
+{
+	if (_m >= 0)
+		return false;
+	
+	_buf.append(buf, len);
+	_m = _prog->exec(*_vm, _buf.data(), _base, _base + _buf.size(), false);
+	settle();
+	return _m < 0;
+}
+
+bool abnf_parser::finish(void)
+{
+	if (_m < 0)
+	{
+		_m = _prog->exec(*_vm, _buf.data(), _base, _base + _buf.size(), true);
+		settle();
+	}
+	return _m > 0;
+}
+
+size_t abnf_parser::length(void) const
+{
+	return _m > 0 ? _vm->end : 0;
+}
+
+size_t abnf_parser::buffered(void) const
+{
+	return _buf.size();
+}
+
+void abnf_parser::segment(const abnf_rule& r, const char* s, size_t beg,
+		size_t end)
+{
+}
+
+void abnf_parser::settle(void)
+{
+	vector<abnf_frame>& f_vect = _vm->f_vect;
+	vector<abnf_choice>& ch_vect = _vm->ch_vect;
+	vector<abnf_capture>& caps = _vm->caps;
+	
+	// Those left by a failure belong to the last attempt
+	if (_m == 0)
+		caps.clear();
+	
+	// Segments below the first backtracking point are final
+	size_t n = caps.size();
+	if (_m < 0 and not ch_vect.empty())
+		n = ch_vect.front().cap_count;
+	for (size_t i = 0; i < n; ++i)
+	{
+		const abnf_capture& cap = caps[i];
+		const abnf_rule_ri* r = _prog->_rules[cap.r];
+		_res.clear();
+		
+		// The segment of the read rule is the last one, and it is given by
+		// length instead. Its characters may be released, but those of the
+		// rules it fused are its first one.
+		bool root = _m > 0 and _vm->end > 0 and i == n - 1;
+		const char* s = NULL;
+		if (cap.beg >= _base)
+			s = _buf.data() + (cap.beg - _base);
+		r->fused_segment_add(_res, s, cap.beg, cap.end);
+		
+		abnf_segment_map::const_iterator it = _res._seg_map->begin();
+		while (it not_eq _res._seg_map->end())
+		{
+			if (not (root and it->first == r))
+			{
+				vector<abnf_segment>::const_iterator s_it =
+						it->second.begin();
+				while (s_it not_eq it->second.end())
+				{
+					segment(*it->first, s + (s_it->beg() - cap.beg),
+							s_it->beg(), s_it->end());
+					++s_it;
+				}
+			}
+			++it;
+		}
+	}
+	caps.erase(caps.begin(), caps.begin() + n);
+	for (size_t i = 0; i < ch_vect.size(); ++i)
+		ch_vect[i].cap_count -= n;
+	
+	if (_m >= 0)
+	{
+		string().swap(_buf);
+		return;
+	}
+	
+	// Characters before those which backtracking may read again, and those of
+	// pending segments or of rules being matched whose characters are needed
+	// (the read one only by its frames without parent, copies included), are
+	// released once they are half the buffer, keeping it amortized
+	size_t low = _vm->pos;
+	for (size_t i = 0; i < ch_vect.size(); ++i)
+		low = min(low, ch_vect[i].pos);
+	for (size_t i = 0; i < f_vect.size(); ++i)
+		if (f_vect[i].parent < 0 ? _hold_root : _held[f_vect[i].r])
+			low = min(low, f_vect[i].beg);
+	for (size_t i = 0; i < caps.size(); ++i)
+		low = min(low, caps[i].beg);
+	if (low > _base and low - _base >= _buf.size() / 2)
+	{
+		_buf.erase(0, low - _base);
+		_base = low;
+	}
+}
@@ -18,20 +18,143 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
  */
 
+
 #include "abnfm.h"
+#include "abnfp.h"
 
 using namespace std;
 using namespace xspider;
 
+/*
+ * abnf_membuf implementation
+ */
+
+namespace xspider {
+
+/*
+ * Read only stream buffer on to a character buffer, without copying it.
+ */
+class abnf_membuf:
+public streambuf
+{
+	public:
+	
+	/*
+	 * Stream buffer on to the len characters of buf.
+	 */
+	abnf_membuf(const char* buf, size_t len)
+	{
+		char* p = const_cast<char*>(buf);
+		setg(p, p, p + len);
+	}
+	
+	protected:
+	
+	/*
+	 * Seek operation relative to the given direction.
+	 */
+	pos_type seekoff(off_type off, ios_base::seekdir dir,
+			ios_base::openmode which = ios_base::in)
+	{
+		if (dir == ios_base::cur)
+			off += gptr() - eback();
+		else if (dir == ios_base::end)
+			off += egptr() - eback();
+		return seekpos(pos_type(off), which);
+	}
+	
+	/*
+	 * Seek operation to an absolute position.
+	 */
+	pos_type seekpos(pos_type pos, ios_base::openmode which = ios_base::in)
+	{
+		off_type off = pos;
+		if (not (which & ios_base::in) or off < 0 or off > egptr() - eback())
+			return pos_type(off_type(-1));
+		setg(eback(), eback() + off, egptr());
+		return pos;
+	}
+};
+
+} // namespace xspider
+
+/*
+ * abnf_result implementation
+ */
+
+abnf_result::abnf_result(void):
+_buf(NULL),
+_len(0),
+_seg_map(new abnf_segment_map),
+_data(NULL),
+_act(false)
+{
+}
+
+abnf_result::abnf_result(void* data):
+_buf(NULL),
+_len(0),
+_seg_map(new abnf_segment_map),
+_data(data),
+_act(true)
+{
+}
+
+abnf_result::~abnf_result(void)
+{
+	delete _seg_map;
+}
+
+size_t abnf_result::length(void) const
+{
+	return _len;
+}
+
+size_t abnf_result::read_count(const abnf_rule& r) const
+{
+	abnf_segment_map::const_iterator it = _seg_map->find(&r);
+	return it == _seg_map->end() ? 0 : it->second.size();
+}
+
+void abnf_result::write(const abnf_rule& r, size_t n, ostream& os) const
+{
+	abnf_segment_map::const_iterator it = _seg_map->find(&r);
+	if (it == _seg_map->end() or n >= it->second.size())
+		return;
+	it->second[n].write(_buf, os);
+}
+
+abnf_span abnf_result::span(const abnf_rule& r, size_t n) const
+{
+	abnf_segment_map::const_iterator it = _seg_map->find(&r);
+	if (it == _seg_map->end() or n >= it->second.size())
+		return abnf_span();
+	return it->second[n].span(_buf);
+}
+
+void abnf_result::clear(void)
+{
+	_buf = NULL;
+	_len = 0;
+	_str.clear();
+	_seg_map->clear();
+}
+
 /*
  * abnf_rule implementation
  */
 
+const size_t abnf_rule::npos;
+
 abnf_rule::abnf_rule(const abnf_ruleset& rset):
 _rset(rset)
 {
 }
 
+abnf_rule::~abnf_rule(void)
+{
+}
+
 const abnf_ruleset& abnf_rule::ruleset(void) const
 {
 	return _rset;
@@ -41,24 +164,104 @@ const abnf_ruleset& abnf_rule::ruleset(void) const
  * abnf_rule_ri implementation
  */
 
+__thread vector<abnf_rule_segment>* abnf_rule_ri::_seg_rec = NULL;
+
+void* abnf_rule_ri::operator new(size_t size, const abnf_ruleset& rset)
+{
+	return rset._r_arena->alloc(size);
+}
+
 void abnf_rule_ri::clear()
 {
 	clear_impl();
 	
 	_is = NULL;
+	_buf = NULL;
 	_seg_vect.clear();
+	memo_clear();
 }
 
 void abnf_rule_ri::read(istream& is)
 {
-	stream_update(is);
+	stream_update(&is, NULL);
+	
+	if (_prog not_eq NULL)
+	{
+		_prog->read(_prog_r, is);
+		return;
+	}
 	
 	abnf_matcher* m = matcher_new();
 	if (m->match(is))
 		m->commit();
 	else
+	{
+		is.clear();
 		is.seekg(m->stream_beg());
+	}
+	delete m;
+	matcher_release();
+}
+
+size_t abnf_rule_ri::read(const char* buf, size_t len)
+{
+	stream_update(NULL, buf);
+	
+	if (_prog not_eq NULL)
+		return _prog->read(_prog_r, buf, len);
+	
+	abnf_membuf mb(buf, len);
+	istream is(&mb);
+	abnf_matcher* m = matcher_new();
+	size_t end = npos;
+	if (m->match(is))
+	{
+		m->commit();
+		is.clear();
+		end = is.tellg();
+	}
 	delete m;
+	matcher_release();
+	return end;
+}
+
+void abnf_rule_ri::read(istream& is, abnf_result& res) const
+{
+	if (_prog == NULL)
+		throw logic_error("rule not compiled");
+	
+	res.clear();
+	res._len = _prog->read(_prog_r, is, res);
+	res._buf = res._str.data();
+}
+
+size_t abnf_rule_ri::read(const char* buf, size_t len, abnf_result& res) const
+{
+	if (_prog == NULL)
+		throw logic_error("rule not compiled");
+	
+	res.clear();
+	res._buf = buf;
+	size_t end = _prog->read(_prog_r, buf, len, res);
+	if (end not_eq npos)
+		res._len = end;
+	return end;
+}
+
+size_t abnf_rule_ri::scan(const char* buf, size_t len, abnf_result& res) const
+{
+	if (_prog == NULL)
+		throw logic_error("rule not compiled");
+	
+	res.clear();
+	res._buf = buf;
+	return _prog->scan(_prog_r, buf, len, res._len, res);
+}
+
+void abnf_rule_ri::matcher_release(void)
+{
+	stream_update(_is, _buf);
+	arena_reset();
 }
 
 size_t abnf_rule_ri::read_count(void) const
@@ -68,6 +271,34 @@ size_t abnf_rule_ri::read_count(void) const
 
 void abnf_rule_ri::write(size_t n, ostream& os) const
 {
-	if (_is not_eq NULL and n >= 0 and n < _seg_vect.size())
+	if (n < 0 or n >= _seg_vect.size())
+		return;
+	if (_buf not_eq NULL)
+		_seg_vect[n].write(_buf, os);
+	else if (_is not_eq NULL)
 		_seg_vect[n].write(*_is, os);
 }
+
+abnf_span abnf_rule_ri::span(size_t n) const
+{
+	if (n >= _seg_vect.size())
+		return abnf_span();
+	return _seg_vect[n].span(_buf);
+}
+
+bool abnf_rule_ri::same(abnf_rule_ri& r)
+{
+	if (&r == this)
+		return true;
+	if (&body() not_eq &r.body() or not plain() or not r.plain())
+		return false;
+	
+	// Equal bodies have as many children
+	vector<abnf_rule_ri*> ch, r_ch;
+	children(ch);
+	r.children(r_ch);
+	for (size_t i = 0; i < ch.size(); ++i)
+		if (not ch[i]->same(*r_ch[i]))
+			return false;
+	return true;
+}
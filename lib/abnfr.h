@@ -21,17 +21,26 @@
 #ifndef ABNFR_H
 #define ABNFR_H
 
+#include <algorithm>
+#include <map>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+#include <stdint.h>
+
 #include "abnf.h"
 
 namespace xspider {
 
+class abnf_arena;
 class abnf_matcher;
+class abnf_memo;
+class abnf_program;
 
 /*
- * Stream segment, with begin and end positions, begin included.
+ * Stream segment, with begin and end positions, begin included. Positions are
+ * stored as 32-bit offsets, so inputs longer than 4 GiB are not supported.
  */
 class abnf_segment
 {
@@ -41,8 +50,8 @@ class abnf_segment
 	 * Uninitialized empty segment.
 	 */
 	abnf_segment(void):
-	_beg(0l),
-	_end(0l)
+	_beg(0),
+	_len(0)
 	{
 	}
 	
@@ -53,9 +62,34 @@ class abnf_segment
 	 *		0 ≤ beg < end
 	 */
 	abnf_segment(std::streampos beg, std::streampos end):
-	_beg(beg),
-	_end(end)
+	_beg(std::streamoff(beg)),
+	_len(end - beg)
+	{
+	}
+	
+	/*
+	 * Begin position.
+	 */
+	size_t beg(void) const
+	{
+		return _beg;
+	}
+	
+	/*
+	 * End position.
+	 */
+	size_t end(void) const
 	{
+		return (size_t) _beg + _len;
+	}
+	
+	/*
+	 * Span of this segment, with the characters of the given buffer, if it is
+	 * not null.
+	 */
+	abnf_span span(const char* buf) const
+	{
+		return abnf_span(buf == NULL ? NULL : buf + _beg, _beg, _len);
 	}
 	
 	/*
@@ -68,16 +102,319 @@ class abnf_segment
 	void write(std::istream& is, std::ostream& os) const
 	{
 		std::streampos pos = is.tellg();
-		char c;
-		is.seekg(_beg);
-		while (is.good() and os.good() and is.tellg() < _end)
-			os.put((is.get(c), c));
+		char buf[256];
+		size_t n = _len;
+		is.seekg(std::streamoff(_beg));
+		while (n > 0 and is.good() and os.good())
+		{
+			is.read(buf, std::min(n, sizeof buf));
+			os.write(buf, is.gcount());
+			n -= is.gcount();
+		}
+		is.clear();
 		is.seekg(pos);
 	}
 	
+	/*
+	 * Write segment delimited content of given buffer to the given output
+	 * stream.
+	 */
+	void write(const char* buf, std::ostream& os) const
+	{
+		os.write(buf + _beg, _len);
+	}
+	
 	private:
 	
-	std::streampos _beg, _end;
+	uint32_t _beg, _len;
+};
+
+/*
+ * Segments of a read operation, by matching rule.
+ */
+class abnf_segment_map:
+public std::map<const abnf_rule*, std::vector<abnf_segment> >
+{
+};
+
+/*
+ * Kinds of rules, for structural keys.
+ */
+enum abnf_rule_kind
+{
+	ABNF_RULE_EOF,
+	ABNF_RULE_TERCH,
+	ABNF_RULE_TERSTR,
+	ABNF_RULE_TERFN,
+	ABNF_RULE_RALT,
+	ABNF_RULE_ALTCH,
+	ABNF_RULE_ALTSTR,
+	ABNF_RULE_CON,
+	ABNF_RULE_ALT,
+	ABNF_RULE_REP
+};
+
+/*
+ * Structural key of a rule: its kind followed by the bytes of its operands.
+ * Rule sets share the structure of rules with equal keys.
+ */
+class abnf_rule_key:
+public std::string
+{
+	public:
+	
+	/*
+	 * Key of a rule of the given kind, without operands.
+	 */
+	abnf_rule_key(abnf_rule_kind kind):
+	std::string(1, (char) kind)
+	{
+	}
+	
+	/*
+	 * Appends an operand.
+	 */
+	template<typename T>
+	abnf_rule_key& operator << (const T& op)
+	{
+		append(reinterpret_cast<const char*>(&op), sizeof(T));
+		return *this;
+	}
+	
+	/*
+	 * Appends a character string operand, including its null character.
+	 */
+	abnf_rule_key& operator << (const char* str)
+	{
+		append(str, std::char_traits<char>::length(str) + 1);
+		return *this;
+	}
+};
+
+/*
+ * Set of characters, as a 256 bits map.
+ *
+ * Bits are indexed by the low nibble of characters, so that a vector of
+ * characters can be classified with a couple of byte shuffles: bit h & 7 of
+ * _map[h >> 3][l] is set if the character with h and l high and low
+ * nibbles is in the set.
+ */
+class abnf_charset
+{
+	public:
+	
+	/*
+	 * Empty character set.
+	 */
+	abnf_charset(void)
+	{
+		for (int i = 0; i < 16; ++i)
+			_map[0][i] = _map[1][i] = 0;
+	}
+	
+	/*
+	 * Adds the character c, if it is in [0,255].
+	 */
+	void set(int c)
+	{
+		if (c >= 0 and c < 256)
+			_map[c >> 7][c & 15] |= 1 << ((c >> 4) & 7);
+	}
+	
+	/*
+	 * Tests if the character c is in this set.
+	 */
+	bool test(unsigned char c) const
+	{
+		return (_map[c >> 7][c & 15] >> ((c >> 4) & 7)) & 1;
+	}
+	
+	/*
+	 * Adds the characters of the given set.
+	 */
+	abnf_charset& operator |= (const abnf_charset& cs)
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			_map[0][i] |= cs._map[0][i];
+			_map[1][i] |= cs._map[1][i];
+		}
+		return *this;
+	}
+	
+	/*
+	 * Set of the characters which are not in this one.
+	 */
+	abnf_charset operator ~ (void) const
+	{
+		abnf_charset cs;
+		for (int i = 0; i < 16; ++i)
+		{
+			cs._map[0][i] = ~_map[0][i];
+			cs._map[1][i] = ~_map[1][i];
+		}
+		return cs;
+	}
+	
+	/*
+	 * The character of this set, if it has only one; -1 otherwise.
+	 */
+	int single(void) const
+	{
+		int c = -1;
+		for (int i = 0; i < 256; ++i)
+			if (test(i))
+			{
+				if (c >= 0)
+					return -1;
+				c = i;
+			}
+		return c;
+	}
+	
+	/*
+	 * Number of leading characters of the len characters of s which are in
+	 * this set.
+	 *
+	 * It uses vector instructions when they are available.
+	 */
+	size_t span(const char* s, size_t len) const;
+	
+	private:
+	
+	unsigned char _map[2][16];
+};
+
+/*
+ * Trie of case insensitive character strings, finding all of them which
+ * begin a text in a single pass over it.
+ */
+class abnf_trie
+{
+	public:
+	
+	/*
+	 * Empty trie.
+	 */
+	abnf_trie(void);
+	
+	/*
+	 * Adds a string, indexed after the previous ones. Empty strings begin no
+	 * text.
+	 */
+	void add(const std::string& str);
+	
+	/*
+	 * Number of strings.
+	 */
+	size_t size(void) const
+	{
+		return _str.size();
+	}
+	
+	/*
+	 * Length of the nth string.
+	 */
+	size_t length(size_t n) const
+	{
+		return _str[n].size();
+	}
+	
+	/*
+	 * The nth string, in lower case.
+	 */
+	const std::string& str(size_t n) const
+	{
+		return _str[n];
+	}
+	
+	/*
+	 * Appends to idx the indexes of the strings beginning the len characters
+	 * of s, in increasing order.
+	 */
+	void find(const char* s, size_t len, std::vector<size_t>& idx) const;
+	
+	/*
+	 * Appends to idx the indexes of the strings beginning the characters of
+	 * the given stream from its current position, in increasing order.
+	 *
+	 * Postcondition:
+	 *		is.tellg() is past the last character tested, or is in fail state
+	 */
+	void find(std::istream& is, std::vector<size_t>& idx) const;
+	
+	private:
+	
+	std::vector<unsigned char> _ch;
+	std::vector<int> _child;
+	std::vector<int> _sibling;
+	std::vector<int> _end;
+	std::vector<int> _end_next;
+	std::vector<std::string> _str;
+	
+	/*
+	 * Child of the given node through the character c, or -1 if there is
+	 * none.
+	 */
+	int child(int node, unsigned char c) const
+	{
+		int ch = _child[node];
+		while (ch >= 0 and _ch[ch] not_eq c)
+			ch = _sibling[ch];
+		return ch;
+	}
+	
+	/*
+	 * Appends to idx the indexes of the strings ending at the given node.
+	 */
+	void end_find(int node, std::vector<size_t>& idx) const
+	{
+		for (int n = _end[node]; n >= 0; n = _end_next[n])
+			idx.push_back(n);
+	}
+};
+
+/*
+ * Rule absorbed by a flattened rule, which matches a chain of nested rules of
+ * the same kind as a single one. Its segments span the children of the
+ * flattened rule from first to last, both included.
+ */
+class abnf_rule_span
+{
+	public:
+	
+	/*
+	 * Initialized span of the given rule, starting at the first child.
+	 */
+	abnf_rule_span(abnf_rule_ri* r, size_t first):
+	r(r),
+	first(first),
+	last(first)
+	{
+	}
+	
+	abnf_rule_ri* r;
+	size_t first, last;
+};
+
+/*
+ * Segment of a rule, recorded to be stored later.
+ */
+class abnf_rule_segment
+{
+	public:
+	
+	/*
+	 * Initialized segment of the given rule.
+	 */
+	abnf_rule_segment(abnf_rule_ri* r, const abnf_segment& seg):
+	r(r),
+	seg(seg)
+	{
+	}
+	
+	abnf_rule_ri* r;
+	abnf_segment seg;
 };
 
 /*
@@ -101,7 +438,40 @@ public abnf_rule
 	 */
 	abnf_rule_ri(const abnf_ruleset& rset):
 	abnf_rule(rset),
-	_is(NULL)
+	_is(NULL),
+	_buf(NULL),
+	_memo(NULL),
+	_prog(NULL),
+	_prog_r(-1),
+	_action(NULL),
+	_captured(false),
+	_first_done(false),
+	_nullable(false)
+	{
+	}
+	
+	/*
+	 * Release rule resources.
+	 */
+	~abnf_rule_ri(void);
+	
+	/*
+	 * Rules are allocated from the rule arena of the given owner rule set.
+	 */
+	static void* operator new(size_t size, const abnf_ruleset& rset);
+	
+	/*
+	 * Memory of rules is released by deleting the rule arena of their owner.
+	 */
+	static void operator delete(void* p)
+	{
+	}
+	
+	/*
+	 * Memory of rules whose construction fails is released by deleting the
+	 * rule arena of their owner.
+	 */
+	static void operator delete(void* p, const abnf_ruleset& rset)
 	{
 	}
 	
@@ -110,7 +480,7 @@ public abnf_rule
 	 * same with its children.
 	 *
 	 * Postcondition:
-	 *		empty stream
+	 *		empty stream and buffer
 	 *		empty segment vector
 	 */
 	void clear();
@@ -124,6 +494,53 @@ public abnf_rule
 	 */
 	void read(std::istream& is);
 	
+	/*
+	 * Perform a matching operation of this rule on to the given buffer.
+	 *
+	 * If this rule is compiled, its program runs directly on buf. Otherwise,
+	 * matchers read buf through a stream which does not copy it.
+	 *
+	 * Returns the matching length.
+	 *
+	 * Postcondition:
+	 *		buffer initialized for whole rule tree according the given buffer
+	 *		segment vector filled according the matching operation
+	 */
+	size_t read(const char* buf, size_t len);
+	
+	/*
+	 * Perform a matching operation of this compiled rule on to the given
+	 * stream, storing the results to res.
+	 *
+	 * Postcondition:
+	 *		res contains a copy of the stream from is'.tellg()
+	 *		res segments filled according the matching operation
+	 */
+	void read(std::istream& is, abnf_result& res) const;
+	
+	/*
+	 * Perform a matching operation of this compiled rule on to the given
+	 * buffer, storing the results to res.
+	 *
+	 * Returns the matching length.
+	 *
+	 * Postcondition:
+	 *		res segments filled according the matching operation
+	 */
+	size_t read(const char* buf, size_t len, abnf_result& res) const;
+	
+	/*
+	 * Perform matching operations of this compiled rule along the given
+	 * buffer, from the end of each match, storing all of them to res.
+	 *
+	 * Returns the number of matches.
+	 *
+	 * Postcondition:
+	 *		res segments filled according the matching operations
+	 *		res.length() is the end of the last match
+	 */
+	size_t scan(const char* buf, size_t len, abnf_result& res) const;
+	
 	/*
 	 * Number of segments stored at last read operation on to this rule of any
 	 * of its parents.
@@ -131,45 +548,302 @@ public abnf_rule
 	size_t read_count(void) const;
 	
 	/*
-	 * Write the nth segment content of the current stream on to the given
-	 * output stream.
+	 * Write the nth segment content of the current stream or buffer on to the
+	 * given output stream.
 	 *
-	 * If n < 0 or n ≥ size of segment vector or current stream is empty,
-	 * nothing is done.
+	 * If n < 0 or n ≥ size of segment vector or current stream and buffer
+	 * are empty, nothing is done.
 	 */
 	void write(size_t n, std::ostream& os) const;
 	
 	/*
-	 * Add a beg,end segment to this rule.
+	 * Span of the nth segment, with the characters of the current buffer if
+	 * there is one.
+	 *
+	 * If n ≥ size of segment vector, the span is empty.
+	 */
+	abnf_span span(size_t n) const;
+	
+	/*
+	 * Whether the segments of this rule are stored.
+	 */
+	bool captured(void) const
+	{
+		return _captured;
+	}
+	
+	/*
+	 * Sets whether the segments of this rule are stored.
+	 */
+	void captured_set(bool cap)
+	{
+		_captured = cap;
+	}
+	
+	/*
+	 * Sets the semantic action of this rule, or none if act is null.
+	 */
+	void action_set(abnf_action act)
+	{
+		_action = act;
+	}
+	
+	/*
+	 * Whether the segments of this rule are needed, since they are stored or
+	 * given to its action or, if it was fused by optimize, those of its
+	 * children rules are. By default, only if they are stored or given to its
+	 * action.
+	 */
+	virtual bool capture_needed(void) const
+	{
+		return _captured or _action not_eq NULL;
+	}
+	
+	/*
+	 * Add a beg,end segment to this rule, if it is captured.
 	 *
 	 * Precondition:
 	 *		beg < end
 	 * Postcondition:
-	 *		_seg_vect contains a beg,end segment
+	 *		_seg_vect contains a beg,end segment, if this rule is captured
 	 */
 	void segment_add(std::streampos beg, std::streampos end)
 	{
-		_seg_vect.push_back(abnf_segment(beg, end));
+		if (not _captured)
+			return;
+		if (_seg_rec not_eq NULL)
+			_seg_rec->push_back(abnf_rule_segment(this,
+					abnf_segment(beg, end)));
+		else
+			_seg_vect.push_back(abnf_segment(beg, end));
+	}
+	
+	/*
+	 * Makes segment_add of every rule in this thread append segments to rec,
+	 * instead of storing them, until it is called again. With a null rec,
+	 * they are stored again.
+	 *
+	 * Returns the previous rec.
+	 */
+	static std::vector<abnf_rule_segment>* segment_record(
+			std::vector<abnf_rule_segment>* rec)
+	{
+		std::vector<abnf_rule_segment>* prev = _seg_rec;
+		_seg_rec = rec;
+		return prev;
+	}
+	
+	/*
+	 * Add a beg,end segment to this rule and, through fused_child_segment_add,
+	 * to those children rules which match its characters, given by s.
+	 *
+	 * Precondition:
+	 *		s points to the end - beg characters of the segment
+	 */
+	void fused_segment_add(const char* s, std::streampos beg,
+			std::streampos end)
+	{
+		segment_add(beg, end);
+		fused_child_segment_add(s, beg, end);
+	}
+	
+	/*
+	 * Add the segments of a beg,end segment of this rule to those children
+	 * rules which match its characters, given by s, if it was fused by
+	 * optimize. By default, it has no such children.
+	 */
+	virtual void fused_child_segment_add(const char* s, std::streampos beg,
+			std::streampos end)
+	{
+	}
+	
+	/*
+	 * Add a beg,end segment of this rule to res, if it is captured, and give
+	 * it to its action, if res has data for it. The characters of the
+	 * segment, if available, are given by s.
+	 */
+	void segment_add(abnf_result& res, const char* s, std::streampos beg,
+			std::streampos end) const
+	{
+		if (_captured)
+			(*res._seg_map)[this].push_back(abnf_segment(beg, end));
+		if (_action not_eq NULL and res._act)
+			_action(res._data, *this, abnf_span(s, std::streamoff(beg),
+					end - beg));
+	}
+	
+	/*
+	 * Add a beg,end match of a scan operation of this rule to res, unless
+	 * this rule is captured, so segment_add already did.
+	 */
+	void match_add(abnf_result& res, std::streampos beg,
+			std::streampos end) const
+	{
+		if (not _captured)
+			(*res._seg_map)[this].push_back(abnf_segment(beg, end));
+	}
+	
+	/*
+	 * Add a beg,end segment of this rule to res and, through
+	 * fused_child_segment_add, those of the children rules which match its
+	 * characters, given by s.
+	 *
+	 * Precondition:
+	 *		s points to the end - beg characters of the segment
+	 */
+	void fused_segment_add(abnf_result& res, const char* s,
+			std::streampos beg, std::streampos end) const
+	{
+		segment_add(res, s, beg, end);
+		fused_child_segment_add(res, s, beg, end);
+	}
+	
+	/*
+	 * Add to res the segments of the children rules which match the
+	 * characters of a beg,end segment of this rule, given by s, if it was
+	 * fused by optimize. By default, it has no such children.
+	 */
+	virtual void fused_child_segment_add(abnf_result& res, const char* s,
+			std::streampos beg, std::streampos end) const
+	{
+	}
+	
+	/*
+	 * Adds to cs the characters matching this rule, if it matches a single
+	 * character from a set of them.
+	 *
+	 * Returns true if it does; false otherwise, leaving cs undefined.
+	 */
+	virtual bool charset(abnf_charset& cs) = 0;
+	
+	/*
+	 * Rule whose structure this one shares, which structural keys of rules
+	 * created from this one refer to. By default, this rule itself.
+	 */
+	virtual abnf_rule_ri& body(void)
+	{
+		return *this;
+	}
+	
+	/*
+	 * Appends to ch the children rules this one was created from. By default,
+	 * it has none.
+	 */
+	virtual void children(std::vector<abnf_rule_ri*>& ch)
+	{
+	}
+	
+	/*
+	 * Structural key of this rule, if it refers to its children rules, so
+	 * that a copy of its rule set must compute it again. By default, it does
+	 * not, so it is empty.
+	 */
+	virtual std::string key(void)
+	{
+		return std::string();
+	}
+	
+	/*
+	 * Whether this rule and r match alike and store the same segments, so
+	 * that either of them can be matched for the other. They do if they are
+	 * the same rule, or if they share their structure through children which
+	 * are the same, and neither of them is captured, has an action nor is
+	 * memoized.
+	 */
+	bool same(abnf_rule_ri& r);
+	
+	/*
+	 * Optimizes the matching of this rule, without changing its results.
+	 * By default, nothing is done.
+	 */
+	virtual void optimize(void)
+	{
+	}
+	
+	/*
+	 * Sets str to the case insensitive character string matching this rule,
+	 * if it is a character string terminal rule. By default, it is not.
+	 *
+	 * Returns true if it is; false otherwise, leaving str undefined.
+	 */
+	virtual bool literal(std::string& str)
+	{
+		return false;
+	}
+	
+	/*
+	 * Appends to seq the rules this one is matched as, one after another,
+	 * and to spans those absorbed rules whose segments span several of them.
+	 * By default, this rule alone.
+	 */
+	virtual void sequence(std::vector<abnf_rule_ri*>& seq,
+			std::vector<abnf_rule_span>& spans)
+	{
+		seq.push_back(this);
+	}
+	
+	/*
+	 * Characters which may begin a non empty segment matching this rule,
+	 * computed once through first_impl.
+	 */
+	const abnf_charset& first(void)
+	{
+		first_update();
+		return _first;
+	}
+	
+	/*
+	 * Whether this rule may match an empty segment, computed once through
+	 * first_impl.
+	 */
+	bool nullable(void)
+	{
+		first_update();
+		return _nullable;
+	}
+	
+	/*
+	 * Whether this rule may match before the given next character, or before
+	 * the end of input if it is negative.
+	 */
+	bool first_test(int c)
+	{
+		return nullable() or (c >= 0 and first().test(c));
 	}
 	
 	/*
-	 * Updates the current stream of this rule and its children through
-	 * stream_update_impl.
+	 * Updates the current stream and buffer of this rule and its children
+	 * through stream_update_impl. Only one of them is expected to be non
+	 * null.
 	 *
 	 * Postcondition:
 	 *		current stream of this rule tree points to the given stream address
+	 *		current buffer of this rule tree points to the given buffer address
 	 */
-	void stream_update(std::istream& is)
+	void stream_update(std::istream* is, const char* buf)
 	{
-		stream_update_impl(is);
-		_is = &is;
+		stream_update_impl(is, buf);
+		_is = is;
+		_buf = buf;
+		memo_clear();
+	}
+	
+	/*
+	 * Character buffer of the current read operation, or null if it reads a
+	 * stream.
+	 */
+	const char* buffer(void) const
+	{
+		return _buf;
 	}
 	
 	/*
 	 * Duplicates this rule with the given rule set as an owner.
 	 *
 	 * If its duplicated is in the given map it is retrieved and returned.
-	 * Otherwise, it is duplicated throug dupl_impl and stored to the map.
+	 * If it belongs to a rule set included by the given one, it is shared
+	 * instead, so it is returned itself. Otherwise, it is duplicated throug
+	 * dupl_impl and stored to the map.
 	 *
 	 * Postcondition:
 	 *		d_map contains an entry with this as key and duplicated as value
@@ -181,15 +855,82 @@ public abnf_rule
 				d_map.find(this);
 		if (it not_eq d_map.end())
 			return it->second;
-		return d_map[this] = dupl_impl(rset, d_map);
+		if (rset.includes(ruleset()))
+			return const_cast<abnf_rule_ri*>(this);
+		abnf_rule_ri* r = d_map[this] = dupl_impl(rset, d_map);
+		r->_action = _action;
+		r->_captured = _captured;
+		if (_memo not_eq NULL)
+			r->memo_enable(memo_max());
+		return r;
 	}
 	
 	/*
 	 * Creates a matcher adequate to this rule.
+	 *
+	 * If memoization is enabled, the matcher created through matcher_new_impl
+	 * is wrapped by a matcher which shares its results with any other matcher
+	 * of this rule at the same stream position.
+	 */
+	abnf_matcher* matcher_new(void)
+	{
+		return _memo == NULL ? matcher_new_impl() : memo_matcher_new();
+	}
+	
+	/*
+	 * Enables memoization of the matching results of this rule, using up to
+	 * mem_max bytes on each read operation.
+	 *
+	 * Postcondition:
+	 *		matchers created by matcher_new are memoized
+	 */
+	void memo_enable(size_t mem_max);
+	
+	/*
+	 * Memory limit of memoized matching results, or zero if memoization is
+	 * not enabled.
+	 */
+	size_t memo_max(void) const;
+	
+	/*
+	 * Program this rule was compiled into, or null if it was not compiled.
 	 */
-	virtual abnf_matcher* matcher_new(void) = 0;
+	const abnf_program* program(void) const
+	{
+		return _prog;
+	}
+	
+	/*
+	 * Index of this rule in the program it was compiled into, or -1 if it
+	 * was not compiled.
+	 */
+	int program_index(void) const
+	{
+		return _prog_r;
+	}
 	
 	protected:
+	
+	/*
+	 * Arena of the owner rule set, where matchers are allocated.
+	 */
+	abnf_arena& arena(void) const
+	{
+		return *ruleset()._arena;
+	}
+	
+	/*
+	 * Resets the arenas of the owner rule set and included ones.
+	 */
+	void arena_reset(void) const
+	{
+		ruleset().arena_reset();
+	}
+	
+	/*
+	 * Creates a matcher adequate to this rule.
+	 */
+	virtual abnf_matcher* matcher_new_impl(void) = 0;
 
 	/*
 	 * Call clear recursively on to children rules.
@@ -199,30 +940,136 @@ public abnf_rule
 	/*
 	 * Call stream_update recursively on to children rules.
 	 */
-	virtual void stream_update_impl(std::istream& is) = 0;
+	virtual void stream_update_impl(std::istream* is, const char* buf) = 0;
 	
 	/*
 	 * Call dupl recursively on to children rules.
 	 */
 	virtual abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const = 0;
+	
+	/*
+	 * Creates a rule like this one, owned by the given rule set, but made of
+	 * the given children rules instead of its own, in the order children
+	 * appends them. By default, it has no children, so it is not rebuilt.
+	 */
+	virtual abnf_rule_ri* rebuild_impl(const abnf_ruleset& rset,
+			const std::vector<abnf_rule_ri*>& ch) const
+	{
+		return NULL;
+	}
+	
+	/*
+	 * Call prog.entry on to children rules and emit the instructions of this
+	 * rule to prog.
+	 *
+	 * Returns the address of the first emitted instruction.
+	 */
+	virtual int compile_impl(abnf_program& prog) = 0;
+	
+	/*
+	 * Adds to cs the characters which may begin a non empty segment matching
+	 * this rule, using first and nullable on to children rules.
+	 *
+	 * Returns true if this rule may match an empty segment; false otherwise.
+	 */
+	virtual bool first_impl(abnf_charset& cs) = 0;
 			
 	private:
 	
 	std::istream* _is;
+	const char* _buf;
 	std::vector<abnf_segment> _seg_vect;
+	static __thread std::vector<abnf_rule_segment>* _seg_rec;
+	abnf_memo* _memo;
+	const abnf_program* _prog;
+	int _prog_r;
+	abnf_action _action;
+	bool _captured;
+	bool _first_done;
+	bool _nullable;
+	abnf_charset _first;
+	
+	/*
+	 * Whether this rule is neither captured, has an action nor is memoized.
+	 */
+	bool plain(void) const
+	{
+		return not _captured and _action == NULL and _memo == NULL;
+	}
+	
+	/*
+	 * Computes the first characters and nullability of this rule through
+	 * first_impl, if they were not yet.
+	 */
+	void first_update(void)
+	{
+		if (not _first_done)
+		{
+			_nullable = first_impl(_first);
+			_first_done = true;
+		}
+	}
+	
+	/*
+	 * Creates a memoized matcher.
+	 */
+	abnf_matcher* memo_matcher_new(void);
+	
+	/*
+	 * Discard memoized matching results, if memoization is enabled.
+	 */
+	void memo_clear(void);
+	
+	/*
+	 * Discards the memoized matchers of this rule tree and resets the arena,
+	 * once every matcher of a read operation is destroyed.
+	 */
+	void matcher_release(void);
+	
+	/*
+	 * Memoized results create matchers through matcher_new_impl.
+	 */
+	friend class abnf_memo_entry;
+	
+	/*
+	 * Programs compile rules through compile_impl.
+	 */
+	friend class abnf_program;
+	
+	/*
+	 * Parsers run the programs of rules.
+	 */
+	friend class abnf_parser;
+	
+	/*
+	 * Aliases match through the implementation of their bodies.
+	 */
+	friend class abnf_rule_alias;
 };
 
 /*
  * Throws a detailed std::invalid_argument exception if the owner rule set of
- * the given rule is not the same as the given rule set.
+ * the given rule is neither the given rule set nor an included one.
  */
 inline void owner_test(const abnf_ruleset& rset, const abnf_rule& r)
 {
-	if (&rset not_eq &r.ruleset())
+	if (not rset.includes(r.ruleset()))
 		throw std::invalid_argument("rule from different rule set");
 }
 
+/*
+ * Throws a detailed std::invalid_argument exception if the owner rule set of
+ * the given rule is not the given rule set, so that it cannot change the rule
+ * for the rule sets including it.
+ */
+inline void owner_only_test(const abnf_ruleset& rset, const abnf_rule& r)
+{
+	owner_test(rset, r);
+	if (&r.ruleset() not_eq &rset)
+		throw std::invalid_argument("rule from included rule set");
+}
+
 } // namespace xspider
 
 #endif // ABNFR_H
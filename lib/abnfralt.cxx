@@ -19,6 +19,7 @@
  */
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -76,12 +77,17 @@ public abnf_rule_ri
 	{
 	}
 	
+	/*
+	 * Characters of the range.
+	 */
+	bool charset(abnf_charset& cs);
+	
 	protected:
 	
 	/*
 	 * Creates a range alternate matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done
@@ -91,13 +97,23 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
@@ -115,7 +131,12 @@ using namespace xspider;
  
 abnf_rule& abnf_ruleset::alternat(int ci, int ce)
 {
-	return **_r_set.insert(new abnf_rule_ralt(*this, ci, ce)).first;
+	abnf_rule*& r = cons(abnf_rule_key(ABNF_RULE_RALT) << ci << ce);
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	r = store(new (*this) abnf_rule_ralt(*this, ci, ce));
+	return *r;
 }
 
 /*
@@ -129,28 +150,51 @@ void abnf_matcher_ralt::commit_impl(void)
 bool abnf_matcher_ralt::match_impl(istream& is)
 {
 	char c;
-	return is.good() and (is.get(c), c) >= _ci and c <= _ce;
+	return is.get(c) and (unsigned char) c >= _ci and
+			(unsigned char) c <= _ce;
 }
 
 /*
  * abnf_rule_ralt implementation
  */
 
-abnf_matcher* abnf_rule_ralt::matcher_new(void)
+abnf_matcher* abnf_rule_ralt::matcher_new_impl(void)
 {
-	return new abnf_matcher_ralt(*this, _ci, _ce);
+	return new (arena()) abnf_matcher_ralt(*this, _ci, _ce);
+}
+
+bool abnf_rule_ralt::charset(abnf_charset& cs)
+{
+	for (int c = std::max(_ci, 0); c <= _ce and c < 256; ++c)
+		cs.set(c);
+	return true;
 }
 
 void abnf_rule_ralt::clear_impl(void)
 {
 }
 
-void abnf_rule_ralt::stream_update_impl(std::istream& is)
+void abnf_rule_ralt::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_ralt::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_ralt(rset, _ci, _ce);
+	return new (rset) abnf_rule_ralt(rset, _ci, _ce);
+}
+
+int abnf_rule_ralt::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_RANGE, _ci, _ce);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_ralt::first_impl(abnf_charset& cs)
+{
+	charset(cs);
+	return false;
 }
@@ -18,9 +18,12 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
  */
 
+#include <algorithm>
 #include <climits>
+#include <string>
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -90,6 +93,78 @@ public abnf_matcher
 	}
 };
 
+/*
+ * Matcher for greedy or possessive repetition rule.
+ *
+ * Sequences of occurrences are tried longest first: before matching a
+ * sequence, every sequence extending it is tried. A possessive matcher only
+ * matches the first sequence.
+ */
+class abnf_matcher_repg:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized greedy repetition matcher.
+	 */
+	abnf_matcher_repg(abnf_rule_ri& r, int r_min, int r_max, abnf_rule_ri& ru,
+			bool poss):
+	abnf_matcher(r),
+	_min(r_min),
+	_max(r_max),
+	_ru(ru),
+	_poss(poss),
+	_started(false)
+	{
+	}
+	
+	/*
+	 * Delete stored matchers.
+	 */
+	~abnf_matcher_repg(void);
+	
+	/*
+	 * Available if, and only if it is not possessive and any occurrence is
+	 * stored, since shorter sequences are still to be matched.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Commit stored matchers.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches the next sequence of occurrences, longest first.
+	 */
+	bool match_impl(std::istream& is);
+			
+	private:
+	
+	const int _min, _max;
+	abnf_rule_ri& _ru;
+	const bool _poss;
+	bool _started;
+	std::vector<abnf_matcher*> _m_vect;
+	
+	/*
+	 * Matches the last stored matcher, after the previous one. Empty
+	 * occurrences beyond the minimum are skipped.
+	 *
+	 * Precondition:
+	 *		matcher vector is not empty
+	 */
+	bool _last_match(std::istream& is);
+	
+	/*
+	 * Ends matching at the end of the last stored matcher.
+	 */
+	void _end_seek(std::istream& is) const;
+};
+
 /*
  * Repetition rule.
  */
@@ -102,20 +177,70 @@ public abnf_rule_ri
 	 * Initialized repetition rule.
 	 */
 	abnf_rule_rep(const abnf_ruleset& rset, int r_min, int r_max,
-			abnf_rule_ri& r):
+			abnf_rule_ri& r, abnf_repet_mode mode):
 	abnf_rule_ri(rset),
 	_min(std::max(0, r_min)),
 	_max(std::max(_min, r_max)),
+	_mode(mode),
+	_fused(false),
 	_r(r)
 	{
 	}
 	
+	/*
+	 * Add, if this rule is fused, an occurrence segment for each character of
+	 * the segment to the repeated rule.
+	 */
+	void fused_child_segment_add(const char* s, std::streampos beg,
+			std::streampos end);
+	
+	/*
+	 * Add to res, if this rule is fused, an occurrence segment for each
+	 * character of the segment.
+	 */
+	void fused_child_segment_add(abnf_result& res, const char* s,
+			std::streampos beg, std::streampos end) const;
+	
+	/*
+	 * Whether this rule is captured or, if it is fused, the repeated rule
+	 * needs its occurrence segments.
+	 */
+	bool capture_needed(void) const;
+	
+	/*
+	 * Structural key of a repetition of the given rule, with the given bounds
+	 * and mode.
+	 */
+	static abnf_rule_key key(int r_min, int r_max, abnf_rule_ri& r,
+			abnf_repet_mode mode);
+	
+	/*
+	 * Structural key of this rule.
+	 */
+	std::string key(void);
+	
+	/*
+	 * Appends the repeated rule.
+	 */
+	void children(std::vector<abnf_rule_ri*>& ch);
+	
+	/*
+	 * Not a single character.
+	 */
+	bool charset(abnf_charset& cs);
+	
+	/*
+	 * Fuses this rule to a run of characters of a set, if the repeated rule
+	 * is a single character rule.
+	 */
+	void optimize(void);
+	
 	protected:
 	
 	/*
 	 * Creates a repetition matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Clear repeated rule.
@@ -125,20 +250,98 @@ public abnf_rule_ri
 	/*
 	 * Update stream of repeated rule.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Rebuild operation implementation.
+	 */
+	abnf_rule_ri* rebuild_impl(const abnf_ruleset& rset,
+			const std::vector<abnf_rule_ri*>& ch) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
 	const int _min, _max;
+	const abnf_repet_mode _mode;
+	bool _fused;
+	abnf_charset _cs;
 	abnf_rule_ri& _r;
 };
 
+/*
+ * Matcher for repetition rule of a single character rule, fused to a run of
+ * characters of a set.
+ *
+ * The whole run is read at first matching. Then, every matching adds one
+ * more character of the run, from the minimum up to the maximum, or removes
+ * one from the maximum down to the minimum if it is greedy.
+ */
+class abnf_matcher_repcs:
+public abnf_matcher
+{
+	public:
+	
+	/*
+	 * Initialized character set repetition matcher.
+	 */
+	abnf_matcher_repcs(abnf_rule_rep& r, int r_min, int r_max,
+			abnf_repet_mode mode, const abnf_charset& cs):
+	abnf_matcher(r),
+	_ra(r),
+	_min(r_min),
+	_max(r_max),
+	_mode(mode),
+	_cs(cs),
+	_count(-1),
+	_s(NULL),
+	_len(0)
+	{
+	}
+	
+	/*
+	 * Available if, and only if the run has more lengths to be matched.
+	 */
+	bool available(void) const;
+	
+	protected:
+	
+	/*
+	 * Commit an occurrence for each matching character.
+	 */
+	void commit_impl(void);
+	
+	/*
+	 * Matches the next length of the run.
+	 */
+	bool match_impl(std::istream& is);
+	
+	private:
+	
+	abnf_rule_rep& _ra;
+	const int _min, _max;
+	const abnf_repet_mode _mode;
+	const abnf_charset& _cs;
+	int _count;
+	const char* _s;
+	size_t _len;
+	std::string _run;
+};
+
 } // namespace xspider
 
 using namespace std;
@@ -148,17 +351,26 @@ using namespace xspider;
  * abnf_ruleset implementation
  */
  
-abnf_rule& abnf_ruleset::repet(int r_min, abnf_rule& r)
+abnf_rule& abnf_ruleset::repet(int r_min, abnf_rule& r,
+		abnf_repet_mode mode)
 {
-	return repet(r_min, INT_MAX, r);
+	return repet(r_min, INT_MAX, r, mode);
 }
 
-abnf_rule& abnf_ruleset::repet(int r_min, int r_max, abnf_rule& r)
+abnf_rule& abnf_ruleset::repet(int r_min, int r_max, abnf_rule& r,
+		abnf_repet_mode mode)
 {
 	owner_test(*this, r);
 	
+	r_min = max(0, r_min);
+	r_max = max(r_min, r_max);
 	abnf_rule_ri& r_ri = abnf_rule_ri::cast(r);
-	return **_r_set.insert(new abnf_rule_rep(*this, r_min, r_max, r_ri)).first;
+	abnf_rule*& rr = cons(abnf_rule_rep::key(r_min, r_max, r_ri, mode));
+	if (rr not_eq NULL)
+		return alias(*rr, &r);
+	
+	rr = store(new (*this) abnf_rule_rep(*this, r_min, r_max, r_ri, mode));
+	return *rr;
 }
 
 /*
@@ -178,7 +390,7 @@ bool abnf_matcher_rep::available(void) const
 	while (it not_eq _m_vect.end())
 		if ((*it++)->available())
 			return true;
-	return _m_vect.size() < _max;
+	return (int) _m_vect.size() < _max;
 }
 
 void abnf_matcher_rep::commit_impl(void)
@@ -198,40 +410,245 @@ bool abnf_matcher_rep::match_impl(istream& is)
 		_m_vect.push_back(_ru.matcher_new());
 	}
 	
-	bool mismatched = false;
 	bool matched = false;
 	
-	while (not mismatched and not matched)
+	while (not _m_vect.empty() and not matched)
 	{
 		is.clear();
 		is.seekg(_last_pos());
 		
-		if (_m_vect.back()->match(is))
+		abnf_matcher* m = _m_vect.back();
+		if (m->match(is))
 		{
-			if (_m_vect.size() == _count)
+			// Empty occurrences beyond the minimum lead nowhere new
+			if (m->stream_end() == m->stream_beg() and
+					(int) _m_vect.size() > _min)
+				continue;
+				
+			if ((int) _m_vect.size() == _count)
 				matched = true;
 			else
 				_m_vect.push_back(_ru.matcher_new());
 		}
 		else
+		{
+			delete m;
+			_m_vect.pop_back();
+			_count = max((int) _m_vect.size(), _min);
+		}
+	}
+	return matched;
+}
+
+/*
+ * abnf_matcher_repg implementation
+ */
+ 
+abnf_matcher_repg::~abnf_matcher_repg(void)
+{
+	vector<abnf_matcher*>::const_iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		delete *it++;
+}
+
+bool abnf_matcher_repg::available(void) const
+{
+	return not _poss and not _m_vect.empty();
+}
+
+void abnf_matcher_repg::commit_impl(void)
+{
+	vector<abnf_matcher*>::iterator it = _m_vect.begin();
+	while (it not_eq _m_vect.end())
+		(*it++)->commit();
+}
+
+bool abnf_matcher_repg::match_impl(istream& is)
+{
+	if (_started and _poss)
+		return false;
+	
+	// Extend the first sequence, or try the next one of the last occurrence
+	bool extend = not _started;
+	_started = true;
+	
+	for (;;)
+	{
+		if (extend)
+		{
+			if ((int) _m_vect.size() < _max)
+			{
+				_m_vect.push_back(_ru.matcher_new());
+				if (_last_match(is))
+					continue;
+				delete _m_vect.back();
+				_m_vect.pop_back();
+			}
+			
+			// No longer sequences, so this one is next
+			extend = false;
+			if ((int) _m_vect.size() >= _min)
+			{
+				_end_seek(is);
+				return true;
+			}
+		}
+		
+		if (_m_vect.empty())
+			return false;
+		
+		if (_last_match(is))
+			extend = true;
+		else
 		{
 			delete _m_vect.back();
 			_m_vect.pop_back();
 			
-			if (--_count == 0)
-				mismatched = true;
+			// Every sequence extending this one was tried
+			if ((int) _m_vect.size() >= _min)
+			{
+				_end_seek(is);
+				return true;
+			}
 		}
 	}
-	return matched;
+}
+
+bool abnf_matcher_repg::_last_match(istream& is)
+{
+	abnf_matcher* m = _m_vect.back();
+	streampos pos = _m_vect.size() > 1 ?
+			(*(_m_vect.rbegin() + 1))->stream_end() : stream_beg();
+	
+	for (;;)
+	{
+		is.clear();
+		is.seekg(pos);
+		if (not m->match(is))
+			return false;
+		
+		// Empty occurrences beyond the minimum lead nowhere new
+		if (m->stream_end() > m->stream_beg() or (int) _m_vect.size() <= _min)
+			return true;
+	}
+}
+
+void abnf_matcher_repg::_end_seek(istream& is) const
+{
+	is.clear();
+	is.seekg(_m_vect.empty() ? stream_beg() : _m_vect.back()->stream_end());
+}
+
+/*
+ * abnf_matcher_repcs implementation
+ */
+
+bool abnf_matcher_repcs::available(void) const
+{
+	switch (_mode)
+	{
+		case ABNF_REPET_LAZY:
+		return _count < (int) _len;
+		
+		case ABNF_REPET_GREEDY:
+		return _count > _min;
+		
+		default:
+		return false;
+	}
+}
+
+void abnf_matcher_repcs::commit_impl(void)
+{
+	_ra.fused_child_segment_add(_s, stream_beg(), stream_end());
+}
+
+bool abnf_matcher_repcs::match_impl(istream& is)
+{
+	if (_count < 0)
+	{
+		// The run is spanned at once over the characters of a buffer, as the
+		// compiled rules do, or taken one by one from a stream
+		const char* buf = _ra.buffer();
+		if (buf not_eq NULL)
+		{
+			_s = buf + streamoff(stream_beg());
+			_len = _cs.span(_s, min((size_t) is.rdbuf()->in_avail(),
+					(size_t) _max));
+		}
+		else
+		{
+			char c;
+			while (_run.size() < (size_t) _max and is.get(c) and _cs.test(c))
+				_run.push_back(c);
+			_s = _run.data();
+			_len = _run.size();
+		}
+		if (_len < (size_t) _min)
+			return false;
+		_count = _mode == ABNF_REPET_LAZY ? _min : _len;
+	}
+	else if (_mode == ABNF_REPET_LAZY)
+		++_count;
+	else
+		--_count;
+	
+	is.clear();
+	is.seekg(stream_beg() + streamoff(_count));
+	return true;
 }
 
 /*
  * abnf_rule_rep implementation
  */
 
-abnf_matcher* abnf_rule_rep::matcher_new(void)
+void abnf_rule_rep::fused_child_segment_add(const char* s, streampos beg,
+		streampos end)
 {
-	return new abnf_matcher_rep(*this, _min, _max, _r);
+	// Occurrences are not walked if nobody stores them
+	if (not _fused or not _r.capture_needed())
+		return;
+	for (streampos pos = beg; pos < end; pos += 1)
+		_r.fused_segment_add(s++, pos, pos + streamoff(1));
+}
+
+void abnf_rule_rep::fused_child_segment_add(abnf_result& res, const char* s,
+		streampos beg, streampos end) const
+{
+	if (_fused and _r.capture_needed())
+		for (streampos pos = beg; pos < end; pos += 1)
+			_r.fused_segment_add(res, s++, pos, pos + streamoff(1));
+}
+
+abnf_matcher* abnf_rule_rep::matcher_new_impl(void)
+{
+	if (_fused)
+		return new (arena()) abnf_matcher_repcs(*this, _min, _max, _mode,
+				_cs);
+	if (_mode not_eq ABNF_REPET_LAZY)
+		return new (arena()) abnf_matcher_repg(*this, _min, _max, _r,
+				_mode == ABNF_REPET_POSSESSIVE);
+	return new (arena()) abnf_matcher_rep(*this, _min, _max, _r);
+}
+
+bool abnf_rule_rep::capture_needed(void) const
+{
+	return captured() or (_fused and _r.capture_needed());
+}
+
+bool abnf_rule_rep::charset(abnf_charset& cs)
+{
+	return false;
+}
+
+void abnf_rule_rep::optimize(void)
+{
+	abnf_charset cs;
+	if (not _fused and _r.charset(cs))
+	{
+		_fused = true;
+		_cs = cs;
+	}
 }
 
 void abnf_rule_rep::clear_impl(void)
@@ -239,13 +656,76 @@ void abnf_rule_rep::clear_impl(void)
 	_r.clear();
 }
 
-void abnf_rule_rep::stream_update_impl(std::istream& is)
+void abnf_rule_rep::stream_update_impl(std::istream* is,
+		const char* buf)
 {
-	_r.stream_update(is);
+	_r.stream_update(is, buf);
 }
 
 abnf_rule_ri* abnf_rule_rep::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_rep(rset, _min, _max, _r);
+	return new (rset) abnf_rule_rep(rset, _min, _max, *_r.dupl(rset, d_map),
+			_mode);
+}
+
+abnf_rule_ri* abnf_rule_rep::rebuild_impl(const abnf_ruleset& rset,
+		const vector<abnf_rule_ri*>& ch) const
+{
+	return new (rset) abnf_rule_rep(rset, _min, _max, *ch[0], _mode);
+}
+
+abnf_rule_key abnf_rule_rep::key(int r_min, int r_max, abnf_rule_ri& r,
+		abnf_repet_mode mode)
+{
+	return abnf_rule_key(ABNF_RULE_REP) << r_min << r_max << &r.body() << mode;
+}
+
+string abnf_rule_rep::key(void)
+{
+	return key(_min, _max, _r, _mode);
+}
+
+void abnf_rule_rep::children(vector<abnf_rule_ri*>& ch)
+{
+	ch.push_back(&_r);
+}
+
+int abnf_rule_rep::compile_impl(abnf_program& prog)
+{
+	if (_fused)
+	{
+		int pc = prog.size();
+		if (_mode == ABNF_REPET_LAZY)
+		{
+			prog.emit(ABNF_OP_RUN, prog.class_id(_cs), _min, _max);
+			prog.emit(ABNF_OP_MORE);
+		}
+		else
+		{
+			prog.emit(ABNF_OP_SPAN, prog.class_id(_cs), _min, _max);
+			if (_mode == ABNF_REPET_GREEDY)
+				prog.emit(ABNF_OP_LESS, _min);
+		}
+		prog.emit(ABNF_OP_RET);
+		return pc;
+	}
+	
+	int r = prog.entry(_r);
+	
+	int pc = prog.size();
+	prog.emit(ABNF_OP_REP, _min, _max, _mode);
+	prog.emit_call(r);
+	prog.emit(ABNF_OP_LOOP, pc);
+	if (_mode == ABNF_REPET_POSSESSIVE)
+		prog.emit(ABNF_OP_CUT);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_rep::first_impl(abnf_charset& cs)
+{
+	if (_max > 0)
+		cs |= _r.first();
+	return _min == 0 or _r.nullable();
 }
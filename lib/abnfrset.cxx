@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -66,12 +67,17 @@ public abnf_rule_ri
 	{
 	}
 	
+	/*
+	 * Not a single character.
+	 */
+	bool charset(abnf_charset& cs);
+	
 	protected:
 	
 	/*
 	 * Creates a new empty matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done.
@@ -81,13 +87,23 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 };
 
 } // namespace xspider
@@ -102,76 +118,175 @@ using namespace xspider;
 abnf_ruleset abnf_ruleset::_core_rset;
 
 abnf_ruleset::abnf_ruleset(void):
-_empty_r(new abnf_rule_empty(*this))
+_arena(new abnf_arena),
+_r_arena(new abnf_arena),
+_prog(NULL),
+_empty_r(new (*this) abnf_rule_empty(*this)),
+_changes(0)
 {
 }
 
 abnf_ruleset::abnf_ruleset(const abnf_ruleset& rset):
-_empty_r(new abnf_rule_empty(*this))
+_arena(new abnf_arena),
+_r_arena(new abnf_arena),
+_prog(NULL),
+_empty_r(new (*this) abnf_rule_empty(*this)),
+_rset_vect(rset._rset_vect),
+_changes(0)
 {
-	include(rset);
+	std::map<const abnf_rule*, abnf_rule_ri*> d_map;
+	d_map[rset._empty_r] = &abnf_rule_ri::cast(*_empty_r);
+	
+	// Duplicates all rules of copied rule set and store them to this rule set
+	// in the same order
+	vector<abnf_rule*>::const_iterator a_it = rset._r_vect.begin();
+	while (a_it not_eq rset._r_vect.end())
+		_r_vect.push_back(abnf_rule_ri::cast(**a_it++).dupl(*this, d_map));
+	
+	// Share duplicated rules by structure as copied ones are, computing again
+	// those keys which refer to children rules
+	map<string, abnf_rule*>::const_iterator c_it = rset._r_cons.begin();
+	while (c_it not_eq rset._r_cons.end())
+	{
+		abnf_rule_ri* r = d_map[c_it->second];
+		string key = r->key();
+		_r_cons[key.empty() ? c_it->first : key] = r;
+		++c_it;
+	}
+	
+	// Define rules as are defined in copied rule set
+	map<string, abnf_rule*>::const_iterator m_it = rset._r_map.begin();
+	while (m_it not_eq rset._r_map.end())
+	{
+		_r_map[m_it->first] = d_map[m_it->second];
+		++m_it;
+	}
 }
 
 abnf_ruleset::~abnf_ruleset(void)
 {
-	set<abnf_rule*>::const_iterator it = _r_set.begin();
-	while (it not_eq _r_set.end())
+	// Memory of rules is released at once by deleting their arena
+	vector<abnf_rule*>::const_iterator it = _r_vect.begin();
+	while (it not_eq _r_vect.end())
 		delete *it++;
+	delete _empty_r;
+	delete _prog;
+	delete _r_arena;
+	delete _arena;
 }
 
 void abnf_ruleset::include(const abnf_ruleset& rset)
 {
-	std::map<const abnf_rule*, abnf_rule_ri*> d_map;
-	
-	// Duplicates all rules of copied rule set and store them to d_map
-	set<abnf_rule*>::const_iterator a_it = rset._r_set.begin();
-	while (a_it not_eq rset._r_set.end())
-		abnf_rule_ri::cast(**a_it++).dupl(*this, d_map);
-		
-	// Store duplicated rules to this rule set
-	map<const abnf_rule*, abnf_rule_ri*>::const_iterator it = d_map.begin();
-	while (it not_eq d_map.end())
-		_r_set.insert(it++->second);
-		
-	// Define rules as are defined in copied rule set
-	map<string, abnf_rule*>::const_iterator m_it = rset._r_map.begin();
-	while (m_it not_eq rset._r_map.end())
-		_r_map[m_it->first] = d_map[m_it++->second];
+	if (rset.includes(*this))
+		throw invalid_argument("rule set including this one");
+	_rset_vect.push_back(&rset);
 }
 
 bool abnf_ruleset::defined(const char* r_name) const
 {
 	string str = r_name;
 	transform(str.begin(), str.end(), str.begin(), ::tolower);
-	map<string, abnf_rule*>::const_iterator it = _r_map.find(str);
 	
 	// If found, defined. If not, undefined
-	return it not_eq _r_map.end();
+	return find(str) not_eq NULL;
 }
 
 abnf_rule& abnf_ruleset::get(const char* r_name) const
 {
 	string str = r_name;
 	transform(str.begin(), str.end(), str.begin(), ::tolower);
-	map<string, abnf_rule*>::const_iterator it = _r_map.find(str);
+	abnf_rule* r = find(str);
 	
 	// Not defined, give the empty rule
-	if (it == _r_map.end())
+	if (r == NULL)
 		return *_empty_r;
 	
 	// Defined rule
-	return *it->second;
+	return *r;
 }
 
 abnf_rule& abnf_ruleset::define(const char* r_name, abnf_rule& r)
 {
-	owner_test(*this, r);
+	owner_only_test(*this, r);
+	
+	abnf_rule_ri::cast(r).captured_set(true);
+	++_changes;
 	
 	string str = r_name;
 	transform(str.begin(), str.end(), str.begin(), ::tolower);
 	return *(_r_map[str] = &r);
 }
 
+void abnf_ruleset::capture(abnf_rule& r, bool cap)
+{
+	owner_only_test(*this, r);
+	abnf_rule_ri::cast(r).captured_set(cap);
+	++_changes;
+}
+
+void abnf_ruleset::action(abnf_rule& r, abnf_action act)
+{
+	owner_only_test(*this, r);
+	abnf_rule_ri::cast(r).action_set(act);
+	++_changes;
+}
+
+abnf_rule* abnf_ruleset::find(const string& str) const
+{
+	map<string, abnf_rule*>::const_iterator it = _r_map.find(str);
+	if (it not_eq _r_map.end())
+		return it->second;
+	
+	// Last included rule sets first
+	vector<const abnf_ruleset*>::const_reverse_iterator r_it =
+			_rset_vect.rbegin();
+	while (r_it not_eq _rset_vect.rend())
+	{
+		abnf_rule* r = (*r_it++)->find(str);
+		if (r not_eq NULL)
+			return r;
+	}
+	return NULL;
+}
+
+bool abnf_ruleset::includes(const abnf_ruleset& rset) const
+{
+	if (&rset == this)
+		return true;
+	
+	vector<const abnf_ruleset*>::const_iterator it = _rset_vect.begin();
+	while (it not_eq _rset_vect.end())
+		if ((*it++)->includes(rset))
+			return true;
+	return false;
+}
+
+size_t abnf_ruleset::changes(void) const
+{
+	size_t n = _changes;
+	
+	vector<const abnf_ruleset*>::const_iterator it = _rset_vect.begin();
+	while (it not_eq _rset_vect.end())
+		n += (*it++)->changes();
+	return n;
+}
+
+void abnf_ruleset::arena_reset(void) const
+{
+	_arena->reset();
+	
+	vector<const abnf_ruleset*>::const_iterator it = _rset_vect.begin();
+	while (it not_eq _rset_vect.end())
+		(*it++)->arena_reset();
+}
+
+void abnf_ruleset::optimize(void)
+{
+	vector<abnf_rule*>::const_iterator it = _r_vect.begin();
+	while (it not_eq _r_vect.end())
+		abnf_rule_ri::cast(**it++).optimize();
+}
+
 /*
  * abnf_matcher_empty implementation
  */
@@ -189,21 +304,40 @@ bool abnf_matcher_empty::match_impl(istream& is)
  * abnf_rule_empty implementation
  */
 
-abnf_matcher* abnf_rule_empty::matcher_new(void)
+abnf_matcher* abnf_rule_empty::matcher_new_impl(void)
+{
+	return new (arena()) abnf_matcher_empty(*this);
+}
+
+bool abnf_rule_empty::charset(abnf_charset& cs)
 {
-	return new abnf_matcher_empty(*this);
+	return false;
 }
 
 void abnf_rule_empty::clear_impl(void)
 {
 }
 
-void abnf_rule_empty::stream_update_impl(std::istream& is)
+void abnf_rule_empty::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_empty::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_empty(rset);
+	return new (rset) abnf_rule_empty(rset);
+}
+
+int abnf_rule_empty::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_FAIL);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_empty::first_impl(abnf_charset& cs)
+{
+	return true;
 }
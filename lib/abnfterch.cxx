@@ -19,6 +19,7 @@
  */
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -74,12 +75,17 @@ public abnf_rule_ri
 	{
 	}
 	
+	/*
+	 * Terminal character.
+	 */
+	bool charset(abnf_charset& cs);
+	
 	protected:
 	
 	/*
 	 * Creates a character terminal matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done.
@@ -89,13 +95,23 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
@@ -113,7 +129,12 @@ using namespace xspider;
  
 abnf_rule& abnf_ruleset::terminal(int ter_ch)
 {
-	return **_r_set.insert(new abnf_rule_terch(*this, ter_ch)).first;
+	abnf_rule*& r = cons(abnf_rule_key(ABNF_RULE_TERCH) << ter_ch);
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	r = store(new (*this) abnf_rule_terch(*this, ter_ch));
+	return *r;
 }
 
 /*
@@ -127,28 +148,49 @@ void abnf_matcher_terch::commit_impl(void)
 bool abnf_matcher_terch::match_impl(istream& is)
 {
 	char c;
-	return is.good() and (is.get(c), c) == _ch;
+	return is.get(c) and (unsigned char) c == _ch;
 }
 
 /*
  * abnf_rule_terch implementation
  */
 
-abnf_matcher* abnf_rule_terch::matcher_new(void)
+abnf_matcher* abnf_rule_terch::matcher_new_impl(void)
 {
-	return new abnf_matcher_terch(*this, _ch);
+	return new (arena()) abnf_matcher_terch(*this, _ch);
+}
+
+bool abnf_rule_terch::charset(abnf_charset& cs)
+{
+	cs.set(_ch);
+	return true;
 }
 
 void abnf_rule_terch::clear_impl(void)
 {
 }
 
-void abnf_rule_terch::stream_update_impl(std::istream& is)
+void abnf_rule_terch::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_terch::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_terch(rset, _ch);
+	return new (rset) abnf_rule_terch(rset, _ch);
+}
+
+int abnf_rule_terch::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_CHAR, _ch);
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_terch::first_impl(abnf_charset& cs)
+{
+	charset(cs);
+	return false;
 }
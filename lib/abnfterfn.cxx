@@ -19,6 +19,7 @@
  */
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -81,12 +82,17 @@ public abnf_rule_ri
 	{
 	}
 	
+	/*
+	 * Characters accepted by the terminal function, at the current locale.
+	 */
+	bool charset(abnf_charset& cs);
+	
 	protected:
 	
 	/*
 	 * Creates a function terminal matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done.
@@ -96,13 +102,23 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
@@ -120,7 +136,12 @@ using namespace xspider;
  
 abnf_rule& abnf_ruleset::terminal(int (*ter_fn)(int))
 {
-	return **_r_set.insert(new abnf_rule_terfn(*this, ter_fn)).first;
+	abnf_rule*& r = cons(abnf_rule_key(ABNF_RULE_TERFN) << ter_fn);
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	r = store(new (*this) abnf_rule_terfn(*this, ter_fn));
+	return *r;
 }
 
 /*
@@ -134,7 +155,7 @@ void abnf_matcher_terfn::commit_impl(void)
 bool abnf_matcher_terfn::match_impl(istream& is)
 {
 	char c;
-	return is.good() and _fn((is.get(c), c)) > 0;
+	return is.get(c) and _fn((unsigned char) c) > 0;
 }
 
 /*
@@ -146,21 +167,44 @@ int xspider::abnf_terfn_false(int c)
 	return 0;
 }
 
-abnf_matcher* abnf_rule_terfn::matcher_new(void)
+abnf_matcher* abnf_rule_terfn::matcher_new_impl(void)
 {
-	return new abnf_matcher_terfn(*this, _fn);
+	return new (arena()) abnf_matcher_terfn(*this, _fn);
+}
+
+bool abnf_rule_terfn::charset(abnf_charset& cs)
+{
+	for (int c = 0; c < 256; ++c)
+		if (_fn(c) > 0)
+			cs.set(c);
+	return true;
 }
 
 void abnf_rule_terfn::clear_impl(void)
 {
 }
 
-void abnf_rule_terfn::stream_update_impl(std::istream& is)
+void abnf_rule_terfn::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_terfn::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_terfn(rset, _fn);
+	return new (rset) abnf_rule_terfn(rset, _fn);
+}
+
+int abnf_rule_terfn::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_FN, prog.fn_id(_fn));
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_terfn::first_impl(abnf_charset& cs)
+{
+	charset(cs);
+	return false;
 }
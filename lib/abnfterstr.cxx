@@ -19,6 +19,7 @@
  */
 
 #include "abnfm.h"
+#include "abnfp.h"
 
 namespace xspider {
 
@@ -74,12 +75,23 @@ public abnf_rule_ri
 	{
 	}
 	
+	/*
+	 * Characters equal to a single character terminal string, case
+	 * insensitive.
+	 */
+	bool charset(abnf_charset& cs);
+	
+	/*
+	 * Character string of this terminal.
+	 */
+	bool literal(std::string& str);
+	
 	protected:
 	
 	/*
 	 * Creates a string terminal matcher.
 	 */
-	abnf_matcher* matcher_new(void);
+	abnf_matcher* matcher_new_impl(void);
 	
 	/*
 	 * Nothing to be done.
@@ -89,13 +101,23 @@ public abnf_rule_ri
 	/*
 	 * Nothing to be done.
 	 */
-	void stream_update_impl(std::istream& is);
+	void stream_update_impl(std::istream* is, const char* buf);
 	
 	/*
 	 * Duplicate operation implementation.
 	 */
 	abnf_rule_ri* dupl_impl(const abnf_ruleset& rset,
 			std::map<const abnf_rule*, abnf_rule_ri*>& d_map) const;
+	
+	/*
+	 * Compile operation implementation.
+	 */
+	int compile_impl(abnf_program& prog);
+	
+	/*
+	 * First operation implementation.
+	 */
+	bool first_impl(abnf_charset& cs);
 			
 	private:
 	
@@ -113,7 +135,12 @@ using namespace xspider;
  
 abnf_rule& abnf_ruleset::terminal(const char* ter_str)
 {
-	return **_r_set.insert(new abnf_rule_terstr(*this, ter_str)).first;
+	abnf_rule*& r = cons(abnf_rule_key(ABNF_RULE_TERSTR) << ter_str);
+	if (r not_eq NULL)
+		return alias(*r);
+	
+	r = store(new (*this) abnf_rule_terstr(*this, ter_str));
+	return *r;
 }
 
 /*
@@ -132,7 +159,8 @@ bool abnf_matcher_terstr::match_impl(istream& is)
 	char c;
 	string::const_iterator it = _str.begin();
 	while (it not_eq _str.end())
-		if (is.bad() or tolower(*it++) not_eq tolower((is.get(c), c)))
+		if (not is.get(c) or tolower((unsigned char) *it++) not_eq
+				tolower((unsigned char) c))
 			return false;
 	return true;
 }
@@ -141,21 +169,60 @@ bool abnf_matcher_terstr::match_impl(istream& is)
  * abnf_rule_terstr implementation
  */
 
-abnf_matcher* abnf_rule_terstr::matcher_new(void)
+abnf_matcher* abnf_rule_terstr::matcher_new_impl(void)
+{
+	return new (arena()) abnf_matcher_terstr(*this, _str);
+}
+
+bool abnf_rule_terstr::literal(string& str)
 {
-	return new abnf_matcher_terstr(*this, _str);
+	str = _str;
+	return true;
+}
+
+bool abnf_rule_terstr::charset(abnf_charset& cs)
+{
+	if (_str.size() not_eq 1)
+		return false;
+	
+	int ch = tolower((unsigned char) _str[0]);
+	for (int c = 0; c < 256; ++c)
+		if (tolower(c) == ch)
+			cs.set(c);
+	return true;
 }
 
 void abnf_rule_terstr::clear_impl(void)
 {
 }
 
-void abnf_rule_terstr::stream_update_impl(std::istream& is)
+void abnf_rule_terstr::stream_update_impl(std::istream* is,
+		const char* buf)
 {
 }
 
 abnf_rule_ri* abnf_rule_terstr::dupl_impl(const abnf_ruleset& rset,
 		map<const abnf_rule*, abnf_rule_ri*>& d_map) const
 {
-	return new abnf_rule_terstr(rset, _str.c_str());
+	return new (rset) abnf_rule_terstr(rset, _str.c_str());
+}
+
+int abnf_rule_terstr::compile_impl(abnf_program& prog)
+{
+	int pc = prog.size();
+	prog.emit(ABNF_OP_STR, prog.string_id(_str));
+	prog.emit(ABNF_OP_RET);
+	return pc;
+}
+
+bool abnf_rule_terstr::first_impl(abnf_charset& cs)
+{
+	if (_str.empty())
+		return false;
+	
+	int ch = tolower((unsigned char) _str[0]);
+	for (int c = 0; c < 256; ++c)
+		if (tolower(c) == ch)
+			cs.set(c);
+	return false;
 }
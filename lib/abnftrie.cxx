@@ -0,0 +1,96 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <algorithm>
+#include <cctype>
+
+#include "abnfr.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * abnf_trie implementation
+ */
+
+abnf_trie::abnf_trie(void):
+_ch(1, 0),
+_child(1, -1),
+_sibling(1, -1),
+_end(1, -1)
+{
+}
+
+void abnf_trie::add(const string& str)
+{
+	int node = 0;
+	string lstr;
+	string::const_iterator it = str.begin();
+	while (it not_eq str.end())
+	{
+		unsigned char c = tolower((unsigned char) *it++);
+		lstr += c;
+		int ch = child(node, c);
+		if (ch < 0)
+		{
+			ch = _ch.size();
+			_ch.push_back(c);
+			_child.push_back(-1);
+			_sibling.push_back(_child[node]);
+			_end.push_back(-1);
+			_child[node] = ch;
+		}
+		node = ch;
+	}
+	
+	// The root is never reached when finding, so empty strings end nowhere
+	_end_next.push_back(node > 0 ? _end[node] : -1);
+	if (node > 0)
+		_end[node] = _str.size();
+	_str.push_back(lstr);
+}
+
+void abnf_trie::find(const char* s, size_t len, vector<size_t>& idx) const
+{
+	size_t n = idx.size();
+	int node = 0;
+	for (size_t i = 0; i < len; ++i)
+	{
+		if ((node = child(node, tolower((unsigned char) s[i]))) < 0)
+			break;
+		end_find(node, idx);
+	}
+	sort(idx.begin() + n, idx.end());
+}
+
+void abnf_trie::find(istream& is, vector<size_t>& idx) const
+{
+	size_t n = idx.size();
+	int node = 0;
+	char c;
+	while (_child[node] >= 0 and is.get(c))
+	{
+		if ((node = child(node, tolower((unsigned char) c))) < 0)
+			break;
+		end_find(node, idx);
+	}
+	sort(idx.begin() + n, idx.end());
+}
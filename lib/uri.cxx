@@ -18,12 +18,29 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
  */
  
-#include <sstream>
+#include <climits>
+#include <cstring>
 
 #include "uri.h"
 
 #define DEFAULT_PORT 0l
 
+/*
+ * URI components, given by their named rules.
+ */
+enum uri_segment
+{
+	URI_SCHEME,
+	URI_USERINFO,
+	URI_HOST,
+	URI_FRAGMENT,
+	URI_PORT,
+	URI_ABS_PATH,
+	URI_REL_PATH,
+	URI_QUERY,
+	URI_SEGMENT_COUNT
+};
+
 using namespace std;
 using namespace xspider;
 
@@ -31,7 +48,19 @@ using namespace xspider;
  * uri implementation
  */
 
-static void uri_abnf_ruleset(abnf_ruleset& rset);
+static abnf_ruleset& uri_abnf_ruleset(abnf_ruleset& rset);
+
+/*
+ * Action of the named rule of the ith URI component, which keeps its first
+ * segment in the component array given as data.
+ */
+template <int i>
+static void uri_action(void* data, const abnf_rule&, const abnf_span& s)
+{
+	abnf_span* comp = static_cast<abnf_span*>(data);
+	if (comp[i].empty())
+		comp[i] = s;
+}
 
 abnf_ruleset uri::_rset;
 
@@ -42,107 +71,107 @@ _port(DEFAULT_PORT)
 
 uri::uri(const string& s)
 {
-	stringstream ss(s);
-	ss >> *this;
+	abnf_span comp[URI_SEGMENT_COUNT];
+	abnf_result res(comp);
+	rule().read(s.data(), s.size(), res);
+	assign(comp);
 } 
 
-istream& xspider::operator >> (istream& is, uri& u)
+const abnf_ruleset& uri::ruleset(void)
 {
-	u._scheme.clear();
-	u._userinfo.clear();
-	u._host.clear();
-	u._fragment.clear();
-	u._path.clear();
-	u._query.clear();
-	
-	abnf_ruleset& rset = uri::_rset;
-	if (not rset.defined("ALPHA"))
-		uri_abnf_ruleset(rset);
-	
-	abnf_rule& r_uriend = rset.get("URI-reference");
-	abnf_rule& r_scheme = rset.get("scheme");
-	abnf_rule& r_userinfo = rset.get("userinfo");
-	abnf_rule& r_host = rset.get("host");
-	abnf_rule& r_fragment = rset.get("fragment");
-	abnf_rule& r_port = rset.get("port");
-	abnf_rule& r_abs_path = rset.get("abs_path");
-	abnf_rule& r_rel_path = rset.get("rel_path");
-	abnf_rule& r_query = rset.get("query");
+	rule();
+	return _rset;
+}
+
+const abnf_rule& uri::rule(void)
+{
+	// Initialization of function statics is done once, even by concurrent
+	// callers
+	static const abnf_ruleset& rset = uri_abnf_ruleset(_rset);
+	return rset.get("URI-reference");
+}
+
+void uri::assign(const abnf_span comp[])
+{
+	_scheme = comp[URI_SCHEME].str();
+	_userinfo = comp[URI_USERINFO].str();
+	_host = comp[URI_HOST].str();
+	_fragment = comp[URI_FRAGMENT].str();
+	_path.clear();
+	_query.clear();
 	
-	r_uriend.read(is);
-	if (r_scheme.read_count() > 0)
+	// The port rule matches digits only. Ports which do not fit are clamped,
+	// as extracting them from a stream does
+	_port = DEFAULT_PORT;
+	const char* p = comp[URI_PORT].data();
+	for (size_t i = 0; i < comp[URI_PORT].length(); ++i)
 	{
-		ostringstream oss;
-		r_scheme.write(0, oss);
-		u._scheme = oss.str();
-	}
-	if (r_userinfo.read_count() > 0)
-	{
-		ostringstream oss;
-		r_userinfo.write(0, oss);
-		u._userinfo = oss.str();
-	}
-	if (r_host.read_count() > 0)
-	{
-		ostringstream oss;
-		r_host.write(0, oss);
-		u._host = oss.str();
-	}
-	if (r_fragment.read_count() > 0)
-	{
-		ostringstream oss;
-		r_fragment.write(0, oss);
-		u._fragment = oss.str();
-	}
-	if (r_port.read_count() == 0)
-		u._port = DEFAULT_PORT;
-	else
-	{
-		stringstream ss;
-		r_port.write(0, ss);
-		ss >> u._port;
+		unsigned long d = p[i] - '0';
+		if (_port > (ULONG_MAX - d) / 10)
+		{
+			_port = ULONG_MAX;
+			break;
+		}
+		_port = _port * 10 + d;
 	}
-	bool has_rel_path = r_rel_path.read_count() > 0;
-	if (r_abs_path.read_count() > 0 or has_rel_path)
+	
+	// Path segments are split from the path characters, the absolute path
+	// beginning with a "/" segment
+	bool has_rel_path = not comp[URI_REL_PATH].empty();
+	const abnf_span& path = comp[has_rel_path ? URI_REL_PATH : URI_ABS_PATH];
+	if (not path.empty())
 	{
-		stringstream ss;
-		if (has_rel_path)
-			r_rel_path.write(0, ss);
-		else
+		const char* s = path.data();
+		const char* end = s + path.length();
+		if (not has_rel_path)
 		{
-			r_abs_path.write(0, ss);
-			ss.ignore();
-			u._path.push_back("/");
+			_path.push_back("/");
+			++s;
 		}
-		
-		const int seg_max = 1024;
-		char seg[seg_max];
-		while (ss.good())
+		for (;;)
 		{
-			ss.getline(seg, seg_max, '/');
-			u._path.push_back(seg);
+			const char* sep = static_cast<const char*>(memchr(s, '/',
+					end - s));
+			if (sep == NULL)
+				sep = end;
+			_path.push_back(string(s, sep));
+			if (sep == end)
+				break;
+			s = sep + 1;
 		}
 	}
-	if (r_query.read_count() > 0)
+	
+	// Query parameters are split from the query characters
+	if (not comp[URI_QUERY].empty())
 	{
-		stringstream ss;
-		r_query.write(0, ss);
-		
-		const int seg_max = 1024;
-		char seg[seg_max];
-		while (ss.good())
+		const char* s = comp[URI_QUERY].data();
+		const char* end = s + comp[URI_QUERY].length();
+		for (;;)
 		{
-			ss.getline(seg, seg_max, '&');
-			string str = seg;
-			int sep = str.find_first_of('=');
-			if (sep == string::npos)
-				u._query.insert(pair<string, string>(str, ""));
+			const char* sep = static_cast<const char*>(memchr(s, '&',
+					end - s));
+			if (sep == NULL)
+				sep = end;
+			const char* eq = static_cast<const char*>(memchr(s, '=',
+					sep - s));
+			if (eq == NULL)
+				_query.insert(pair<string, string>(string(s, sep), ""));
 			else
-				u._query.insert(pair<string, string>(str.substr(0, sep),
-						str.substr(sep + 1)));
+				_query.insert(pair<string, string>(string(s, eq),
+						string(eq + 1, sep)));
+			if (sep == end)
+				break;
+			s = sep + 1;
 		}
 	}
-	r_uriend.clear();
+}
+
+istream& xspider::operator >> (istream& is, uri& u)
+{
+	abnf_span comp[URI_SEGMENT_COUNT];
+	abnf_result res(comp);
+	uri::rule().read(is, res);
+	u.assign(comp);
 	
 	return is;
 }
@@ -198,7 +227,7 @@ ostream& xspider::operator << (ostream& os, const uri& u)
 	return os;
 }
 
-void uri_abnf_ruleset(abnf_ruleset& rset)
+abnf_ruleset& uri_abnf_ruleset(abnf_ruleset& rset)
 {
 	rset.include(abnf_ruleset::core_ruleset());
 	abnf_rule& r_alphanum = rset.terminal(isalnum);
@@ -211,28 +240,29 @@ void uri_abnf_ruleset(abnf_ruleset& rset)
 	abnf_rule& r_reserved = rset.alternat(";/?:@&=+$,");
 	abnf_rule& r_res_unres = rset.alternat(r_reserved, r_unreserved);
 	abnf_rule& r_uric = rset.alternat(r_res_unres, r_escaped);
-	abnf_rule& r_fragment = rset.repet(0, r_uric);
-	abnf_rule& r_query = rset.repet(0, r_uric);
+	abnf_rule& r_fragment = rset.repet(0, r_uric, ABNF_REPET_POSSESSIVE);
+	abnf_rule& r_query = rset.repet(0, r_uric, ABNF_REPET_POSSESSIVE);
 	abnf_rule& r_pcharch = rset.alternat(":@&=+$,");
 	abnf_rule& r_unres_esc = rset.alternat(r_unreserved, r_escaped);
 	abnf_rule& r_pchar = rset.alternat(r_unres_esc, r_pcharch);
-	abnf_rule& r_param = rset.repet(0, r_pchar);
+	abnf_rule& r_param = rset.repet(0, r_pchar, ABNF_REPET_POSSESSIVE);
 	abnf_rule& r_semic = rset.terminal(';');
 	abnf_rule& r_semicparam = rset.concat(r_semic, r_param);
-	abnf_rule& r_rsemicparam = rset.repet(0, r_semicparam);
-	abnf_rule& r_rpchar = rset.repet(0, r_pchar);
+	abnf_rule& r_rsemicparam = rset.repet(0, r_semicparam,
+			ABNF_REPET_POSSESSIVE);
+	abnf_rule& r_rpchar = rset.repet(0, r_pchar, ABNF_REPET_POSSESSIVE);
 	abnf_rule& r_segment = rset.concat(r_rpchar, r_rsemicparam);
 	abnf_rule& r_sl = rset.terminal('/');
 	abnf_rule& r_slseg = rset.concat(r_sl, r_segment);
-	abnf_rule& r_rslseg = rset.repet(0, r_slseg);
+	abnf_rule& r_rslseg = rset.repet(0, r_slseg, ABNF_REPET_POSSESSIVE);
 	abnf_rule& r_path_seg = rset.concat(r_segment, r_rslseg);
 	abnf_rule& r_abs_path = rset.concat(r_sl, r_path_seg);
 	abnf_rule& r_uric_no_slch = rset.alternat(";?:@&=+$,");
 	abnf_rule& r_uric_no_sl = rset.alternat(r_unres_esc, r_uric_no_slch);
-	abnf_rule& r_ruric = rset.repet(0, r_uric);
+	// Absolute URIs take all the characters they can, as those scanned for
+	// are not followed by the end of URI references
+	abnf_rule& r_ruric = rset.repet(0, r_uric, ABNF_REPET_POSSESSIVE);
 	abnf_rule& r_opaq_part = rset.concat(r_uric_no_sl, r_ruric);
-	abnf_rule& r_abs_path_opaq_part = rset.alternat(r_abs_path, r_opaq_part);
-	abnf_rule& r_path = rset.repet(0, 1, r_abs_path_opaq_part);
 	abnf_rule& r_digit = rset.get("digit");
 	abnf_rule& r_port = rset.repet(0, r_digit);
 	abnf_rule& r_rdigit = rset.repet(1, r_digit);
@@ -289,7 +319,7 @@ void uri_abnf_ruleset(abnf_ruleset& rset)
 	abnf_rule& r_net_path = rset.concat(r_dslashauth, r_abs_path);
 	abnf_rule& r_qm = rset.terminal('?');
 	abnf_rule& r_qmquery = rset.concat(r_qm, r_query);
-	abnf_rule& r_rqmquery = rset.repet(0, 1, r_qmquery);
+	abnf_rule& r_rqmquery = rset.repet(0, 1, r_qmquery, ABNF_REPET_GREEDY);
 	abnf_rule& r_npath_apath = rset.alternat(r_net_path, r_abs_path);
 	abnf_rule& r_hier_part = rset.concat(r_npath_apath, r_rqmquery);
 	abnf_rule& r_npth_apth_rpth = rset.alternat(r_npath_apath, r_rel_path);
@@ -315,4 +345,22 @@ void uri_abnf_ruleset(abnf_ruleset& rset)
 	rset.define("abs_path", r_abs_path);
 	rset.define("rel_path", r_rel_path);
 	rset.define("query", r_query);
+	rset.define("absoluteURI", r_absuri);
+	
+	// Named to be scanned for, but not needed while reading
+	rset.capture(r_absuri, false);
+	
+	// Components are taken while reading
+	rset.action(r_scheme, uri_action<URI_SCHEME>);
+	rset.action(r_userinfo, uri_action<URI_USERINFO>);
+	rset.action(r_host, uri_action<URI_HOST>);
+	rset.action(r_fragment, uri_action<URI_FRAGMENT>);
+	rset.action(r_port, uri_action<URI_PORT>);
+	rset.action(r_abs_path, uri_action<URI_ABS_PATH>);
+	rset.action(r_rel_path, uri_action<URI_REL_PATH>);
+	rset.action(r_query, uri_action<URI_QUERY>);
+	
+	rset.optimize();
+	rset.compile();
+	return rset;
 }
@@ -0,0 +1,4445 @@
+/*
+ * Parser of the "uri-reference" rule, generated by abnf_ruleset::generate.
+ */
+
+#include "urigen.h"
+
+using namespace xspider;
+
+static const unsigned char urigen_class_0[32] =
+{
+	0, 0, 0, 0, 0, 104, 255, 3,
+	254, 255, 255, 7, 254, 255, 255, 7,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_1[32] =
+{
+	0, 0, 0, 0, 130, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_2[32] =
+{
+	0, 0, 0, 0, 130, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_3[32] =
+{
+	0, 0, 0, 0, 32, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_4[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 44,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_5[32] =
+{
+	0, 0, 0, 0, 162, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_6[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 44,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_7[32] =
+{
+	0, 0, 0, 0, 0, 32, 255, 3,
+	254, 255, 255, 7, 254, 255, 255, 7,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_8[32] =
+{
+	0, 0, 0, 0, 0, 64, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_9[32] =
+{
+	0, 0, 0, 0, 0, 0, 255, 3,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_10[32] =
+{
+	0, 0, 0, 0, 0, 0, 255, 3,
+	254, 255, 255, 7, 254, 255, 255, 7,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_11[32] =
+{
+	0, 0, 0, 0, 0, 0, 255, 3,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_12[32] =
+{
+	0, 0, 0, 0, 0, 0, 255, 3,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_13[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 44,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_14[32] =
+{
+	0, 0, 0, 0, 162, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_15[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 44,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_16[32] =
+{
+	0, 0, 0, 0, 242, 127, 255, 47,
+	255, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_17[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 36,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_18[32] =
+{
+	0, 0, 0, 0, 162, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_19[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 36,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_20[32] =
+{
+	0, 0, 0, 0, 0, 128, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_21[32] =
+{
+	0, 0, 0, 0, 0, 128, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_22[32] =
+{
+	0, 0, 0, 0, 210, 255, 255, 175,
+	255, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_23[32] =
+{
+	0, 0, 0, 0, 210, 255, 255, 175,
+	255, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_24[32] =
+{
+	0, 0, 0, 0, 32, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_25[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 172,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_26[32] =
+{
+	0, 0, 0, 0, 162, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_27[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 172,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_28[32] =
+{
+	0, 0, 0, 0, 0, 128, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_29[32] =
+{
+	0, 0, 0, 0, 242, 127, 255, 175,
+	255, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_30[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 40,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_31[32] =
+{
+	0, 0, 0, 0, 162, 103, 255, 3,
+	254, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_32[32] =
+{
+	0, 0, 0, 0, 80, 24, 0, 40,
+	1, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_33[32] =
+{
+	0, 0, 0, 0, 0, 128, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_34[32] =
+{
+	0, 0, 0, 0, 242, 127, 255, 43,
+	255, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_35[32] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0,
+	254, 255, 255, 7, 254, 255, 255, 7,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_36[32] =
+{
+	0, 0, 0, 0, 242, 255, 255, 43,
+	255, 255, 255, 135, 254, 255, 255, 71,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_class_37[32] =
+{
+	0, 62, 0, 0, 1, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_fn_0[32] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0,
+	254, 255, 255, 7, 254, 255, 255, 7,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_fn_1[32] =
+{
+	0, 0, 0, 0, 0, 0, 255, 3,
+	126, 0, 0, 0, 126, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_fn_2[32] =
+{
+	0, 0, 0, 0, 0, 0, 255, 3,
+	254, 255, 255, 7, 254, 255, 255, 7,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_fn_3[32] =
+{
+	0, 62, 0, 0, 1, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const unsigned char urigen_str_0[] =
+{
+	47, 47, 0
+};
+
+/*
+ * Stores the beg,end segment of the rule with index r, if it is named or its
+ * characters are.
+ */
+static bool urigen_capture(abnf_gen_result& res, const char* buf, int r,
+		size_t beg, size_t end)
+{
+	switch (r)
+	{
+		case 2:
+		if (not res.segment_add(7, beg, end))
+			return false;
+		break;
+		
+		case 14:
+		if (not res.segment_add(9, beg, end))
+			return false;
+		break;
+		
+		case 39:
+		if (not res.segment_add(3, beg, end))
+			return false;
+		break;
+		
+		case 40:
+		if (not res.segment_add(4, beg, end))
+			return false;
+		break;
+		
+		case 63:
+		if (not res.segment_add(0, beg, end))
+			return false;
+		break;
+		
+		case 69:
+		if (not res.segment_add(2, beg, end))
+			return false;
+		break;
+		
+		case 70:
+		if (not res.segment_add(5, beg, end))
+			return false;
+		break;
+		
+		case 79:
+		if (not res.segment_add(1, beg, end))
+			return false;
+		break;
+		
+		case 84:
+		if (not res.segment_add(6, beg, end))
+			return false;
+		break;
+		
+		case 96:
+		if (not res.segment_add(8, beg, end))
+			return false;
+		break;
+		
+		default:
+		break;
+	}
+	return true;
+}
+
+int xspider::urigen_read(const char* buf, size_t len, abnf_gen_result& res)
+{
+	abnf_gen_frame f_vect[ABNF_GEN_STACK_MAX];
+	abnf_gen_choice ch_vect[ABNF_GEN_STACK_MAX];
+	size_t f_count = 1, ch_count = 0, pos = 0;
+	int f = 0, pc;
+	
+	res.start(buf);
+	f_vect[0] = abnf_gen_frame(-1, -1, 96, 0, 0, 0, 0);
+	goto L341;
+	
+	dispatch:
+	switch (pc)
+	{
+		case 3:
+		goto L3;
+		
+		case 6:
+		goto L6;
+		
+		case 7:
+		goto L7;
+		
+		case 11:
+		goto L11;
+		
+		case 12:
+		goto L12;
+		
+		case 22:
+		goto L22;
+		
+		case 23:
+		goto L23;
+		
+		case 25:
+		goto L25;
+		
+		case 26:
+		goto L26;
+		
+		case 31:
+		goto L31;
+		
+		case 32:
+		goto L32;
+		
+		case 33:
+		goto L33;
+		
+		case 40:
+		goto L40;
+		
+		case 41:
+		goto L41;
+		
+		case 42:
+		goto L42;
+		
+		case 44:
+		goto L44;
+		
+		case 45:
+		goto L45;
+		
+		case 50:
+		goto L50;
+		
+		case 51:
+		goto L51;
+		
+		case 53:
+		goto L53;
+		
+		case 54:
+		goto L54;
+		
+		case 59:
+		goto L59;
+		
+		case 62:
+		goto L62;
+		
+		case 63:
+		goto L63;
+		
+		case 65:
+		goto L65;
+		
+		case 66:
+		goto L66;
+		
+		case 68:
+		goto L68;
+		
+		case 70:
+		goto L70;
+		
+		case 71:
+		goto L71;
+		
+		case 73:
+		goto L73;
+		
+		case 78:
+		goto L78;
+		
+		case 79:
+		goto L79;
+		
+		case 81:
+		goto L81;
+		
+		case 82:
+		goto L82;
+		
+		case 85:
+		goto L85;
+		
+		case 86:
+		goto L86;
+		
+		case 88:
+		goto L88;
+		
+		case 89:
+		goto L89;
+		
+		case 91:
+		goto L91;
+		
+		case 93:
+		goto L93;
+		
+		case 94:
+		goto L94;
+		
+		case 96:
+		goto L96;
+		
+		case 99:
+		goto L99;
+		
+		case 100:
+		goto L100;
+		
+		case 102:
+		goto L102;
+		
+		case 105:
+		goto L105;
+		
+		case 106:
+		goto L106;
+		
+		case 108:
+		goto L108;
+		
+		case 111:
+		goto L111;
+		
+		case 112:
+		goto L112;
+		
+		case 114:
+		goto L114;
+		
+		case 115:
+		goto L115;
+		
+		case 117:
+		goto L117;
+		
+		case 118:
+		goto L118;
+		
+		case 120:
+		goto L120;
+		
+		case 121:
+		goto L121;
+		
+		case 123:
+		goto L123;
+		
+		case 124:
+		goto L124;
+		
+		case 126:
+		goto L126;
+		
+		case 127:
+		goto L127;
+		
+		case 132:
+		goto L132;
+		
+		case 133:
+		goto L133;
+		
+		case 134:
+		goto L134;
+		
+		case 136:
+		goto L136;
+		
+		case 139:
+		goto L139;
+		
+		case 140:
+		goto L140;
+		
+		case 142:
+		goto L142;
+		
+		case 143:
+		goto L143;
+		
+		case 146:
+		goto L146;
+		
+		case 147:
+		goto L147;
+		
+		case 149:
+		goto L149;
+		
+		case 150:
+		goto L150;
+		
+		case 152:
+		goto L152;
+		
+		case 153:
+		goto L153;
+		
+		case 161:
+		goto L161;
+		
+		case 162:
+		goto L162;
+		
+		case 163:
+		goto L163;
+		
+		case 165:
+		goto L165;
+		
+		case 166:
+		goto L166;
+		
+		case 171:
+		goto L171;
+		
+		case 172:
+		goto L172;
+		
+		case 173:
+		goto L173;
+		
+		case 175:
+		goto L175;
+		
+		case 176:
+		goto L176;
+		
+		case 185:
+		goto L185;
+		
+		case 186:
+		goto L186;
+		
+		case 187:
+		goto L187;
+		
+		case 190:
+		goto L190;
+		
+		case 191:
+		goto L191;
+		
+		case 196:
+		goto L196;
+		
+		case 197:
+		goto L197;
+		
+		case 200:
+		goto L200;
+		
+		case 201:
+		goto L201;
+		
+		case 204:
+		goto L204;
+		
+		case 205:
+		goto L205;
+		
+		case 207:
+		goto L207;
+		
+		case 208:
+		goto L208;
+		
+		case 211:
+		goto L211;
+		
+		case 212:
+		goto L212;
+		
+		case 215:
+		goto L215;
+		
+		case 216:
+		goto L216;
+		
+		case 218:
+		goto L218;
+		
+		case 219:
+		goto L219;
+		
+		case 221:
+		goto L221;
+		
+		case 222:
+		goto L222;
+		
+		case 227:
+		goto L227;
+		
+		case 228:
+		goto L228;
+		
+		case 229:
+		goto L229;
+		
+		case 238:
+		goto L238;
+		
+		case 239:
+		goto L239;
+		
+		case 240:
+		goto L240;
+		
+		case 243:
+		goto L243;
+		
+		case 244:
+		goto L244;
+		
+		case 247:
+		goto L247;
+		
+		case 248:
+		goto L248;
+		
+		case 251:
+		goto L251;
+		
+		case 252:
+		goto L252;
+		
+		case 254:
+		goto L254;
+		
+		case 255:
+		goto L255;
+		
+		case 262:
+		goto L262;
+		
+		case 263:
+		goto L263;
+		
+		case 264:
+		goto L264;
+		
+		case 266:
+		goto L266;
+		
+		case 267:
+		goto L267;
+		
+		case 272:
+		goto L272;
+		
+		case 273:
+		goto L273;
+		
+		case 274:
+		goto L274;
+		
+		case 276:
+		goto L276;
+		
+		case 277:
+		goto L277;
+		
+		case 284:
+		goto L284;
+		
+		case 285:
+		goto L285;
+		
+		case 286:
+		goto L286;
+		
+		case 288:
+		goto L288;
+		
+		case 289:
+		goto L289;
+		
+		case 292:
+		goto L292;
+		
+		case 293:
+		goto L293;
+		
+		case 296:
+		goto L296;
+		
+		case 297:
+		goto L297;
+		
+		case 302:
+		goto L302;
+		
+		case 303:
+		goto L303;
+		
+		case 304:
+		goto L304;
+		
+		case 306:
+		goto L306;
+		
+		case 307:
+		goto L307;
+		
+		case 312:
+		goto L312;
+		
+		case 313:
+		goto L313;
+		
+		case 314:
+		goto L314;
+		
+		case 316:
+		goto L316;
+		
+		case 317:
+		goto L317;
+		
+		case 322:
+		goto L322;
+		
+		case 323:
+		goto L323;
+		
+		case 325:
+		goto L325;
+		
+		case 326:
+		goto L326;
+		
+		case 329:
+		goto L329;
+		
+		case 330:
+		goto L330;
+		
+		case 338:
+		goto L338;
+		
+		case 339:
+		goto L339;
+		
+		case 340:
+		goto L340;
+		
+		case 342:
+		goto L342;
+		
+		case 343:
+		goto L343;
+		
+		default:
+		break;
+	}
+	
+	fail:
+	if (ch_count == 0)
+	{
+		res.start(buf);
+		return 0;
+	}
+	{
+		const abnf_gen_choice& ch = ch_vect[--ch_count];
+		pc = ch.pc;
+		pos = ch.pos;
+		f = ch.f;
+		f_count = ch.f_count;
+		res.resize(ch.seg_count);
+	}
+	goto dispatch;
+	
+	L0:
+	if (pos == len or not abnf_gen_test(urigen_fn_0, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L2:
+	{
+		size_t max = len - pos < 2147483647u ? len - pos : 2147483647u;
+		size_t n = abnf_gen_span(urigen_class_0, buf + pos, max);
+		if (n < 0)
+			goto fail;
+		f_vect[f].iter = pos + n;
+		pos += 0;
+		if (pos < f_vect[f].iter)
+		{
+			if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(3, pos, f, f_count,
+			res.size());
+		}
+	}
+	goto L4;
+	
+	L3:
+	++pos;
+	if (pos < f_vect[f].iter)
+	{
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(3, pos, f, f_count,
+			res.size());
+	}
+	
+	L4:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L5:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 6, 0, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L0;
+	
+	L6:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 7, 1, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L2;
+	
+	L7:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L8:
+	if (pos == len or (unsigned char) buf[pos] not_eq 58)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L10:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 11, 2, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L5;
+	
+	L11:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 12, 3, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L8;
+	
+	L12:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L13:
+	if (len - pos < 2 or not abnf_gen_equal(urigen_str_0, buf + pos, 2))
+		goto fail;
+	pos += 2;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L15:
+	if (pos == len or not abnf_gen_test(urigen_class_1, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L17:
+	if (pos == len or (unsigned char) buf[pos] not_eq 37)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L19:
+	if (pos == len or not abnf_gen_test(urigen_fn_1, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L21:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 22, 8, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L19;
+	
+	L22:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 23, 8, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L19;
+	
+	L23:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L24:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 25, 7, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L17;
+	
+	L25:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 26, 9, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L21;
+	
+	L26:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L27:
+	if (pos == len or not abnf_gen_test(urigen_class_2, buf[pos]))
+		goto L32;
+	if (pos == len or not abnf_gen_test(urigen_class_3, buf[pos]))
+		goto L30;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(32, pos, f, f_count,
+			res.size());
+	
+	L30:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 31, 6, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L15;
+	
+	L31:
+	goto L33;
+	
+	L32:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 33, 10, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L24;
+	
+	L33:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L34:
+	if (pos == len or not abnf_gen_test(urigen_class_4, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L36:
+	if (pos == len or not abnf_gen_test(urigen_class_5, buf[pos]))
+		goto L41;
+	if (pos == len or not abnf_gen_test(urigen_class_6, buf[pos]))
+		goto L39;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(41, pos, f, f_count,
+			res.size());
+	
+	L39:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 40, 11, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L27;
+	
+	L40:
+	goto L42;
+	
+	L41:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 42, 12, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L34;
+	
+	L42:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L43:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L46;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(44, pos, f, f_count,
+			res.size());
+		goto L46;
+	}
+	
+	L44:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 45, 13, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L36;
+	
+	L45:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L43;
+	
+	L46:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L47:
+	if (pos == len or (unsigned char) buf[pos] not_eq 64)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L49:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 50, 14, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L43;
+	
+	L50:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 51, 15, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L47;
+	
+	L51:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L52:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L55;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(53, pos, f, f_count,
+			res.size());
+		goto L55;
+	}
+	
+	L53:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 54, 16, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L49;
+	
+	L54:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L52;
+	
+	L55:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L56:
+	if (pos == len or not abnf_gen_test(urigen_fn_2, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L58:
+	{
+		size_t max = len - pos < 2147483647u ? len - pos : 2147483647u;
+		size_t n = abnf_gen_span(urigen_class_7, buf + pos, max);
+		if (n < 0)
+			goto fail;
+		f_vect[f].iter = pos + n;
+		pos += 0;
+		if (pos < f_vect[f].iter)
+		{
+			if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(59, pos, f, f_count,
+			res.size());
+		}
+	}
+	goto L60;
+	
+	L59:
+	++pos;
+	if (pos < f_vect[f].iter)
+	{
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(59, pos, f, f_count,
+			res.size());
+	}
+	
+	L60:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L61:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 62, 18, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L56;
+	
+	L62:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 63, 19, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L58;
+	
+	L63:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 65, 20, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L61;
+	
+	L65:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 66, 18, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L56;
+	
+	L66:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L67:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 68, 18, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L56;
+	
+	L68:
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(70, pos, f, f_count,
+			res.size());
+	goto L74;
+	
+	L70:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 71, 19, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L58;
+	
+	L71:
+	if (pos > f_vect[f].beg and not urigen_capture(res, buf, 20,
+			f_vect[f].beg, pos))
+		return -1;
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 73, 18, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L56;
+	
+	L73:
+	if (pos > f_vect[f].beg and not urigen_capture(res, buf, 21,
+			f_vect[f].beg, pos))
+		return -1;
+	
+	L74:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L75:
+	if (pos == len or (unsigned char) buf[pos] not_eq 46)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L77:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 78, 22, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L67;
+	
+	L78:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 79, 23, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L75;
+	
+	L79:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L80:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L83;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(81, pos, f, f_count,
+			res.size());
+		goto L83;
+	}
+	
+	L81:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 82, 24, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L77;
+	
+	L82:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L80;
+	
+	L83:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L84:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 85, 0, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L0;
+	
+	L85:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 86, 19, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L58;
+	
+	L86:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 88, 26, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L84;
+	
+	L88:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 89, 18, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L56;
+	
+	L89:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L90:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 91, 0, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L0;
+	
+	L91:
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(93, pos, f, f_count,
+			res.size());
+	goto L97;
+	
+	L93:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 94, 19, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L58;
+	
+	L94:
+	if (pos > f_vect[f].beg and not urigen_capture(res, buf, 26,
+			f_vect[f].beg, pos))
+		return -1;
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 96, 18, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L56;
+	
+	L96:
+	if (pos > f_vect[f].beg and not urigen_capture(res, buf, 27,
+			f_vect[f].beg, pos))
+		return -1;
+	
+	L97:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L98:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 99, 25, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L80;
+	
+	L99:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 100, 28, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L90;
+	
+	L100:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L101:
+	{
+		size_t max = len - pos < 1u ? len - pos : 1u;
+		size_t n = abnf_gen_span(urigen_class_8, buf + pos, max);
+		if (n < 0)
+			goto fail;
+		f_vect[f].iter = pos + n;
+		pos += 0;
+		if (pos < f_vect[f].iter)
+		{
+			if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(102, pos, f, f_count,
+			res.size());
+		}
+	}
+	goto L103;
+	
+	L102:
+	++pos;
+	if (pos < f_vect[f].iter)
+	{
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(102, pos, f, f_count,
+			res.size());
+	}
+	
+	L103:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L104:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 105, 29, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L98;
+	
+	L105:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 106, 30, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L101;
+	
+	L106:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L107:
+	{
+		size_t max = len - pos < 2147483647u ? len - pos : 2147483647u;
+		size_t n = abnf_gen_span(urigen_class_9, buf + pos, max);
+		if (n < 1)
+			goto fail;
+		f_vect[f].iter = pos + n;
+		pos += 1;
+		if (pos < f_vect[f].iter)
+		{
+			if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(108, pos, f, f_count,
+			res.size());
+		}
+	}
+	goto L109;
+	
+	L108:
+	++pos;
+	if (pos < f_vect[f].iter)
+	{
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(108, pos, f, f_count,
+			res.size());
+	}
+	
+	L109:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L110:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 111, 32, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L107;
+	
+	L111:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 112, 23, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L75;
+	
+	L112:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L113:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 114, 33, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L110;
+	
+	L114:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 115, 32, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L107;
+	
+	L115:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L116:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 117, 34, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L113;
+	
+	L117:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 118, 23, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L75;
+	
+	L118:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L119:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 120, 35, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L116;
+	
+	L120:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 121, 32, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L107;
+	
+	L121:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L122:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 123, 36, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L119;
+	
+	L123:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 124, 23, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L75;
+	
+	L124:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L125:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 126, 37, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L122;
+	
+	L126:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 127, 32, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L107;
+	
+	L127:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L128:
+	if (pos == len or not abnf_gen_test(urigen_class_10, buf[pos]))
+		goto L133;
+	if (pos == len or not abnf_gen_test(urigen_class_11, buf[pos]))
+		goto L131;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(133, pos, f, f_count,
+			res.size());
+	
+	L131:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 132, 31, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L104;
+	
+	L132:
+	goto L134;
+	
+	L133:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 134, 38, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L125;
+	
+	L134:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L135:
+	{
+		size_t max = len - pos < 2147483647u ? len - pos : 2147483647u;
+		size_t n = abnf_gen_span(urigen_class_12, buf + pos, max);
+		if (n < 0)
+			goto fail;
+		f_vect[f].iter = pos + n;
+		pos += 0;
+		if (pos < f_vect[f].iter)
+		{
+			if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(136, pos, f, f_count,
+			res.size());
+		}
+	}
+	goto L137;
+	
+	L136:
+	++pos;
+	if (pos < f_vect[f].iter)
+	{
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(136, pos, f, f_count,
+			res.size());
+	}
+	
+	L137:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L138:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 139, 3, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L8;
+	
+	L139:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 140, 40, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L135;
+	
+	L140:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L141:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L144;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(142, pos, f, f_count,
+			res.size());
+		goto L144;
+	}
+	
+	L142:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 143, 41, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L138;
+	
+	L143:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L141;
+	
+	L144:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L145:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 146, 39, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L128;
+	
+	L146:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 147, 42, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L141;
+	
+	L147:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L148:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 149, 17, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L52;
+	
+	L149:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 150, 43, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L145;
+	
+	L150:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L151:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L154;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(152, pos, f, f_count,
+			res.size());
+		goto L154;
+	}
+	
+	L152:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 153, 44, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L148;
+	
+	L153:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L151;
+	
+	L154:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L155:
+	if (pos == len or not abnf_gen_test(urigen_class_13, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L157:
+	if (pos == len or not abnf_gen_test(urigen_class_14, buf[pos]))
+		goto L162;
+	if (pos == len or not abnf_gen_test(urigen_class_15, buf[pos]))
+		goto L160;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(162, pos, f, f_count,
+			res.size());
+	
+	L160:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 161, 11, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L27;
+	
+	L161:
+	goto L163;
+	
+	L162:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 163, 46, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L155;
+	
+	L163:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L164:
+	if (f_vect[f].count >= 1)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L167;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(165, pos, f, f_count,
+			res.size());
+		goto L167;
+	}
+	
+	L165:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 166, 47, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L157;
+	
+	L166:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 1)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L164;
+	
+	L167:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L168:
+	if (pos == len or not abnf_gen_test(urigen_class_16, buf[pos]))
+		goto L170;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(172, pos, f, f_count,
+			res.size());
+	
+	L170:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 171, 45, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L151;
+	
+	L171:
+	goto L173;
+	
+	L172:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 173, 48, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L164;
+	
+	L173:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L174:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 175, 5, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L13;
+	
+	L175:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 176, 49, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L168;
+	
+	L176:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L177:
+	if (pos == len or (unsigned char) buf[pos] not_eq 47)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L179:
+	if (pos == len or not abnf_gen_test(urigen_class_17, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L181:
+	if (pos == len or not abnf_gen_test(urigen_class_18, buf[pos]))
+		goto L186;
+	if (pos == len or not abnf_gen_test(urigen_class_19, buf[pos]))
+		goto L184;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(186, pos, f, f_count,
+			res.size());
+	
+	L184:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 185, 11, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L27;
+	
+	L185:
+	goto L187;
+	
+	L186:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 187, 52, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L179;
+	
+	L187:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L188:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L191;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(191, pos, f, f_count,
+			res.size());
+	}
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 190, 53, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L181;
+	
+	L190:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L188;
+	
+	L191:
+	ch_count = f_vect[f].cut;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L193:
+	if (pos == len or (unsigned char) buf[pos] not_eq 59)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L195:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 196, 56, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L193;
+	
+	L196:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 197, 54, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L188;
+	
+	L197:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L198:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L201;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(201, pos, f, f_count,
+			res.size());
+	}
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 200, 57, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L195;
+	
+	L200:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L198;
+	
+	L201:
+	ch_count = f_vect[f].cut;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L203:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 204, 55, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L188;
+	
+	L204:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 205, 58, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L198;
+	
+	L205:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L206:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 207, 51, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L177;
+	
+	L207:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 208, 59, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L203;
+	
+	L208:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L209:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L212;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(212, pos, f, f_count,
+			res.size());
+	}
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 211, 60, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L206;
+	
+	L211:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L209;
+	
+	L212:
+	ch_count = f_vect[f].cut;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L214:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 215, 59, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L203;
+	
+	L215:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 216, 61, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L209;
+	
+	L216:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L217:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 218, 51, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L177;
+	
+	L218:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 219, 62, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L214;
+	
+	L219:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L220:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 221, 50, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L174;
+	
+	L221:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 222, 63, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L217;
+	
+	L222:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L223:
+	if (pos == len or not abnf_gen_test(urigen_class_20, buf[pos]))
+		goto L228;
+	if (pos == len or not abnf_gen_test(urigen_class_21, buf[pos]))
+		goto L226;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(228, pos, f, f_count,
+			res.size());
+	
+	L226:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 227, 64, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L220;
+	
+	L227:
+	goto L229;
+	
+	L228:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 229, 63, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L217;
+	
+	L229:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L230:
+	if (pos == len or (unsigned char) buf[pos] not_eq 63)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L232:
+	if (pos == len or not abnf_gen_test(urigen_class_22, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L234:
+	if (pos == len or not abnf_gen_test(urigen_class_23, buf[pos]))
+		goto L239;
+	if (pos == len or not abnf_gen_test(urigen_class_24, buf[pos]))
+		goto L237;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(239, pos, f, f_count,
+			res.size());
+	
+	L237:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 238, 67, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L232;
+	
+	L238:
+	goto L240;
+	
+	L239:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 240, 10, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L24;
+	
+	L240:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L241:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L244;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(244, pos, f, f_count,
+			res.size());
+	}
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 243, 68, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L234;
+	
+	L243:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L241;
+	
+	L244:
+	ch_count = f_vect[f].cut;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L246:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 247, 66, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L230;
+	
+	L247:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 248, 70, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L241;
+	
+	L248:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L249:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L252;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(252, pos, f, f_count,
+			res.size());
+	}
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 251, 71, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L246;
+	
+	L251:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L249;
+	
+	L252:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L253:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 254, 65, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L223;
+	
+	L254:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 255, 72, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L249;
+	
+	L255:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L256:
+	if (pos == len or not abnf_gen_test(urigen_class_25, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L258:
+	if (pos == len or not abnf_gen_test(urigen_class_26, buf[pos]))
+		goto L263;
+	if (pos == len or not abnf_gen_test(urigen_class_27, buf[pos]))
+		goto L261;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(263, pos, f, f_count,
+			res.size());
+	
+	L261:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 262, 11, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L27;
+	
+	L262:
+	goto L264;
+	
+	L263:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 264, 74, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L256;
+	
+	L264:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L265:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 266, 75, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L258;
+	
+	L266:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 267, 76, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L241;
+	
+	L267:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L268:
+	if (pos == len or not abnf_gen_test(urigen_class_28, buf[pos]))
+		goto L273;
+	if (pos == len or not abnf_gen_test(urigen_class_29, buf[pos]))
+		goto L271;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(273, pos, f, f_count,
+			res.size());
+	
+	L271:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 272, 73, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L253;
+	
+	L272:
+	goto L274;
+	
+	L273:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 274, 77, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L265;
+	
+	L274:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L275:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 276, 4, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L10;
+	
+	L276:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 277, 78, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L268;
+	
+	L277:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L278:
+	if (pos == len or not abnf_gen_test(urigen_class_30, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L280:
+	if (pos == len or not abnf_gen_test(urigen_class_31, buf[pos]))
+		goto L285;
+	if (pos == len or not abnf_gen_test(urigen_class_32, buf[pos]))
+		goto L283;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(285, pos, f, f_count,
+			res.size());
+	
+	L283:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 284, 11, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L27;
+	
+	L284:
+	goto L286;
+	
+	L285:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 286, 80, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L278;
+	
+	L286:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L287:
+	if (f_vect[f].count >= 1)
+	{
+		if (f_vect[f].count >= 2147483647)
+			goto L290;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(288, pos, f, f_count,
+			res.size());
+		goto L290;
+	}
+	
+	L288:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 289, 81, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L280;
+	
+	L289:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 1)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L287;
+	
+	L290:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L291:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L294;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(292, pos, f, f_count,
+			res.size());
+		goto L294;
+	}
+	
+	L292:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 293, 63, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L217;
+	
+	L293:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L291;
+	
+	L294:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L295:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 296, 82, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L287;
+	
+	L296:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 297, 83, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L291;
+	
+	L297:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L298:
+	if (pos == len or not abnf_gen_test(urigen_class_33, buf[pos]))
+		goto L303;
+	if (pos == len or not abnf_gen_test(urigen_class_34, buf[pos]))
+		goto L301;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(303, pos, f, f_count,
+			res.size());
+	
+	L301:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 302, 65, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L223;
+	
+	L302:
+	goto L304;
+	
+	L303:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 304, 84, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L295;
+	
+	L304:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L305:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 306, 85, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L298;
+	
+	L306:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 307, 72, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L249;
+	
+	L307:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L308:
+	if (pos == len or not abnf_gen_test(urigen_class_35, buf[pos]))
+		goto L313;
+	if (pos == len or not abnf_gen_test(urigen_class_36, buf[pos]))
+		goto L311;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(313, pos, f, f_count,
+			res.size());
+	
+	L311:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 312, 79, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L275;
+	
+	L312:
+	goto L314;
+	
+	L313:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 314, 86, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L305;
+	
+	L314:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L315:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L318;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(316, pos, f, f_count,
+			res.size());
+		goto L318;
+	}
+	
+	L316:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 317, 87, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L308;
+	
+	L317:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L315;
+	
+	L318:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L319:
+	if (pos == len or (unsigned char) buf[pos] not_eq 35)
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L321:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 322, 89, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L319;
+	
+	L322:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 323, 69, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L241;
+	
+	L323:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L324:
+	if (f_vect[f].count >= 0)
+	{
+		if (f_vect[f].count >= 1)
+			goto L327;
+		if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(325, pos, f, f_count,
+			res.size());
+		goto L327;
+	}
+	
+	L325:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 326, 90, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L321;
+	
+	L326:
+	{
+		abnf_gen_frame fr = f_vect[f];
+		if (pos == fr.iter and fr.count >= 0)
+			goto fail;
+		++fr.count;
+		fr.iter = pos;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			f_vect[f] = fr;
+		else if (f_count == ABNF_GEN_STACK_MAX)
+			return -1;
+		else
+		{
+			f_vect[f_count] = fr;
+			f = f_count++;
+		}
+	}
+	goto L324;
+	
+	L327:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L328:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 329, 88, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L315;
+	
+	L329:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 330, 91, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L324;
+	
+	L330:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L331:
+	if (pos == len or not abnf_gen_test(urigen_fn_3, buf[pos]))
+		goto fail;
+	++pos;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L333:
+	if (pos < len)
+		goto fail;
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L335:
+	if (pos == len or not abnf_gen_test(urigen_class_37, buf[pos]))
+		goto L339;
+	if (ch_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	ch_vect[ch_count++] = abnf_gen_choice(339, pos, f, f_count,
+			res.size());
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 338, 93, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L331;
+	
+	L338:
+	goto L340;
+	
+	L339:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 340, 94, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L333;
+	
+	L340:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+	
+	L341:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 342, 92, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L328;
+	
+	L342:
+	if (f_count == ABNF_GEN_STACK_MAX)
+		return -1;
+	f_vect[f_count] = abnf_gen_frame(f, 343, 95, pos, 0, pos, ch_count);
+	f = f_count++;
+	goto L335;
+	
+	L343:
+	{
+		const abnf_gen_frame& fr = f_vect[f];
+		if (pos > fr.beg and not urigen_capture(res, buf, fr.r, fr.beg, pos))
+			return -1;
+		if (fr.parent < 0)
+		{
+			res.finish(pos);
+			return 1;
+		}
+		pc = fr.ret;
+		int parent = fr.parent;
+		if ((size_t) f == f_count - 1 and (ch_count == 0 or
+				ch_vect[ch_count - 1].f_count <= (size_t) f))
+			--f_count;
+		f = parent;
+	}
+	goto dispatch;
+}
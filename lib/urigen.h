@@ -0,0 +1,42 @@
+/*
+ * Parser of the "uri-reference" rule, generated by abnf_ruleset::generate.
+ */
+
+#ifndef URIGEN_H
+#define URIGEN_H
+
+#include <cstddef>
+
+#include "abnfgen.h"
+
+namespace xspider {
+
+/*!
+ * \brief Named rules matched by urigen_read.
+ */
+enum urigen_rule
+{
+	URIGEN_ABS_PATH = 0,
+	URIGEN_ABSOLUTEURI = 1,
+	URIGEN_FRAGMENT = 2,
+	URIGEN_HOST = 3,
+	URIGEN_PORT = 4,
+	URIGEN_QUERY = 5,
+	URIGEN_REL_PATH = 6,
+	URIGEN_SCHEME = 7,
+	URIGEN_URI_REFERENCE = 8,
+	URIGEN_USERINFO = 9
+};
+
+/*!
+ * \brief Matches the "uri-reference" rule against the len characters of buf.
+ *
+ * \return
+ *			1 if it matches, 0 if it does not, or -1 if it exceeds the
+ *			limits of generated parsers.
+ */
+int urigen_read(const char* buf, size_t len, abnf_gen_result& res);
+
+} // namespace xspider
+
+#endif // URIGEN_H
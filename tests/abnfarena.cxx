@@ -0,0 +1,82 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include "abnfm.h"
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Memory of released matchers must be reused by the next ones of their size,
+ * so that backtracking does not grow the arena.
+ */
+
+/*
+ * Address of a new block of the given size after releasing the given one.
+ */
+static string reused(abnf_arena& arena, size_t size, size_t new_size)
+{
+	void* p = arena.owned_alloc(size);
+	abnf_arena::owned_free(p, size);
+	void* q = arena.owned_alloc(new_size);
+	bool same = p == q;
+	abnf_arena::owned_free(q, new_size);
+	return same ? "reused" : "new";
+}
+
+int main(void)
+{
+	abnf_arena arena;
+	abnf_test_check("same size", "reused", reused(arena, 40, 40));
+	abnf_test_check("same aligned size", "reused", reused(arena, 33, 48));
+	abnf_test_check("bigger size", "new", reused(arena, 40, 200));
+	
+	// Released blocks are reused in any order, as long as sizes fit
+	void* p[100];
+	for (int i = 0; i < 100; ++i)
+		p[i] = arena.owned_alloc(24 + i % 3 * 100);
+	for (int i = 0; i < 100; ++i)
+		abnf_arena::owned_free(p[i], 24 + i % 3 * 100);
+	int new_n = 0;
+	for (int i = 0; i < 100; ++i)
+	{
+		void* q = arena.owned_alloc(24 + i % 3 * 100);
+		bool found = false;
+		for (int j = 0; j < 100 and not found; ++j)
+			found = q == p[j];
+		new_n += found ? 0 : 1;
+	}
+	ostringstream os;
+	os << new_n;
+	abnf_test_check("released blocks", "0", os.str());
+	
+	// A reset arena forgets its released blocks, which it bumps again
+	arena.reset();
+	void* q = arena.owned_alloc(40);
+	abnf_arena::owned_free(q, 40);
+	arena.reset();
+	void* r = arena.owned_alloc(40);
+	abnf_test_check("reset", "distinct",
+			r == arena.owned_alloc(40) ? "same" : "distinct");
+	
+	return abnf_test_status();
+}
@@ -0,0 +1,366 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "abnftest.h"
+#include "abnfd.h"
+#include "abnfj.h"
+#include "abnfp.h"
+#include "uri.h"
+#include "urigen.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Every engine running a rule must give the segments its matchers store:
+ * the interpreter, the automaton, the native code, the generated parser,
+ * parsers fed by chunks, results, actions and scans.
+ */
+
+static const char* const uri_names[] =
+{
+	"URI-reference",
+	"scheme",
+	"userinfo",
+	"host",
+	"port",
+	"abs_path",
+	"rel_path",
+	"query",
+	"fragment",
+	NULL
+};
+
+/*
+ * Named rules of the generated parser, in the order of uri_names.
+ */
+static const int uri_gen_names[] =
+{
+	URIGEN_URI_REFERENCE,
+	URIGEN_SCHEME,
+	URIGEN_USERINFO,
+	URIGEN_HOST,
+	URIGEN_PORT,
+	URIGEN_ABS_PATH,
+	URIGEN_REL_PATH,
+	URIGEN_QUERY,
+	URIGEN_FRAGMENT
+};
+
+/*
+ * Segments of rules, by their names.
+ */
+typedef map<string, vector<abnf_span> > segment_map;
+
+/*
+ * Matching length, or "-" if it does not match, followed by the segments of
+ * the rules of uri_names in seg_map, formatted as abnf_test_segments does.
+ */
+static string segments_str(bool matched, size_t len,
+		const segment_map& seg_map)
+{
+	ostringstream os;
+	if (matched)
+		os << len << ' ';
+	else
+		os << "- ";
+	for (int i = 0; uri_names[i] not_eq NULL; ++i)
+	{
+		segment_map::const_iterator it = seg_map.find(uri_names[i]);
+		size_t n = it == seg_map.end() ? 0 : it->second.size();
+		os << uri_names[i] << ':' << n;
+		for (size_t j = 0; j < n; ++j)
+			os << '<' << it->second[j].offset() << ','
+					<< it->second[j].length() << '>';
+		os << ' ';
+	}
+	return os.str();
+}
+
+/*
+ * Name of the given rule of uri_names in rset, or an empty string if it is
+ * not any of them.
+ */
+static string rule_name(const abnf_ruleset& rset, const abnf_rule& r)
+{
+	for (int i = 0; uri_names[i] not_eq NULL; ++i)
+		if (&rset.get(uri_names[i]) == &r)
+			return uri_names[i];
+	return "";
+}
+
+/*
+ * Reads s with the named rule of rset through matchers, once the segments of
+ * previous reads are cleared.
+ */
+static string tree_read(abnf_ruleset& rset, const char* name, const char* s)
+{
+	for (int i = 0; uri_names[i] not_eq NULL; ++i)
+		rset.get(uri_names[i]).clear();
+	size_t len = rset.get(name).read(s, strlen(s));
+	ostringstream os;
+	if (len == abnf_rule::npos)
+		os << "- ";
+	else
+		os << len << ' ';
+	os << abnf_test_segments(rset, uri_names);
+	return os.str();
+}
+
+/*
+ * Segments of the captures of s given by an engine running prog, as stored
+ * to a result.
+ */
+static string captures_str(const abnf_ruleset& rset, const abnf_program& prog,
+		const char* s, bool matched, size_t len,
+		const vector<abnf_capture>& caps)
+{
+	abnf_result res;
+	prog.segments_add(s, caps, 0, res);
+	ostringstream os;
+	if (matched)
+		os << len << ' ';
+	else
+		os << "- ";
+	os << abnf_test_segments(rset, uri_names, res);
+	return os.str();
+}
+
+/*
+ * Parser storing the segments it receives by rule name.
+ */
+class test_parser:
+public abnf_parser
+{
+	public:
+	
+	/*
+	 * Parser of the given rule of rset.
+	 */
+	test_parser(const abnf_ruleset& rset, const abnf_rule& r):
+	abnf_parser(r),
+	_rset(rset)
+	{
+	}
+	
+	segment_map seg_map;
+	
+	protected:
+	
+	/*
+	 * Stores the segment.
+	 */
+	void segment(const abnf_rule& r, const char* s, size_t beg, size_t end)
+	{
+		seg_map[rule_name(_rset, r)].push_back(abnf_span(NULL, beg,
+				end - beg));
+	}
+	
+	private:
+	
+	const abnf_ruleset& _rset;
+};
+
+/*
+ * Reads s with the given rule of rset through a parser fed by single
+ * characters. The segment of the read rule is given by its length.
+ */
+static string parser_read(const abnf_ruleset& rset, const char* name,
+		const char* s)
+{
+	test_parser p(rset, rset.get(name));
+	size_t len = strlen(s);
+	for (size_t i = 0; i < len; ++i)
+		p.feed(s + i, 1);
+	bool matched = p.finish();
+	if (matched and p.length() > 0)
+		p.seg_map[name].push_back(abnf_span(NULL, 0, p.length()));
+	return segments_str(matched, p.length(), p.seg_map);
+}
+
+/*
+ * Data of the actions of the action rule set.
+ */
+class test_action_data
+{
+	public:
+	
+	const abnf_ruleset* rset;
+	segment_map seg_map;
+};
+
+/*
+ * Action storing the segments of its rule by name.
+ */
+static void test_action(void* data, const abnf_rule& r, const abnf_span& s)
+{
+	test_action_data* d = static_cast<test_action_data*>(data);
+	d->seg_map[rule_name(*d->rset, r)].push_back(s);
+}
+
+/*
+ * Reads s with the named rule of rset, whose rules of uri_names call
+ * test_action.
+ */
+static string action_read(const abnf_ruleset& rset, const char* name,
+		const char* s)
+{
+	test_action_data data;
+	data.rset = &rset;
+	abnf_result res(&data);
+	size_t len = rset.get(name).read(s, strlen(s), res);
+	return segments_str(len not_eq abnf_rule::npos, len, data.seg_map);
+}
+
+/*
+ * Matches of the named rule of rset along text, as abnf_program::scan finds
+ * them, read through matchers.
+ */
+static string tree_scan(abnf_ruleset& rset, const char* name,
+		const string& text)
+{
+	abnf_rule& r = rset.get(name);
+	ostringstream os;
+	size_t n = 0;
+	for (size_t pos = 0; pos < text.size(); )
+	{
+		r.clear();
+		size_t len = r.read(text.data() + pos, text.size() - pos);
+		if (len == abnf_rule::npos or len == 0)
+		{
+			++pos;
+			continue;
+		}
+		os << '<' << pos << ',' << len << '>';
+		++n;
+		pos += len;
+	}
+	ostringstream count;
+	count << n << ' ' << os.str();
+	return count.str();
+}
+
+int main(void)
+{
+	const abnf_ruleset& rset = uri::ruleset();
+	
+	// Copies are read by matchers, or compiled with their own actions
+	abnf_ruleset tree_rset(rset);
+	abnf_ruleset act_rset(rset);
+	for (int i = 0; uri_names[i] not_eq NULL; ++i)
+		act_rset.action(act_rset.get(uri_names[i]), test_action);
+	act_rset.compile();
+	act_rset.jit();
+	
+	const abnf_program& prog = *abnf_rule_ri::cast(const_cast<abnf_rule&>(
+			rset.get(uri_names[0]))).program();
+	abnf_jit jit(prog);
+	
+	for (int i = 0; abnf_test_uri_corpus[i] not_eq NULL; ++i)
+	{
+		const char* s = abnf_test_uri_corpus[i];
+		size_t s_len = strlen(s);
+		for (int j = 0; uri_names[j] not_eq NULL; ++j)
+		{
+			const char* name = uri_names[j];
+			string what = string(name) + ": " + s;
+			string expected = tree_read(tree_rset, name, s);
+			
+			const abnf_rule& r = rset.get(name);
+			int id = abnf_rule_ri::cast(const_cast<abnf_rule&>(r))
+					.program_index();
+			
+			abnf_vm vm(id, prog.entry_pc(id));
+			int m = prog.exec(vm, s, 0, s_len, true);
+			abnf_test_check("interpreter, " + what, expected,
+					captures_str(rset, prog, s, m > 0, vm.end, vm.caps));
+			
+			// Automata and native code may give up
+			abnf_dfa dfa(prog, id);
+			size_t end = 0;
+			vector<abnf_capture> caps;
+			m = dfa.run(s, 0, s_len, end, caps);
+			if (m >= 0)
+				abnf_test_check("automaton, " + what, expected,
+						captures_str(rset, prog, s, m > 0, end, caps));
+			
+			end = 0;
+			caps.clear();
+			m = jit.run(id, s, s_len, end, caps);
+			if (m >= 0)
+				abnf_test_check("native code, " + what, expected,
+						captures_str(rset, prog, s, m > 0, end, caps));
+			
+			abnf_test_check("parser, " + what, expected,
+					parser_read(rset, name, s));
+			
+			abnf_result res;
+			size_t len = r.read(s, s_len, res);
+			ostringstream got;
+			if (len == abnf_rule::npos)
+				got << "- ";
+			else
+				got << len << ' ';
+			got << abnf_test_segments(rset, uri_names, res);
+			abnf_test_check("result, " + what, expected, got.str());
+			
+			abnf_test_check("actions, " + what, expected,
+					action_read(act_rset, name, s));
+		}
+		
+		// The generated parser reads the URI reference rule only, and may
+		// give up
+		abnf_gen_result gen_res;
+		int m = urigen_read(s, s_len, gen_res);
+		if (m >= 0)
+		{
+			segment_map seg_map;
+			for (int j = 0; uri_names[j] not_eq NULL; ++j)
+				for (size_t n = 0; n < gen_res.read_count(uri_gen_names[j]);
+						++n)
+					seg_map[uri_names[j]].push_back(
+							gen_res.span(uri_gen_names[j], n));
+			abnf_test_check(string("generated parser: ") + s,
+					tree_read(tree_rset, uri_names[0], s),
+					segments_str(m > 0, gen_res.length(), seg_map));
+		}
+	}
+	
+	// Scans for absolute URIs along the corpus
+	string text;
+	for (int i = 0; abnf_test_uri_corpus[i] not_eq NULL; ++i)
+		text += string(abnf_test_uri_corpus[i]) + " see ";
+	const abnf_rule& r_abs = rset.get("absoluteURI");
+	abnf_result res;
+	ostringstream got;
+	got << r_abs.scan(text.data(), text.size(), res) << ' ';
+	for (size_t n = 0; n < res.read_count(r_abs); ++n)
+		got << '<' << res.span(r_abs, n).offset() << ','
+				<< res.span(r_abs, n).length() << '>';
+	abnf_test_check("scan of absolute URIs",
+			tree_scan(tree_rset, "absoluteURI", text), got.str());
+	
+	return abnf_test_status();
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+
+#include <cstring>
+
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Alternatives of rules beginning with identical single character rules,
+ * built apart, match them once for both, unless their segments differ.
+ */
+
+static const char* const prefix_names[] =
+{
+	"second_a",
+	"x",
+	"y",
+	NULL
+};
+
+static int a_calls = 0;
+
+/*
+ * Terminal function of the prefix, counting its calls.
+ */
+static int a_test(int c)
+{
+	++a_calls;
+	return c == 'a';
+}
+
+/*
+ * Rule set whose "alt" rule is an alternative of two concatenations beginning
+ * with identical rules built apart, the second of them defined if def.
+ */
+static void prefix_ruleset(abnf_ruleset& rset, bool def)
+{
+	abnf_rule& r_first_a = rset.terminal(a_test);
+	abnf_rule& r_second_a = rset.terminal(a_test);
+	abnf_rule& r_x = rset.terminal('x');
+	abnf_rule& r_y = rset.terminal('y');
+	rset.define("alt", rset.alternat(rset.concat(r_first_a, r_x),
+			rset.concat(r_second_a, r_y)));
+	rset.define("x", r_x);
+	rset.define("y", r_y);
+	if (def)
+		rset.define("second_a", r_second_a);
+}
+
+/*
+ * Segments stored to the rules of rset by reading s with its "alt" rule,
+ * through matchers or, if compiled, to a result.
+ */
+static string segments_read(abnf_ruleset& rset, const char* s, bool compiled)
+{
+	ostringstream os;
+	abnf_rule& r = rset.get("alt");
+	if (compiled)
+	{
+		abnf_result res;
+		os << r.read(s, strlen(s), res) << ' '
+				<< abnf_test_segments(rset, prefix_names, res);
+	}
+	else
+	{
+		r.clear();
+		os << r.read(s, strlen(s)) << ' '
+				<< abnf_test_segments(rset, prefix_names);
+	}
+	return os.str();
+}
+
+int main(void)
+{
+	abnf_ruleset rset;
+	prefix_ruleset(rset, false);
+	rset.optimize();
+	a_calls = 0;
+	rset.get("alt").read("ay", 2);
+	ostringstream os;
+	os << a_calls;
+	abnf_test_check("prefix matched once", "1", os.str());
+	
+	for (int def = 0; def < 2; ++def)
+	{
+		abnf_ruleset d_rset;
+		prefix_ruleset(d_rset, def);
+		d_rset.optimize();
+		abnf_ruleset d_prog_rset;
+		prefix_ruleset(d_prog_rset, def);
+		d_prog_rset.optimize();
+		d_prog_rset.compile();
+		
+		for (int compiled = 0; compiled < 2; ++compiled)
+		{
+			string how = string(compiled ? "compiled " : "")
+					+ (def ? "defined " : "");
+			abnf_ruleset& p_rset = compiled ? d_prog_rset : d_rset;
+			abnf_test_check(how + "left", "2 second_a:0 x:1<1,1> y:0 ",
+					segments_read(p_rset, "ax", compiled));
+			abnf_test_check(how + "right", def ?
+					"2 second_a:1<0,1> x:0 y:1<1,1> " :
+					"2 second_a:0 x:0 y:1<1,1> ",
+					segments_read(p_rset, "ay", compiled));
+		}
+	}
+	
+	return abnf_test_status();
+}
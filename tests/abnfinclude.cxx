@@ -0,0 +1,112 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+
+#include <stdexcept>
+
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Rule sets including another one share its rules, so they must not change
+ * how those rules store their segments.
+ */
+
+static const char* const digits_names[] =
+{
+	"digits",
+	NULL
+};
+
+/*
+ * Action doing nothing.
+ */
+static void digits_action(void* data, const abnf_rule& r, const abnf_span& s)
+{
+}
+
+/*
+ * Whether changing the rule r of rset, given by n, throws
+ * std::invalid_argument.
+ */
+static string change_test(abnf_ruleset& rset, abnf_rule& r, int n)
+{
+	try
+	{
+		switch (n)
+		{
+			case 0:
+				rset.define("other", r);
+				break;
+			case 1:
+				rset.capture(r, false);
+				break;
+			case 2:
+				rset.action(r, digits_action);
+				break;
+			default:
+				rset.memoize(r);
+		}
+	}
+	catch (invalid_argument&)
+	{
+		return "thrown";
+	}
+	return "not thrown";
+}
+
+int main(void)
+{
+	abnf_ruleset a_rset;
+	a_rset.include(abnf_ruleset::core_ruleset());
+	a_rset.define("digits", a_rset.repet(1, a_rset.get("digit"),
+			ABNF_REPET_GREEDY));
+	
+	abnf_ruleset b_rset;
+	b_rset.include(a_rset);
+	b_rset.define("number", b_rset.concat(b_rset.get("digits"),
+			b_rset.terminal('.')));
+	
+	const char* what[] = {"define", "capture", "action", "memoize"};
+	for (int n = 0; n < 4; ++n)
+	{
+		abnf_test_check(string(what[n]) + " of an included rule", "thrown",
+				change_test(b_rset, b_rset.get("digits"), n));
+		abnf_test_check(string(what[n]) + " of a core rule", "thrown",
+				change_test(b_rset, b_rset.get("alpha"), n));
+	}
+	
+	abnf_rule& r = a_rset.get("digits");
+	r.clear();
+	r.read("123", 3);
+	abnf_test_check("included rule", "digits:1<0,3> ",
+			abnf_test_segments(a_rset, digits_names));
+	
+	abnf_rule& number = b_rset.get("number");
+	number.clear();
+	ostringstream os;
+	os << number.read("12.", 3);
+	abnf_test_check("including rule", "3", os.str());
+	
+	return abnf_test_status();
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <cstring>
+
+#include "abnftest.h"
+#include "uri.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Memoized rules must store the same segments as unmemoized ones, whether
+ * their results are taken from the memo or not.
+ */
+
+static const char* const list_names[] =
+{
+	"s",
+	"list",
+	"item",
+	NULL
+};
+
+static const char* const uri_names[] =
+{
+	"URI-reference",
+	"absoluteURI",
+	"scheme",
+	"userinfo",
+	"host",
+	"port",
+	"abs_path",
+	"rel_path",
+	"query",
+	"fragment",
+	NULL
+};
+
+/*
+ * Rule set whose "list" rule is matched again by every alternative of "s",
+ * memoized with the given limit or not memoized if it is zero.
+ */
+static void list_ruleset(abnf_ruleset& rset, size_t mem_max)
+{
+	abnf_rule& r_item = rset.define("item",
+			rset.alternat(rset.terminal("aa"), rset.terminal("a")));
+	abnf_rule& r_list = rset.define("list", rset.repet(1, r_item));
+	if (mem_max > 0)
+		rset.memoize(r_list, mem_max);
+	rset.define("s",
+			rset.alternat(rset.concat(r_list, rset.terminal('b')),
+			rset.alternat(rset.concat(r_list, rset.terminal('c')),
+			rset.concat(r_list, rset.terminal('d')))));
+}
+
+/*
+ * Segments stored by reading s with the "s" rule of rset.
+ */
+static string list_read(abnf_ruleset& rset, const char* s)
+{
+	ostringstream os;
+	os << rset.get("s").read(s, strlen(s)) << ' '
+			<< abnf_test_segments(rset, list_names);
+	return os.str();
+}
+
+int main(void)
+{
+	static const char* const list_corpus[] =
+	{
+		"ab",
+		"aaac",
+		"aaaad",
+		"aaaaaaaaaaaad",
+		"aaae",
+		"d",
+		"",
+		NULL
+	};
+	
+	abnf_ruleset list_rset;
+	list_ruleset(list_rset, 0);
+	abnf_ruleset list_memo_rset;
+	list_ruleset(list_memo_rset, 1048576);
+	abnf_ruleset list_full_rset;
+	list_ruleset(list_full_rset, 1);
+	for (int i = 0; list_corpus[i] not_eq NULL; ++i)
+	{
+		string expected = list_read(list_rset, list_corpus[i]);
+		abnf_test_check(string("memoized list: ") + list_corpus[i],
+				expected, list_read(list_memo_rset, list_corpus[i]));
+		abnf_test_check(string("memoized list over limit: ") +
+				list_corpus[i], expected,
+				list_read(list_full_rset, list_corpus[i]));
+	}
+	
+	// Copies of the uri rule set are read by matchers, not by its program
+	abnf_ruleset uri_rset(uri::ruleset());
+	abnf_ruleset uri_memo_rset(uri::ruleset());
+	uri_memo_rset.memoize(uri_memo_rset.get("abs_path"));
+	uri_memo_rset.memoize(uri_memo_rset.get("rel_path"));
+	uri_memo_rset.memoize(uri_memo_rset.get("host"), 64);
+	for (int i = 0; abnf_test_uri_corpus[i] not_eq NULL; ++i)
+	{
+		const char* s = abnf_test_uri_corpus[i];
+		ostringstream expected, got;
+		expected << uri_rset.get("URI-reference").read(s, strlen(s)) << ' '
+				<< abnf_test_segments(uri_rset, uri_names);
+		got << uri_memo_rset.get("URI-reference").read(s, strlen(s)) << ' '
+				<< abnf_test_segments(uri_memo_rset, uri_names);
+		abnf_test_check(string("memoized uri: ") + s, expected.str(),
+				got.str());
+	}
+	
+	return abnf_test_status();
+}
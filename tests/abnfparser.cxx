@@ -0,0 +1,112 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <cstring>
+
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Parsers fed by chunks must report the segments stored by reading the whole
+ * input at once.
+ */
+
+/*
+ * Parser writing the segments it receives.
+ */
+class test_parser:
+public abnf_parser
+{
+	public:
+	
+	/*
+	 * Parser of the given rule of rset.
+	 */
+	test_parser(const abnf_ruleset& rset, const char* r):
+	abnf_parser(rset.get(r)),
+	_rset(rset)
+	{
+	}
+	
+	/*
+	 * Segments received so far.
+	 */
+	string str(void) const
+	{
+		return _os.str();
+	}
+	
+	protected:
+	
+	/*
+	 * Writes the segment.
+	 */
+	void segment(const abnf_rule& r, const char* s, size_t beg, size_t end)
+	{
+		_os << (&r == &_rset.get("a") ? "a" : "?") << '<' << beg << ','
+				<< end - beg << '>';
+	}
+	
+	private:
+	
+	const abnf_ruleset& _rset;
+	ostringstream _os;
+};
+
+/*
+ * Matching length and segments given by feeding s to a parser of the "s"
+ * rule of rset, in chunks of n characters.
+ */
+static string parser_read(const abnf_ruleset& rset, const char* s, size_t n)
+{
+	test_parser p(rset, "s");
+	size_t len = strlen(s);
+	for (size_t i = 0; i < len; i += n)
+		p.feed(s + i, min(n, len - i));
+	ostringstream os;
+	os << p.finish() << ' ' << p.length() << ' ' << p.str();
+	return os.str();
+}
+
+int main(void)
+{
+	// Alternatives of terminal strings are matched through a trie, whose
+	// instructions store the segments of its children
+	abnf_ruleset rset;
+	rset.define("s", rset.alternat(rset.define("a", rset.terminal("aa")),
+			rset.terminal("ab")));
+	rset.optimize();
+	rset.compile();
+	
+	for (size_t n = 1; n <= 2; ++n)
+	{
+		ostringstream how;
+		how << "trie parser by " << n << ": ";
+		abnf_test_check(how.str() + "aa", "1 2 a<0,2>",
+				parser_read(rset, "aa", n));
+		abnf_test_check(how.str() + "ab", "1 2 ", parser_read(rset, "ab", n));
+		abnf_test_check(how.str() + "b", "0 0 ", parser_read(rset, "b", n));
+	}
+	
+	return abnf_test_status();
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Buffer reads must tell a rule which does not match from one matching an
+ * empty segment, whether the rule is compiled or not.
+ */
+
+/*
+ * Lengths given by reading each of "", "b" and "ab" with the "a" rule of
+ * rset, to its rule tree and, if compiled, to a result.
+ */
+static string lengths(abnf_ruleset& rset, bool compiled)
+{
+	static const char* const inputs[] =
+	{
+		"",
+		"b",
+		"ab",
+		NULL
+	};
+	
+	ostringstream os;
+	abnf_rule& r = rset.get("a");
+	for (int i = 0; inputs[i] not_eq NULL; ++i)
+	{
+		size_t len = string(inputs[i]).size();
+		size_t end = r.read(inputs[i], len);
+		os << (end == abnf_rule::npos ? "-" : "") << (end + 1) << ' ';
+		if (compiled)
+		{
+			abnf_result res;
+			end = r.read(inputs[i], len, res);
+			os << (end == abnf_rule::npos ? "-" : "") << (end + 1) << '/'
+					<< res.length() << ' ';
+		}
+	}
+	return os.str();
+}
+
+int main(void)
+{
+	abnf_ruleset rset;
+	rset.define("a", rset.terminal('a'));
+	abnf_ruleset null_rset;
+	null_rset.define("a", null_rset.repet(0, 1, null_rset.terminal('a'),
+			ABNF_REPET_GREEDY));
+	
+	// Lengths are shown plus one, so that npos is shown as -0
+	abnf_test_check("rule", "-0 -0 2 ", lengths(rset, false));
+	abnf_test_check("nullable rule", "1 1 2 ", lengths(null_rset, false));
+	rset.compile();
+	null_rset.compile();
+	abnf_test_check("compiled rule", "-0 -0/0 -0 -0/0 2 2/1 ",
+			lengths(rset, true));
+	abnf_test_check("compiled nullable rule", "1 1/0 1 1/0 2 2/1 ",
+			lengths(null_rset, true));
+	
+	return abnf_test_status();
+}
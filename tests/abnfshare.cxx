@@ -0,0 +1,301 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <cstring>
+
+#include "abnfr.h"
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Identical rules share their structure, but each one stores its own
+ * segments, whenever it is defined.
+ */
+
+static const char* const uri_names[] =
+{
+	"scheme",
+	"host",
+	"abs_path",
+	"query",
+	"fragment",
+	NULL
+};
+
+static const char* const pair_names[] =
+{
+	"first",
+	"second",
+	NULL
+};
+
+static const char* const split_names[] =
+{
+	"y",
+	NULL
+};
+
+/*
+ * URI rule set as it was first written, defining its rules once all of them
+ * are created. Query and fragment are identical rules.
+ */
+static void uri_ruleset(abnf_ruleset& rset)
+{
+	rset.include(abnf_ruleset::core_ruleset());
+	abnf_rule& r_alphanum = rset.terminal(isalnum);
+	abnf_rule& r_hex = rset.terminal(isxdigit);
+	abnf_rule& r_hexhex = rset.concat(r_hex, r_hex);
+	abnf_rule& r_percent = rset.terminal('%');
+	abnf_rule& r_escaped = rset.concat(r_percent, r_hexhex);
+	abnf_rule& r_mark = rset.alternat("-_.!~*'()");
+	abnf_rule& r_unreserved = rset.alternat(r_alphanum, r_mark);
+	abnf_rule& r_reserved = rset.alternat(";/?:@&=+$,");
+	abnf_rule& r_res_unres = rset.alternat(r_reserved, r_unreserved);
+	abnf_rule& r_uric = rset.alternat(r_res_unres, r_escaped);
+	abnf_rule& r_fragment = rset.repet(0, r_uric);
+	abnf_rule& r_query = rset.repet(0, r_uric);
+	abnf_rule& r_pcharch = rset.alternat(":@&=+$,");
+	abnf_rule& r_unres_esc = rset.alternat(r_unreserved, r_escaped);
+	abnf_rule& r_pchar = rset.alternat(r_unres_esc, r_pcharch);
+	abnf_rule& r_param = rset.repet(0, r_pchar);
+	abnf_rule& r_semic = rset.terminal(';');
+	abnf_rule& r_semicparam = rset.concat(r_semic, r_param);
+	abnf_rule& r_rsemicparam = rset.repet(0, r_semicparam);
+	abnf_rule& r_rpchar = rset.repet(0, r_pchar);
+	abnf_rule& r_segment = rset.concat(r_rpchar, r_rsemicparam);
+	abnf_rule& r_sl = rset.terminal('/');
+	abnf_rule& r_slseg = rset.concat(r_sl, r_segment);
+	abnf_rule& r_rslseg = rset.repet(0, r_slseg);
+	abnf_rule& r_path_seg = rset.concat(r_segment, r_rslseg);
+	abnf_rule& r_abs_path = rset.concat(r_sl, r_path_seg);
+	abnf_rule& r_uric_no_slch = rset.alternat(";?:@&=+$,");
+	abnf_rule& r_uric_no_sl = rset.alternat(r_unres_esc, r_uric_no_slch);
+	abnf_rule& r_ruric = rset.repet(0, r_uric);
+	abnf_rule& r_opaq_part = rset.concat(r_uric_no_sl, r_ruric);
+	abnf_rule& r_digit = rset.get("digit");
+	abnf_rule& r_port = rset.repet(0, r_digit);
+	abnf_rule& r_rdigit = rset.repet(1, r_digit);
+	abnf_rule& r_dot = rset.terminal('.');
+	abnf_rule& r_ipv4address1 = rset.concat(r_rdigit, r_dot);
+	abnf_rule& r_ipv4address2 = rset.concat(r_ipv4address1, r_rdigit);
+	abnf_rule& r_ipv4address3 = rset.concat(r_ipv4address2, r_dot);
+	abnf_rule& r_ipv4address4 = rset.concat(r_ipv4address3, r_rdigit);
+	abnf_rule& r_ipv4address5 = rset.concat(r_ipv4address4, r_dot);
+	abnf_rule& r_ipv4address = rset.concat(r_ipv4address5, r_rdigit);
+	abnf_rule& r_alpha = rset.get("alpha");
+	abnf_rule& r_min = rset.terminal('-');
+	abnf_rule& r_alphanum_min = rset.alternat(r_alphanum, r_min);
+	abnf_rule& r_ralphanum_min = rset.repet(0, r_alphanum_min);
+	abnf_rule& r_alraln_min = rset.concat(r_alpha, r_ralphanum_min);
+	abnf_rule& r_alraln_minaln = rset.concat(r_alraln_min, r_alphanum);
+	abnf_rule& r_toplabel = rset.alternat(r_alpha, r_alraln_minaln);
+	abnf_rule& r_alnraln_min = rset.concat(r_alphanum, r_ralphanum_min);
+	abnf_rule& r_alnraln_minaln = rset.concat(r_alnraln_min, r_alphanum);
+	abnf_rule& r_domainlabel = rset.alternat(r_alphanum, r_alnraln_minaln);
+	abnf_rule& r_domlabdot = rset.concat(r_domainlabel, r_dot);
+	abnf_rule& r_rdomlabdot = rset.repet(0, r_domlabdot);
+	abnf_rule& r_rdot = rset.repet(0, 1, r_dot);
+	abnf_rule& r_rdomlabdot_toplab = rset.concat(r_rdomlabdot, r_toplabel);
+	abnf_rule& r_hostname = rset.concat(r_rdomlabdot_toplab, r_rdot);
+	abnf_rule& r_host = rset.alternat(r_hostname, r_ipv4address);
+	abnf_rule& r_colon = rset.terminal(':');
+	abnf_rule& r_colonport = rset.concat(r_colon, r_port);
+	abnf_rule& r_rcolonport = rset.repet(0, 1, r_colonport);
+	abnf_rule& r_hostport = rset.concat(r_host, r_rcolonport);
+	abnf_rule& r_userinfoch = rset.alternat(";:&=+$,");
+	abnf_rule& r_unres_esc_userich = rset.alternat(r_unres_esc, r_userinfoch);
+	abnf_rule& r_userinfo = rset.repet(0, r_unres_esc_userich);
+	abnf_rule& r_arroba = rset.terminal('@');
+	abnf_rule& r_useriarr = rset.concat(r_userinfo, r_arroba);
+	abnf_rule& r_ruseriarr = rset.repet(0, 1, r_useriarr);
+	abnf_rule& r_ruseriarrhport = rset.concat(r_ruseriarr, r_hostport);
+	abnf_rule& r_server = rset.repet(0, 1, r_ruseriarrhport);
+	abnf_rule& r_regnch = rset.alternat("$,;:@&=+");
+	abnf_rule& r_unres_esc_regnch = rset.alternat(r_unres_esc, r_regnch);
+	abnf_rule& r_reg_name = rset.repet(1, r_unres_esc_regnch);
+	abnf_rule& r_authority = rset.alternat(r_server, r_reg_name);
+	abnf_rule& r_schemech = rset.alternat("+-.");
+	abnf_rule& r_alnum_schemech = rset.alternat(r_alphanum, r_schemech);
+	abnf_rule& r_ralnum_schemech = rset.repet(0, r_alnum_schemech);
+	abnf_rule& r_scheme = rset.concat(r_alpha, r_ralnum_schemech);
+	abnf_rule& r_relsegch = rset.alternat(";@&=+$,");
+	abnf_rule& r_unres_esc_relsegch = rset.alternat(r_unres_esc, r_relsegch);
+	abnf_rule& r_rel_seg = rset.repet(1, r_unres_esc_relsegch);
+	abnf_rule& r_rabs_path = rset.repet(0, 1, r_abs_path);
+	abnf_rule& r_rel_path = rset.concat(r_rel_seg, r_rabs_path);
+	abnf_rule& r_dslash = rset.terminal("//");
+	abnf_rule& r_dslashauth = rset.concat(r_dslash, r_authority);
+	abnf_rule& r_net_path = rset.concat(r_dslashauth, r_abs_path);
+	abnf_rule& r_qm = rset.terminal('?');
+	abnf_rule& r_qmquery = rset.concat(r_qm, r_query);
+	abnf_rule& r_rqmquery = rset.repet(0, 1, r_qmquery);
+	abnf_rule& r_npath_apath = rset.alternat(r_net_path, r_abs_path);
+	abnf_rule& r_hier_part = rset.concat(r_npath_apath, r_rqmquery);
+	abnf_rule& r_npth_apth_rpth = rset.alternat(r_npath_apath, r_rel_path);
+	abnf_rule& r_reluri = rset.concat(r_npth_apth_rpth, r_rqmquery);
+	abnf_rule& r_schemecol = rset.concat(r_scheme, r_colon);
+	abnf_rule& r_hier_opaq = rset.alternat(r_hier_part, r_opaq_part);
+	abnf_rule& r_absuri = rset.concat(r_schemecol, r_hier_opaq);
+	abnf_rule& r_abs_rel = rset.alternat(r_absuri, r_reluri);
+	abnf_rule& r_rabs_rel = rset.repet(0, 1, r_abs_rel);
+	abnf_rule& r_nsign = rset.terminal('#');
+	abnf_rule& r_nsignfrag = rset.concat(r_nsign, r_fragment);
+	abnf_rule& r_rnsignfrag = rset.repet(0, 1, r_nsignfrag);
+	abnf_rule& r_uri = rset.concat(r_rabs_rel, r_rnsignfrag);
+	abnf_rule& r_end = rset.alternat(rset.terminal(isspace), rset.eof());
+	abnf_rule& r_uriend = rset.concat(r_uri, r_end);
+	
+	rset.define("URI-reference", r_uriend);
+	rset.define("scheme", r_scheme);
+	rset.define("userinfo", r_userinfo);
+	rset.define("host", r_host);
+	rset.define("fragment", r_fragment);
+	rset.define("port", r_port);
+	rset.define("abs_path", r_abs_path);
+	rset.define("rel_path", r_rel_path);
+	rset.define("query", r_query);
+}
+
+/*
+ * Rule set of two identical rules read one after the other.
+ */
+static void pair_ruleset(abnf_ruleset& rset)
+{
+	abnf_rule& r_first = rset.terminal('x');
+	abnf_rule& r_second = rset.terminal('x');
+	rset.define("pair", rset.concat(r_first, r_second));
+	rset.define("first", r_first);
+	rset.define("second", r_second);
+}
+
+/*
+ * Rule set of two identical concatenations, whose second children are
+ * identical but only the second one is defined, once both are created.
+ */
+static void split_ruleset(abnf_ruleset& rset)
+{
+	abnf_rule& r_first = rset.concat(rset.terminal('x'), rset.terminal('y'));
+	abnf_rule& r_y = rset.terminal('y');
+	abnf_rule& r_second = rset.concat(rset.terminal('x'), r_y);
+	rset.define("pair", rset.concat(r_first, r_second));
+	rset.define("y", r_y);
+}
+
+/*
+ * Whether the given rules share their structure.
+ */
+static bool shared(abnf_rule& rl, abnf_rule& rr)
+{
+	return &abnf_rule_ri::cast(rl).body() == &abnf_rule_ri::cast(rr).body();
+}
+
+/*
+ * Segments stored to the rules of rset by reading s with its rule r, through
+ * matchers or, if compiled, to a result.
+ */
+static string segments_read(abnf_ruleset& rset, const char* r, const char* s,
+		const char* const names[], bool compiled)
+{
+	ostringstream os;
+	abnf_rule& rule = rset.get(r);
+	if (compiled)
+	{
+		abnf_result res;
+		os << rule.read(s, strlen(s), res) << ' '
+				<< abnf_test_segments(rset, names, res);
+	}
+	else
+	{
+		rule.clear();
+		os << rule.read(s, strlen(s)) << ' '
+				<< abnf_test_segments(rset, names);
+	}
+	return os.str();
+}
+
+int main(void)
+{
+	abnf_ruleset rset;
+	abnf_test_check("concatenations share", "1",
+			shared(rset.concat(rset.terminal('a'), rset.terminal('b')),
+			rset.concat(rset.terminal('a'), rset.terminal('b'))) ? "1" : "0");
+	abnf_test_check("repetitions of alternatives share", "1",
+			shared(rset.repet(0, rset.alternat(rset.terminal('a'),
+			rset.terminal("bc"))), rset.repet(0, rset.alternat(
+			rset.terminal('a'), rset.terminal("bc")))) ? "1" : "0");
+	abnf_test_check("different concatenations do not share", "0",
+			shared(rset.concat(rset.terminal('a'), rset.terminal('b')),
+			rset.concat(rset.terminal('b'), rset.terminal('a'))) ? "1" : "0");
+	
+	rset.define("ab", rset.concat(rset.terminal('a'), rset.terminal('b')));
+	abnf_ruleset copy_rset(rset);
+	abnf_test_check("copied concatenations share", "1",
+			shared(copy_rset.get("ab"), copy_rset.concat(
+			copy_rset.terminal('a'), copy_rset.terminal('b'))) ? "1" : "0");
+	
+
+	abnf_ruleset uri_rset;
+	uri_ruleset(uri_rset);
+	abnf_ruleset uri_prog_rset;
+	uri_ruleset(uri_prog_rset);
+	uri_prog_rset.optimize();
+	uri_prog_rset.compile();
+	
+	abnf_ruleset pair_rset;
+	pair_ruleset(pair_rset);
+	abnf_ruleset pair_prog_rset;
+	pair_ruleset(pair_prog_rset);
+	pair_prog_rset.compile();
+	
+	abnf_ruleset split_rset;
+	split_ruleset(split_rset);
+	abnf_ruleset split_prog_rset;
+	split_ruleset(split_prog_rset);
+	split_prog_rset.optimize();
+	split_prog_rset.compile();
+	
+	for (int compiled = 0; compiled < 2; ++compiled)
+	{
+		string how = compiled ? "compiled " : "";
+		abnf_ruleset& u_rset = compiled ? uri_prog_rset : uri_rset;
+		abnf_test_check(how + "uri without query nor fragment",
+				"27 scheme:1<0,6> host:0 abs_path:0 query:0 fragment:0 ",
+				segments_read(u_rset, "URI-reference",
+				"mailto:John.Doe@example.com", uri_names, compiled));
+		abnf_test_check(how + "uri with query and fragment",
+				"14 scheme:1<0,4> host:1<7,1> abs_path:1<8,2> query:1<11,1> "
+				"fragment:1<13,1> ",
+				segments_read(u_rset, "URI-reference", "http://a/b?q#f",
+				uri_names, compiled));
+		
+		abnf_ruleset& p_rset = compiled ? pair_prog_rset : pair_rset;
+		abnf_test_check(how + "pair", "2 first:1<0,1> second:1<1,1> ",
+				segments_read(p_rset, "pair", "xx", pair_names, compiled));
+		
+		abnf_ruleset& s_rset = compiled ? split_prog_rset : split_rset;
+		abnf_test_check(how + "split", "4 y:1<3,1> ",
+				segments_read(s_rset, "pair", "xyxy", split_names, compiled));
+	}
+	
+	return abnf_test_status();
+}
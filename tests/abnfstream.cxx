@@ -0,0 +1,185 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <cstring>
+#include <sstream>
+
+#include "abnftest.h"
+#include "uri.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Stream reads of compiled rules must store the same segments as buffer
+ * reads, reading no more of the stream than the result depends on.
+ */
+
+static const char* const uri_names[] =
+{
+	"URI-reference",
+	"absoluteURI",
+	"scheme",
+	"userinfo",
+	"host",
+	"port",
+	"abs_path",
+	"rel_path",
+	"query",
+	"fragment",
+	NULL
+};
+
+/*
+ * Endless stream of a single character, which is seekable.
+ */
+class endless_buf:
+public streambuf
+{
+	public:
+	
+	endless_buf(char c):
+	_off(0)
+	{
+		memset(_buf, c, sizeof (_buf));
+		setg(_buf, _buf, _buf + sizeof (_buf));
+	}
+	
+	protected:
+	
+	int_type underflow(void)
+	{
+		_off += egptr() - eback();
+		setg(_buf, _buf, _buf + sizeof (_buf));
+		return traits_type::to_int_type(*gptr());
+	}
+	
+	pos_type seekoff(off_type off, ios_base::seekdir dir,
+			ios_base::openmode which)
+	{
+		if (dir not_eq ios_base::cur)
+			return pos_type(off_type(-1));
+		return seekpos(_off + (gptr() - eback()) + off, which);
+	}
+	
+	pos_type seekpos(pos_type pos, ios_base::openmode which)
+	{
+		_off = pos;
+		setg(_buf, _buf, _buf + sizeof (_buf));
+		return pos;
+	}
+	
+	private:
+	
+	char _buf[256];
+	streamoff _off;
+};
+
+int main(void)
+{
+	abnf_ruleset rset(uri::ruleset());
+	rset.compile();
+	abnf_rule& r_uri = rset.get("URI-reference");
+	for (int i = 0; abnf_test_uri_corpus[i] not_eq NULL; ++i)
+	{
+		// The stream goes on after the ending space of the URI
+		string s = string(abnf_test_uri_corpus[i]) + " trailing";
+		ostringstream expected, expected_res;
+		r_uri.clear();
+		size_t end = r_uri.read(s.data(), s.size());
+		expected << (end == abnf_rule::npos ? 0 : end) << ' '
+				<< abnf_test_segments(rset, uri_names);
+		abnf_result buf_res;
+		r_uri.read(s.data(), s.size(), buf_res);
+		expected_res << buf_res.length() << ' '
+				<< abnf_test_segments(rset, uri_names, buf_res);
+		
+		ostringstream got, got_res;
+		istringstream is(s);
+		r_uri.clear();
+		r_uri.read(is);
+		got << is.tellg() << ' ' << abnf_test_segments(rset, uri_names);
+		abnf_test_check("stream read: " + s, expected.str(),
+				got.str());
+		
+		abnf_result res;
+		istringstream res_is(s);
+		r_uri.read(res_is, res);
+		got_res << res_is.tellg() << ' '
+				<< abnf_test_segments(rset, uri_names, res);
+		abnf_test_check("stream read to result: " + s,
+				expected_res.str(), got_res.str());
+		abnf_test_check("stream read result text: " + s,
+				buf_res.span(r_uri, 0).str(), res.span(r_uri, 0).str());
+	}
+	
+	// Matchers span character runs over buffers, but take them one by one
+	// from streams
+	abnf_ruleset m_rset(uri::ruleset());
+	abnf_rule& r_m_uri = m_rset.get("URI-reference");
+	for (int i = 0; abnf_test_uri_corpus[i] not_eq NULL; ++i)
+	{
+		string s = string(abnf_test_uri_corpus[i]) + " trailing";
+		ostringstream expected, got;
+		r_m_uri.clear();
+		size_t end = r_m_uri.read(s.data(), s.size());
+		expected << (end == abnf_rule::npos ? 0 : end) << ' '
+				<< abnf_test_segments(m_rset, uri_names);
+		
+		istringstream is(s);
+		r_m_uri.clear();
+		r_m_uri.read(is);
+		got << is.tellg() << ' ' << abnf_test_segments(m_rset, uri_names);
+		abnf_test_check("matcher stream read: " + s, expected.str(),
+				got.str());
+	}
+	
+	// Endless streams are read as far as needed only
+	abnf_ruleset e_rset;
+	abnf_rule& r_three = e_rset.define("three", e_rset.terminal("aaa"));
+	abnf_rule& r_ab = e_rset.define("ab", e_rset.terminal("ab"));
+	abnf_rule& r_rep = e_rset.define("rep",
+			e_rset.concat(e_rset.repet(0, 5, e_rset.terminal('a')),
+			e_rset.terminal('b')));
+	e_rset.compile();
+	
+	endless_buf e_buf('a');
+	istream e_is(&e_buf);
+	r_three.read(e_is);
+	ostringstream e_got;
+	e_got << e_is.tellg() << ' ' << r_three.read_count();
+	abnf_test_check("endless stream match", "3 1", e_got.str());
+	
+	e_is.seekg(0);
+	r_ab.read(e_is);
+	ostringstream ab_got;
+	ab_got << e_is.tellg() << ' ' << r_ab.read_count();
+	abnf_test_check("endless stream mismatch", "0 0", ab_got.str());
+	
+	e_is.seekg(0);
+	abnf_result e_res;
+	r_rep.read(e_is, e_res);
+	ostringstream rep_got;
+	rep_got << e_is.tellg() << ' ' << e_res.length();
+	abnf_test_check("endless stream backtracking", "0 0", rep_got.str());
+	
+	return abnf_test_status();
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+
+#include <climits>
+#include <cstring>
+
+#include <abnftpl.h>
+
+#include "abnftest.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * Grammars matched by inlined code must give the same matching lengths as the
+ * rules they define, whether they match or not.
+ */
+
+static const char* const inputs[] =
+{
+	"",
+	"1",
+	"11",
+	"123",
+	"x",
+	"ab",
+	"aba",
+	"abab",
+	"ababa",
+	"ababab",
+	NULL
+};
+
+/*
+ * Checks the matching lengths of grammar G against those of its rule, on
+ * every input.
+ */
+template<typename G>
+static void grammar_check(const string& what)
+{
+	abnf_ruleset rset;
+	abnf_rule& r = abnf_define<G>(rset, "g");
+	for (int i = 0; inputs[i] not_eq NULL; ++i)
+	{
+		size_t len = strlen(inputs[i]);
+		ostringstream expected, got;
+		expected << r.read(inputs[i], len);
+		got << abnf_read<G>(inputs[i], len);
+		abnf_test_check(what + " \"" + inputs[i] + '"', expected.str(),
+				got.str());
+	}
+}
+
+/*
+ * Checks grammars with repetitions of the given mode.
+ */
+template<abnf_repet_mode MODE>
+static void mode_check(const string& mode)
+{
+	typedef abnf_alternat_range<'0', '9'> digit;
+	typedef abnf_concat<abnf_terminal<'a'>, abnf_terminal<'b'> > ab;
+	
+	grammar_check<abnf_repet<1, INT_MAX, digit, MODE> >(mode + " digits");
+	grammar_check<abnf_concat<abnf_repet<0, INT_MAX, digit, MODE>,
+			abnf_terminal<'1'> > >(mode + " digits then 1");
+	grammar_check<abnf_repet<0, 2, ab, MODE> >(mode + " ab");
+	grammar_check<abnf_concat<abnf_repet<1, INT_MAX, ab, MODE>,
+			abnf_alternat<abnf_terminal<'a'>, abnf_eof> > >(mode
+			+ " ab then a or end");
+}
+
+int main(void)
+{
+	mode_check<ABNF_REPET_LAZY>("lazy");
+	mode_check<ABNF_REPET_GREEDY>("greedy");
+	mode_check<ABNF_REPET_POSSESSIVE>("possessive");
+	
+	return abnf_test_status();
+}
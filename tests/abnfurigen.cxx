@@ -0,0 +1,59 @@
+/*
+ * This file is part of the XSpider project.
+ *
+ * Copyright (C) 2012-2013 Miquel Ferran <miquel.ferran.gonzalez@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+
+#include <fstream>
+
+#include "abnftest.h"
+#include "uri.h"
+
+using namespace std;
+using namespace xspider;
+
+/*
+ * The URI parser kept with the library sources must be the one bin/abnfgen
+ * generates from the current URI rule set.
+ */
+
+/*
+ * Contents of the given source file.
+ */
+static string source_read(const char* name)
+{
+	ifstream is((string(ABNF_TEST_SRCDIR "/lib/") + name).c_str());
+	ostringstream os;
+	os << is.rdbuf();
+	return os.str();
+}
+
+int main(void)
+{
+	const abnf_ruleset& rset = uri::ruleset();
+	ostringstream hs, cs;
+	rset.generate(rset.get("URI-reference"), "urigen", hs, cs);
+	
+	const char* state[] = { "out of date", "up to date" };
+	abnf_test_check("lib/urigen.h, regenerated by make -C lib urigen",
+			state[1], state[hs.str() == source_read("urigen.h")]);
+	abnf_test_check("lib/urigen.cxx, regenerated by make -C lib urigen",
+			state[1], state[cs.str() == source_read("urigen.cxx")]);
+	
+	return abnf_test_status();
+}